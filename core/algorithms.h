@@ -0,0 +1,78 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/algorithms.h — реестр алгоритмов шифрования контейнера
+//
+// Идентификатор из заголовка (AlgorithmId) сопоставляется с названием в
+// интерфейсе, расширением файла и типом развёрнутого ключа. Операции
+// FileProcessor — шаблоны по типу ключа; withCipher выбирает их
+// инстанцирование для алгоритма, и каждое собрано со своими размерами
+// из CipherTraits. Новый алгоритм — строка в Algorithms и ветка в withCipher.
+#ifndef ALGORITHMS_H
+#define ALGORITHMS_H
+
+#include <QString>
+#include "container.h"
+#include "crypto/kuznechik.h"
+#include "crypto/magma.h"
+#include "crypto/traits.h"
+
+struct AlgorithmInfo
+{
+    AlgorithmId id;
+    const char *name;       // в интерфейсе, UTF-8
+    const char *extension;  // зашифрованного файла
+    int blockSize;
+    int keySize;
+};
+
+constexpr AlgorithmInfo Algorithms[] = {
+    { AlgorithmId::Kuznechik, "Кузнечик", ".kuz",
+      CipherTraits<KuznechikKey>::BlockSize, CipherTraits<KuznechikKey>::KeySize },
+    { AlgorithmId::Magma, "Магма", ".mag",
+      CipherTraits<MagmaKey>::BlockSize, CipherTraits<MagmaKey>::KeySize },
+};
+
+// nullptr — алгоритм неизвестен этой сборке
+constexpr const AlgorithmInfo *findAlgorithm(AlgorithmId id)
+{
+    for (const AlgorithmInfo &info : Algorithms) {
+        if (info.id == id)
+            return &info;
+    }
+    return nullptr;
+}
+
+inline const AlgorithmInfo *findAlgorithm(const QString &name)
+{
+    for (const AlgorithmInfo &info : Algorithms) {
+        if (name == QString::fromUtf8(info.name))
+            return &info;
+    }
+    return nullptr;
+}
+
+template<typename Cipher>
+struct CipherTag
+{
+    using Type = Cipher;
+};
+
+// op(CipherTag<ключ алгоритма>()); false — и для неизвестного алгоритма:
+//   withCipher(id, [&](auto tag) { return run<typename decltype(tag)::Type>(); });
+template<typename Op>
+bool withCipher(AlgorithmId id, Op &&op)
+{
+    switch (id) {
+    case AlgorithmId::Kuznechik: return op(CipherTag<KuznechikKey>());
+    case AlgorithmId::Magma:     return op(CipherTag<MagmaKey>());
+    }
+    return false;
+}
+
+#endif // ALGORITHMS_H
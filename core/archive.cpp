@@ -0,0 +1,342 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/archive.cpp
+#include "archive.h"
+#include "dirscanner.h"
+#include "fileprocessor.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QtEndian>
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+const char ArchiveMagic[8] = { 'G', 'O', 'S', 'T', 'A', 'R', 'C', 'H' };
+constexpr int EntryFixed = 2 + 8 + 8 + 4;
+
+void appendNumber(QByteArray &out, quint64 value, int bytes)
+{
+    char buffer[8];
+    qToBigEndian<quint64>(value, buffer);
+    out.append(buffer + 8 - bytes, bytes);
+}
+
+} // namespace
+
+bool ArchiveIndex::fail(const QString &error)
+{
+    m_error = error;
+    return false;
+}
+
+bool ArchiveIndex::collect(const QString &root)
+{
+    m_entries.clear();
+    const QString base = QDir::cleanPath(root);
+    if (!QFileInfo(base).isDir())
+        return fail(QStringLiteral("Не найдена папка: %1").arg(root));
+
+    // Папка уходит в архив и удаляется целиком, поэтому скрытые файлы
+    // тоже берутся. Архив собирается внутри рабочего потока пакета —
+    // обходчик у него однопоточный, без пула на каждый архив
+    QStringList files;
+    DirectoryScanner scanner(1);
+    scanner.setIncludeHidden(true);
+    scanner.scan({ base }, [&](const QString &filePath, qint64) {
+        // Служебные файлы прошлых операций в архив не берутся
+        if (!FileProcessor::isServiceName(filePath))
+            files.append(filePath);
+        return true;
+    });
+    files.sort();
+
+    quint64 offset = 0;
+    for (const QString &filePath : std::as_const(files)) {
+        const QFileInfo info(filePath);
+        ArchiveEntry entry;
+        entry.path = filePath.mid(base.size() + 1);
+        entry.size = quint64(info.size());
+        entry.mtimeMs = info.lastModified().toMSecsSinceEpoch();
+        entry.permissions = quint32(int(info.permissions()));
+        entry.offset = offset;
+        if (entry.path.toUtf8().size() > 0xffff)
+            return fail(QStringLiteral("Слишком длинный путь: %1").arg(filePath));
+        offset += entry.size;
+        m_entries.append(entry);
+    }
+    return true;
+}
+
+quint64 ArchiveIndex::indexSize(const QByteArray &prefix)
+{
+    if (prefix.size() < PrefixSize || memcmp(prefix.constData(), ArchiveMagic, sizeof(ArchiveMagic)) != 0)
+        return 0;
+    const quint64 size = qFromBigEndian<quint64>(prefix.constData() + 8);
+    return size >= HeadSize ? size : 0;
+}
+
+quint64 ArchiveIndex::entrySize(const QString &path)
+{
+    return quint64(EntryFixed + path.toUtf8().size());
+}
+
+QByteArray ArchiveIndex::serialize() const
+{
+    QByteArray body;
+    for (const ArchiveEntry &entry : m_entries) {
+        const QByteArray path = entry.path.toUtf8();
+        appendNumber(body, quint64(path.size()), 2);
+        body.append(path);
+        appendNumber(body, entry.size, 8);
+        appendNumber(body, quint64(entry.mtimeMs), 8);
+        appendNumber(body, entry.permissions, 4);
+    }
+
+    QByteArray out(ArchiveMagic, sizeof(ArchiveMagic));
+    appendNumber(out, HeadSize + quint64(body.size()), 8);
+    appendNumber(out, quint64(m_entries.size()), 4);
+    out.append(body);
+    return out;
+}
+
+bool ArchiveIndex::parse(const QByteArray &data)
+{
+    m_entries.clear();
+    if (indexSize(data) != quint64(data.size()))
+        return fail(QStringLiteral("Повреждено оглавление архива"));
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 count = qFromBigEndian<quint32>(p + PrefixSize);
+    int at = PrefixSize + 4;
+    if (count > quint32((data.size() - at) / EntryFixed))
+        return fail(QStringLiteral("Повреждено оглавление архива"));
+
+    QVector<ArchiveEntry> entries;
+    entries.reserve(int(count));
+    quint64 offset = 0;
+    for (quint32 i = 0; i < count; ++i) {
+        if (data.size() - at < EntryFixed)
+            return fail(QStringLiteral("Повреждено оглавление архива"));
+        const int pathSize = qFromBigEndian<quint16>(p + at);
+        if (data.size() - at - EntryFixed < pathSize)
+            return fail(QStringLiteral("Повреждено оглавление архива"));
+        ArchiveEntry entry;
+        entry.path = QString::fromUtf8(data.constData() + at + 2, pathSize);
+        at += 2 + pathSize;
+        entry.size = qFromBigEndian<quint64>(p + at);
+        entry.mtimeMs = qint64(qFromBigEndian<quint64>(p + at + 8));
+        entry.permissions = qFromBigEndian<quint32>(p + at + 16);
+        at += 20;
+        if (!isSafePath(entry.path) || entry.size > ~offset)
+            return fail(QStringLiteral("Неверный путь в оглавлении архива: %1").arg(entry.path));
+        entry.offset = offset;
+        offset += entry.size;
+        entries.append(entry);
+    }
+    if (at != data.size())
+        return fail(QStringLiteral("Повреждено оглавление архива"));
+    m_entries = entries;
+    return true;
+}
+
+const ArchiveEntry *ArchiveIndex::find(const QString &path) const
+{
+    // Оглавление упорядочено по путям при упаковке
+    const auto it = std::lower_bound(m_entries.begin(), m_entries.end(), path,
+                                     [](const ArchiveEntry &entry, const QString &key) { return entry.path < key; });
+    return it != m_entries.end() && it->path == path ? &*it : nullptr;
+}
+
+quint64 ArchiveIndex::dataSize() const
+{
+    return m_entries.isEmpty() ? 0 : m_entries.last().offset + m_entries.last().size;
+}
+
+quint64 ArchiveIndex::streamSize() const
+{
+    quint64 size = HeadSize + dataSize();
+    for (const ArchiveEntry &entry : m_entries)
+        size += entrySize(entry.path);
+    return size;
+}
+
+bool ArchiveIndex::isSafePath(const QString &path)
+{
+    if (path.isEmpty() || path.startsWith(QLatin1Char('/')) || path.contains(QLatin1Char('\\'))
+        || path.contains(QLatin1Char(':')))
+        return false;
+    for (const QString &part : path.split(QLatin1Char('/'))) {
+        if (part.isEmpty() || part == QLatin1String(".") || part == QLatin1String(".."))
+            return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+ArchiveStream::ArchiveStream(const QString &root, const ArchiveIndex &index)
+    : m_root(QDir::cleanPath(root))
+    , m_index(index)
+    , m_head(index.serialize())
+{
+}
+
+qint64 ArchiveStream::fail(const QString &error)
+{
+    m_error = error;
+    setErrorString(error);
+    m_file.close();
+    return -1;
+}
+
+qint64 ArchiveStream::readData(char *data, qint64 maxSize)
+{
+    qint64 done = 0;
+    if (!m_head.isEmpty()) {
+        done = qMin<qint64>(maxSize, m_head.size());
+        memcpy(data, m_head.constData(), size_t(done));
+        m_head.remove(0, int(done));
+    }
+
+    const QVector<ArchiveEntry> &entries = m_index.entries();
+    while (done < maxSize && m_entry < entries.size()) {
+        if (!m_file.isOpen()) {
+            m_file.setFileName(m_root + QLatin1Char('/') + entries[m_entry].path);
+            if (!m_file.open(QIODevice::ReadOnly))
+                return fail(QStringLiteral("Не удалось открыть файл: %1").arg(m_file.fileName()));
+            m_left = entries[m_entry].size;
+        }
+        if (m_left > 0) {
+            const qint64 n = m_file.read(data + done, qMin<qint64>(maxSize - done, qint64(m_left)));
+            if (n <= 0)
+                return fail(QStringLiteral("Файл изменился во время упаковки: %1").arg(m_file.fileName()));
+            done += n;
+            m_left -= quint64(n);
+        }
+        // Выросший после обхода файл берётся в размере из оглавления
+        if (m_left == 0) {
+            m_file.close();
+            ++m_entry;
+        }
+    }
+    return done;
+}
+
+// ---------------------------------------------------------------------------
+
+ArchiveSink::ArchiveSink(const QString &root)
+    : m_root(QDir::cleanPath(root))
+{
+}
+
+bool ArchiveSink::fail(const QString &error)
+{
+    m_error = error;
+    setErrorString(error);
+    m_file.close();
+    return false;
+}
+
+bool ArchiveSink::closeCurrent()
+{
+    const ArchiveEntry &entry = m_index.entries()[m_entry];
+    m_file.close();
+    if (entry.permissions != 0)
+        m_file.setPermissions(QFileDevice::Permissions(QFlag(int(entry.permissions))));
+    // Время ставится на закрытый файл: запись его больше не сдвинет
+    QFile touched(m_file.fileName());
+    if (touched.open(QIODevice::ReadWrite))
+        touched.setFileTime(QDateTime::fromMSecsSinceEpoch(entry.mtimeMs), QFileDevice::FileModificationTime);
+    return true;
+}
+
+// Следующий файл оглавления; пустые создаются и закрываются сразу
+bool ArchiveSink::openNext()
+{
+    const QVector<ArchiveEntry> &entries = m_index.entries();
+    while (m_left == 0 && m_entry + 1 < entries.size()) {
+        ++m_entry;
+        const QString path = m_root + QLatin1Char('/') + entries[m_entry].path;
+        if (!QDir().mkpath(QFileInfo(path).path()))
+            return fail(QStringLiteral("Не удалось создать папку для %1").arg(path));
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::WriteOnly | QIODevice::NewOnly))
+            return fail(QStringLiteral("Не удалось создать файл: %1").arg(path));
+        m_left = entries[m_entry].size;
+        if (m_left == 0)
+            closeCurrent();
+    }
+    return true;
+}
+
+qint64 ArchiveSink::writeData(const char *data, qint64 size)
+{
+    qint64 done = 0;
+    // Оглавление копится целиком, затем разбирается
+    while (!m_indexRead && done < size) {
+        const quint64 want = m_indexSize ? m_indexSize : quint64(ArchiveIndex::PrefixSize);
+        const qint64 take = qMin<qint64>(size - done, qint64(want) - m_head.size());
+        m_head.append(data + done, int(take));
+        done += take;
+        if (quint64(m_head.size()) < want)
+            break;
+        if (!m_indexSize) {
+            m_indexSize = ArchiveIndex::indexSize(m_head);
+            if (m_indexSize == 0 || m_indexSize > ArchiveIndex::MaxIndexSize) {
+                fail(QStringLiteral("Повреждено оглавление архива"));
+                return -1;
+            }
+            continue;
+        }
+        if (!m_index.parse(m_head)) {
+            fail(m_index.errorString());
+            return -1;
+        }
+        m_head.clear();
+        m_indexRead = true;
+        if (!QDir().mkpath(m_root)) {
+            fail(QStringLiteral("Не удалось создать папку: %1").arg(m_root));
+            return -1;
+        }
+        if (!openNext())
+            return -1;
+    }
+
+    while (done < size) {
+        if (m_left == 0) {
+            fail(QStringLiteral("Лишние данные в архиве"));
+            return -1;
+        }
+        const qint64 n = qMin<qint64>(size - done, qint64(m_left));
+        if (m_file.write(data + done, n) != n) {
+            fail(QStringLiteral("Ошибка записи: %1").arg(m_file.fileName()));
+            return -1;
+        }
+        done += n;
+        m_left -= quint64(n);
+        if (m_left == 0 && (!closeCurrent() || !openNext()))
+            return -1;
+    }
+    return done;
+}
+
+void ArchiveSink::close()
+{
+    m_file.close();
+    QIODevice::close();
+}
+
+bool ArchiveSink::finish()
+{
+    if (!m_indexRead || m_left != 0 || m_entry + 1 < m_index.entries().size())
+        return fail(QStringLiteral("Архив обрезан"));
+    return true;
+}
@@ -0,0 +1,149 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/archive.h — папка целиком в одном контейнере
+//
+// У каждого отдельного контейнера свои соль, синхропосылка, выработка
+// ключа и переименование; на папке из тысяч мелких файлов это дороже
+// самого шифрования. Архив — один обычный контейнер с FlagArchive,
+// открытый текст которого — оглавление и следом содержимое файлов подряд:
+// одна выработка ключа, одна цепочка имитовставок фрагментов.
+//
+//   Открытый текст архива:
+//     8  сигнатура "GOSTARCH"
+//     8  длина оглавления вместе с этими полями, big-endian
+//     4  число файлов, big-endian
+//   Файлы, в порядке данных:
+//     2  длина пути, big-endian; путь в UTF-8 относительно корня, через '/'
+//     8  размер, big-endian
+//     8  время изменения, мс от эпохи, big-endian
+//     4  права доступа (QFileDevice::Permissions), big-endian
+//   Далее содержимое файлов подряд, без разделителей.
+//
+// Архив не сжимается, и записи фрагментов в нём одной длины: один файл
+// извлекается по оглавлению расшифрованием только своих фрагментов.
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+struct ArchiveEntry
+{
+    QString path;           // относительно корня архива
+    quint64 size = 0;
+    qint64 mtimeMs = 0;
+    quint32 permissions = 0;
+    quint64 offset = 0;     // от начала данных; не хранится, считается по размерам
+};
+
+class ArchiveIndex
+{
+public:
+    static constexpr int PrefixSize = 16;
+    // Оглавление держится в памяти целиком: больше — заведомо повреждено
+    static constexpr quint64 MaxIndexSize = quint64(1) << 30;
+
+    // Файлы папки по правилам обхода DirectoryScanner, включая скрытые,
+    // в порядке путей
+    bool collect(const QString &root);
+    // Длина оглавления по первым PrefixSize байтам открытого текста;
+    // 0 — это не архив
+    static quint64 indexSize(const QByteArray &prefix);
+    // Байт оглавления на файл с таким путём и на само оглавление:
+    // открытый текст архива — их сумма плюс размеры файлов
+    static quint64 entrySize(const QString &path);
+    static constexpr quint64 HeadSize = PrefixSize + 4;
+    QByteArray serialize() const;
+    bool parse(const QByteArray &data);
+
+    const QVector<ArchiveEntry> &entries() const { return m_entries; }
+    const ArchiveEntry *find(const QString &path) const;
+    quint64 dataSize() const;
+    // Длина открытого текста архива: оглавление и файлы
+    quint64 streamSize() const;
+    QString errorString() const { return m_error; }
+
+    // Путь из оглавления безопасен для распаковки: относительный,
+    // без «..» и пустых частей
+    static bool isSafePath(const QString &path);
+
+private:
+    bool fail(const QString &error);
+
+    QVector<ArchiveEntry> m_entries;
+    QString m_error;
+};
+
+// Открытый текст архива для шифрования: оглавление, затем файлы по
+// очереди. Файл, ставший короче, чем в оглавлении, — ошибка чтения.
+class ArchiveStream : public QIODevice
+{
+public:
+    ArchiveStream(const QString &root, const ArchiveIndex &index);
+
+    bool isSequential() const override { return true; }
+    bool atEnd() const override { return m_entry >= m_index.entries().size() && m_head.isEmpty(); }
+    // Причина ошибки чтения; пусто, если её не было
+    QString error() const { return m_error; }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    qint64 fail(const QString &error);
+
+    QString m_root;
+    const ArchiveIndex &m_index;
+    QByteArray m_head;      // ещё не отданная часть оглавления
+    int m_entry = 0;
+    quint64 m_left = 0;     // байт текущего файла осталось отдать
+    QFile m_file;
+    QString m_error;
+};
+
+// Распаковка открытого текста архива в каталог по мере расшифрования
+class ArchiveSink : public QIODevice
+{
+public:
+    explicit ArchiveSink(const QString &root);
+
+    // Все файлы оглавления записаны, лишних данных нет
+    bool finish();
+    const ArchiveIndex &index() const { return m_index; }
+    QString error() const { return m_error; }
+
+    bool isSequential() const override { return true; }
+    bool atEnd() const override { return true; }
+    void close() override;
+
+protected:
+    qint64 readData(char *, qint64) override { return -1; }
+    qint64 writeData(const char *data, qint64 size) override;
+
+private:
+    bool fail(const QString &error);
+    bool openNext();
+    bool closeCurrent();
+
+    QString m_root;
+    QByteArray m_head;
+    quint64 m_indexSize = 0;
+    bool m_indexRead = false;
+    ArchiveIndex m_index;
+    int m_entry = -1;
+    quint64 m_left = 0;
+    QFile m_file;
+    QString m_error;
+};
+
+#endif // ARCHIVE_H
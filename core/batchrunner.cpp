@@ -0,0 +1,326 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/batchrunner.cpp
+#include "batchrunner.h"
+#include "metrics.h"
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QThread>
+#include <vector>
+
+BatchRunner::BatchRunner(QObject *parent)
+    : QObject(parent)
+{
+}
+
+BatchRunner::~BatchRunner()
+{
+    cancel();
+    wait();
+}
+
+bool BatchRunner::start(const QStringList &paths, const BatchOptions &options)
+{
+    wait();
+    if (options.password.isEmpty())
+        return false;
+
+    QStringList files;
+    QStringList dirs;
+    // Явно указанные файлы измеряются здесь, файлы папок — при обходе
+    for (const QString &path : paths) {
+        const QFileInfo info(path);
+        if (info.isDir())
+            dirs.append(QDir::cleanPath(path));
+        else if (info.isFile())
+            files.append(path);
+    }
+
+    m_options = options;
+    m_queue.clear();
+    m_closed = false;
+    m_cancelled.store(false, std::memory_order_relaxed);
+    m_scanFinished.store(false, std::memory_order_relaxed);
+    m_queued.store(0, std::memory_order_relaxed);
+    m_done.store(0, std::memory_order_relaxed);
+    m_failed.store(0, std::memory_order_relaxed);
+    m_skipped.store(0, std::memory_order_relaxed);
+    m_bytesQueued.store(0, std::memory_order_relaxed);
+    m_bytesDone.store(0, std::memory_order_relaxed);
+    m_workerCount = options.workers > 0 ? options.workers : qMax(1, QThread::idealThreadCount());
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.clear();
+    }
+    m_running.store(true, std::memory_order_release);
+
+    m_driver = std::thread(&BatchRunner::drive, this, files, dirs);
+    return true;
+}
+
+void BatchRunner::cancel()
+{
+    {
+        // Под мьютексом: иначе ожидающий поток может проверить флаг
+        // до записи и уснуть уже после оповещения
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancelled.store(true, std::memory_order_relaxed);
+        if (m_scanner)
+            m_scanner->cancel();
+    }
+    m_notEmpty.notify_all();
+    m_notFull.notify_all();
+}
+
+void BatchRunner::wait()
+{
+    if (m_driver.joinable())
+        m_driver.join();
+}
+
+void BatchRunner::drive(const QStringList &files, const QStringList &dirs)
+{
+    GroupCommit commit([this](const GroupCommit::Entry &entry, const QString &error) {
+        committed(entry, error);
+    }, m_options.commitBatchSize, m_options.commitDelayMs);
+    m_commit = &commit;
+
+    // Описи читаются до обхода: по ним он решает, что пропустить
+    m_manifests.clear();
+    const bool archive = m_options.encrypt && m_options.archive;
+    if (m_options.encrypt && m_options.incremental && !archive) {
+        for (const QString &dir : dirs) {
+            auto manifest = std::make_unique<Manifest>(dir);
+            if (!manifest->load(m_options.password, m_options.kdfIterations))
+                qDebug() << manifest->errorString() << "— папка обрабатывается целиком";
+            m_manifests.push_back(std::move(manifest));
+        }
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(m_workerCount);
+    for (int i = 0; i < m_workerCount; ++i)
+        workers.emplace_back(&BatchRunner::work, this, i);
+
+    for (const QString &file : files) {
+        if (!enqueue(file, QFileInfo(file).size()))
+            break;
+    }
+
+    if (archive) {
+        // Папка — одно задание без отдельного обхода: размер её открытого
+        // текста encryptDirectory добавит к bytesQueued, собрав оглавление
+        for (const QString &dir : dirs) {
+            if (!enqueue(dir, 0))
+                break;
+        }
+    } else if (!dirs.isEmpty() && !m_cancelled.load(std::memory_order_relaxed)) {
+        DirectoryScanner scanner(m_options.scanThreads);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_scanner = &scanner;
+        }
+        scanner.scan(dirs, [this](const QString &filePath, qint64 size) {
+            return !accepts(filePath) || skipUnchanged(filePath) || enqueue(filePath, size);
+        });
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_scanner = nullptr;
+    }
+    m_scanFinished.store(true, std::memory_order_release);
+
+    closeQueue();
+    for (std::thread &worker : workers)
+        worker.join();
+    DIPLOM_GAUGE(QueueDepth, 0);
+    // Последняя неполная пачка
+    commit.finish();
+    m_commit = nullptr;
+
+    // Без отмены обход видел всё дерево: удалённые файлы из описи уходят
+    const bool complete = !m_cancelled.load(std::memory_order_relaxed);
+    for (const auto &manifest : m_manifests) {
+        if (!manifest->save(m_options.password, m_options.kdfIterations, complete))
+            qDebug() << manifest->errorString();
+    }
+    m_manifests.clear();
+
+    m_running.store(false, std::memory_order_release);
+    emit finished();
+}
+
+void BatchRunner::work(int index)
+{
+    Trace::setThreadName(QStringLiteral("worker %1").arg(index));
+
+    FileProcessor processor(m_options.password);
+    processor.setKdfIterations(m_options.kdfIterations);
+    processor.setChunkSize(m_options.chunkSize);
+    processor.setCompression(m_options.compression);
+    processor.setMac(m_options.mac);
+    processor.setProgressCounter(&m_bytesDone);
+    processor.setQueuedCounter(&m_bytesQueued);
+    processor.setGroupCommit(m_commit);
+    const bool archive = m_options.encrypt && m_options.archive;
+    const bool incremental = m_options.encrypt && m_options.incremental && !archive;
+    processor.setKeepSource(incremental);
+    processor.setDelta(incremental && m_options.delta);
+
+    Job job;
+    while (dequeue(&job)) {
+        // Контейнер «на месте» decryptFile узнаёт сам
+        QString result;
+        quint64 size = quint64(qMax<qint64>(0, job.size));
+        if (!m_options.encrypt) {
+            result = processor.decryptFile(job.path);
+        } else if (archive && QFileInfo(job.path).isDir()) {
+            result = processor.encryptDirectory(job.path, m_options.algorithm);
+            size = processor.archiveSize();
+        } else if (incremental && m_options.delta) {
+            result = processor.updateFile(job.path, m_options.algorithm);
+        } else if (m_options.inPlace && !incremental) {
+            result = processor.encryptInPlace(job.path, m_options.algorithm);
+        } else {
+            result = processor.encryptFile(job.path, m_options.algorithm);
+        }
+        // Недочитанный остаток (ошибка, файл изменился после обхода)
+        // засчитывается целиком: итог сходится с bytesQueued
+        if (processor.bytesRead() < size)
+            m_bytesDone.fetch_add(size - processor.bytesRead(), std::memory_order_relaxed);
+
+        // Удачный файл из очереди засчитает committed() после фиксации
+        // его пачки; работа «на месте», обновление и архив фиксируются сразу
+        if (result.isEmpty())
+            committed({ QString(), QString(), job.path }, processor.errorString());
+        else if (!processor.resultQueued())
+            committed({ QString(), result, job.path }, QString());
+    }
+}
+
+void BatchRunner::committed(const GroupCommit::Entry &entry, const QString &error)
+{
+    BatchResult item;
+    item.source = entry.source;
+    if (error.isEmpty()) {
+        item.result = entry.target;
+        m_done.fetch_add(1, std::memory_order_relaxed);
+        if (Manifest *manifest = manifestFor(entry.source))
+            manifest->commit(entry.source);
+    } else {
+        item.error = error;
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    m_results.append(std::move(item));
+}
+
+QVector<BatchResult> BatchRunner::takeResults()
+{
+    QVector<BatchResult> results;
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    results.swap(m_results);
+    return results;
+}
+
+bool BatchRunner::accepts(const QString &filePath) const
+{
+    // Результаты соседних потоков появляются в ещё не обойдённых каталогах:
+    // без этого фильтра .kuz мог бы зашифроваться повторно, а временный
+    // файл ещё не зафиксированной пачки или журнал — обработаться как обычный
+    return FileProcessor::isEncryptedName(filePath) != m_options.encrypt
+        && !FileProcessor::isServiceName(filePath);
+}
+
+bool BatchRunner::skipUnchanged(const QString &filePath)
+{
+    Manifest *manifest = manifestFor(filePath);
+    if (!manifest)
+        return false;
+
+    // Пропуск — только если и результат на месте: его могли удалить
+    // или сменить алгоритм
+    Manifest::Entry current;
+    if (manifest->unchanged(filePath, m_options.manifestDigest, &current)
+        && QFile::exists(filePath + FileProcessor::extensionFor(m_options.algorithm))) {
+        m_skipped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    manifest->stage(filePath, current);
+    return false;
+}
+
+Manifest *BatchRunner::manifestFor(const QString &filePath) const
+{
+    // Вложенные корни: файл принадлежит самому глубокому
+    Manifest *best = nullptr;
+    for (const auto &manifest : m_manifests) {
+        if (manifest->covers(filePath) && (!best || manifest->root().size() > best->root().size()))
+            best = manifest.get();
+    }
+    return best;
+}
+
+BatchProgress BatchRunner::progress() const
+{
+    BatchProgress progress;
+    progress.scanFinished = isScanFinished();
+    progress.filesQueued = filesQueued();
+    progress.filesDone = filesDone();
+    progress.filesFailed = filesFailed();
+    progress.bytesQueued = bytesQueued();
+    progress.bytesDone = bytesDone();
+    progress.workers = m_workerCount;
+    return progress;
+}
+
+bool BatchRunner::enqueue(const QString &filePath, qint64 size)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this] {
+        return m_cancelled.load(std::memory_order_relaxed)
+            || int(m_queue.size()) < m_options.queueCapacity;
+    });
+    if (m_cancelled.load(std::memory_order_relaxed))
+        return false;
+
+    m_queue.push_back({ filePath, size });
+    m_queued.fetch_add(1, std::memory_order_relaxed);
+    m_bytesQueued.fetch_add(quint64(qMax<qint64>(0, size)), std::memory_order_relaxed);
+    DIPLOM_GAUGE(QueueDepth, qint64(m_queue.size()));
+    lock.unlock();
+    m_notEmpty.notify_one();
+    return true;
+}
+
+bool BatchRunner::dequeue(Job *job)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notEmpty.wait(lock, [this] {
+        return m_cancelled.load(std::memory_order_relaxed) || m_closed || !m_queue.empty();
+    });
+    if (m_cancelled.load(std::memory_order_relaxed) || m_queue.empty())
+        return false;
+
+    *job = std::move(m_queue.front());
+    m_queue.pop_front();
+    DIPLOM_GAUGE(QueueDepth, qint64(m_queue.size()));
+    lock.unlock();
+    m_notFull.notify_one();
+    return true;
+}
+
+void BatchRunner::closeQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closed = true;
+    }
+    m_notEmpty.notify_all();
+}
@@ -0,0 +1,161 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/batchrunner.h — пакетная обработка файлов и каталогов в фоне
+//
+// Каталоги обходит DirectoryScanner, найденные файлы сразу попадают
+// в ограниченную очередь, из которой их забирают потоки шифрования:
+// дерево обходится один раз, и обход идёт одновременно с обработкой.
+// Полная очередь притормаживает обход, а не раздувает память.
+//
+// Результаты фиксируются пачками (GroupCommit): файл засчитывается
+// готовым, когда он надёжно записан и исходный удалён.
+//
+// В режиме incremental исходные файлы остаются на месте, а у каждой папки
+// ведётся опись (core/manifest.h): повторный прогон пропускает файлы,
+// которые не менялись с прошлого, по одному stat() на файл. С delta
+// изменённый файл не шифруется заново, а обновляет свой контейнер
+// (FileProcessor::updateFile): переписываются только изменённые фрагменты.
+//
+// В режиме archive папки при шифровании не обходятся по файлам: каждая
+// целиком упаковывается в один контейнер (FileProcessor::encryptDirectory).
+// Архив расшифровывается как обычный файл — в папку.
+//
+// Ход работы публикуется атомарными счётчиками, а итоги по файлам
+// копятся в буфере: интерфейс опрашивает их по таймеру несколько раз
+// в секунду, и число событий не растёт с числом файлов. Сигнал finished()
+// испускается из рабочего потока; в поток GUI он приходит через очередь
+// событий (Qt::AutoConnection).
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "dirscanner.h"
+#include "fileprocessor.h"
+#include "groupcommit.h"
+#include "manifest.h"
+#include "progress.h"
+
+// Итог обработки одного файла
+struct BatchResult
+{
+    QString source;
+    QString result;     // пуст при ошибке
+    QString error;      // пуст при успехе
+};
+
+struct BatchOptions
+{
+    bool encrypt = true;
+    AlgorithmId algorithm = AlgorithmId::Kuznechik;
+    QString password;           // читается в потоке GUI до запуска
+    int workers = 0;            // потоков шифрования; 0 — по числу ядер
+    int scanThreads = 0;        // потоков обхода; 0 — по числу ядер
+    int queueCapacity = 1024;   // файлов в очереди между обходом и шифрованием
+    int kdfIterations = FileProcessor::DefaultKdfIterations;
+    quint32 chunkSize = ContainerHeader::DefaultChunkSize;
+    int commitBatchSize = GroupCommit::DefaultBatchSize;  // файлов в пачке фиксации
+    int commitDelayMs = GroupCommit::DefaultDelayMs;      // наибольшая задержка пачки
+    bool inPlace = false;       // шифровать в том же файле, без копии на диске
+    CompressionId compression = CompressionId::None;  // сжатие фрагментов перед шифрованием
+    MacId mac = MacId::HmacStreebog256;     // MGM — за один проход, CMAC — на шифре контейнера
+    bool incremental = false;   // шифрование с описью: исходные остаются, неизменённые пропускаются
+    bool manifestDigest = false;    // разошедшийся stat перепроверять дайджестом содержимого
+    bool delta = false;         // с incremental: изменённые файлы обновлять пофрагментно
+    bool archive = false;       // при шифровании каждая папка — один архив (core/archive.h)
+};
+
+class BatchRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BatchRunner(QObject *parent = nullptr);
+    ~BatchRunner() override;
+
+    // Пути — файлы и каталоги. Файлы из каталогов отбираются по режиму:
+    // при шифровании пропускаются .kuz / .mag, при расшифровании — всё
+    // остальное. Явно указанные файлы обрабатываются как есть.
+    bool start(const QStringList &paths, const BatchOptions &options);
+    // Не брать новые файлы; начатые дорабатываются
+    void cancel();
+    // Дождаться завершения из любого потока, кроме рабочих
+    void wait();
+
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+    bool isScanFinished() const { return m_scanFinished.load(std::memory_order_acquire); }
+    quint64 filesQueued() const { return m_queued.load(std::memory_order_relaxed); }
+    quint64 filesDone() const { return m_done.load(std::memory_order_relaxed); }
+    quint64 filesFailed() const { return m_failed.load(std::memory_order_relaxed); }
+    // Пропущено по описи как неизменённые
+    quint64 filesSkipped() const { return m_skipped.load(std::memory_order_relaxed); }
+    quint64 bytesQueued() const { return m_bytesQueued.load(std::memory_order_relaxed); }
+    // Байт исходных файлов, прочитанных к этому моменту, включая начатые
+    quint64 bytesDone() const { return m_bytesDone.load(std::memory_order_relaxed); }
+    BatchProgress progress() const;
+
+    // Забрать накопленные итоги; вызывается из любого потока
+    QVector<BatchResult> takeResults();
+
+signals:
+    void finished();
+
+private:
+    void drive(const QStringList &files, const QStringList &dirs);
+    void work(int index);
+    bool accepts(const QString &filePath) const;
+    bool skipUnchanged(const QString &filePath);
+    Manifest *manifestFor(const QString &filePath) const;
+    void committed(const GroupCommit::Entry &entry, const QString &error);
+    struct Job {
+        QString path;
+        qint64 size;
+    };
+
+    bool enqueue(const QString &filePath, qint64 size);
+    bool dequeue(Job *job);
+    void closeQueue();
+
+    BatchOptions m_options;
+    std::thread m_driver;
+    DirectoryScanner *m_scanner = nullptr;
+    GroupCommit *m_commit = nullptr;    // живёт, пока работает drive()
+    // Описи корневых папок; состав не меняется, пока идёт обход
+    std::vector<std::unique_ptr<Manifest>> m_manifests;
+
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<Job> m_queue;
+    int m_workerCount = 1;
+    bool m_closed = false;
+
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<bool> m_scanFinished{false};
+    std::atomic<quint64> m_queued{0};
+    std::atomic<quint64> m_done{0};
+    std::atomic<quint64> m_failed{0};
+    std::atomic<quint64> m_skipped{0};
+    std::atomic<quint64> m_bytesQueued{0};
+    std::atomic<quint64> m_bytesDone{0};
+
+    std::mutex m_resultsMutex;
+    QVector<BatchResult> m_results;
+};
+
+#endif // BATCHRUNNER_H
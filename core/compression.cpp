@@ -0,0 +1,133 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/compression.cpp
+#include "compression.h"
+#include <QtEndian>
+
+#if DIPLOM_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+// Сжатие, сберегающее меньше этой доли, не окупает распаковку
+constexpr int MinSavingPercent = 10;
+
+bool worthIt(int packed, int size)
+{
+    return qint64(packed) * 100 < qint64(size) * (100 - MinSavingPercent);
+}
+
+} // namespace
+
+bool Compression::isAvailable(CompressionId codec)
+{
+    switch (codec) {
+    case CompressionId::None:
+    case CompressionId::Deflate:
+        return true;
+    case CompressionId::Zstd:
+        return DIPLOM_ZSTD != 0;
+    }
+    return false;
+}
+
+QString Compression::name(CompressionId codec)
+{
+    switch (codec) {
+    case CompressionId::None:    return QStringLiteral("none");
+    case CompressionId::Deflate: return QStringLiteral("deflate");
+    case CompressionId::Zstd:    return QStringLiteral("zstd");
+    }
+    return QString();
+}
+
+bool Compression::fromName(const QString &name, CompressionId *codec)
+{
+    const QString clean = name.trimmed().toLower();
+    for (CompressionId id : { CompressionId::None, CompressionId::Deflate, CompressionId::Zstd }) {
+        if (clean == Compression::name(id) || (id == CompressionId::None && clean.isEmpty())) {
+            *codec = id;
+            return true;
+        }
+    }
+    return false;
+}
+
+QByteArray Compression::compressAll(CompressionId codec, const QByteArray &data)
+{
+    switch (codec) {
+    case CompressionId::None:
+        break;
+    case CompressionId::Deflate:
+        // Первые 4 байта qCompress — длина исходных данных, big-endian
+        return qCompress(data, 1);
+    case CompressionId::Zstd:
+#if DIPLOM_ZSTD
+    {
+        QByteArray out(int(ZSTD_compressBound(size_t(data.size()))), 0);
+        const size_t n = ZSTD_compress(out.data(), size_t(out.size()), data.constData(), size_t(data.size()), 1);
+        if (ZSTD_isError(n))
+            return QByteArray();
+        out.resize(int(n));
+        return out;
+    }
+#endif
+        break;
+    }
+    return QByteArray();
+}
+
+QByteArray Compression::compress(CompressionId codec, const QByteArray &data)
+{
+    if (codec == CompressionId::None || data.isEmpty())
+        return QByteArray();
+
+    // Сначала проба: несжимаемый фрагмент отсеивается за долю его цены
+    if (data.size() >= 4 * SampleSize) {
+        const QByteArray sample = data.mid((data.size() - SampleSize) / 2, SampleSize);
+        const QByteArray packed = compressAll(codec, sample);
+        if (packed.isEmpty() || !worthIt(packed.size(), sample.size()))
+            return QByteArray();
+    }
+
+    QByteArray packed = compressAll(codec, data);
+    if (packed.isEmpty() || !worthIt(packed.size(), data.size()))
+        return QByteArray();
+    return packed;
+}
+
+bool Compression::decompress(CompressionId codec, const QByteArray &data, int maxSize, QByteArray &out)
+{
+    switch (codec) {
+    case CompressionId::None:
+        break;
+    case CompressionId::Deflate:
+        // Заявленная длина проверяется до того, как qUncompress под неё выделит память
+        if (data.size() < 4 || qFromBigEndian<quint32>(data.constData()) > quint32(maxSize))
+            return false;
+        // Длина в начале — лишь подсказка: если поток длиннее, qUncompress
+        // дорастит буфер сверх неё, поэтому итог проверяется ещё раз
+        out = qUncompress(data);
+        return !out.isEmpty() && out.size() <= maxSize;
+    case CompressionId::Zstd:
+#if DIPLOM_ZSTD
+    {
+        const unsigned long long size = ZSTD_getFrameContentSize(data.constData(), size_t(data.size()));
+        if (size == ZSTD_CONTENTSIZE_ERROR || size == ZSTD_CONTENTSIZE_UNKNOWN || size > quint64(maxSize))
+            return false;
+        out.resize(int(size));
+        const size_t n = ZSTD_decompress(out.data(), size_t(out.size()), data.constData(), size_t(data.size()));
+        return !ZSTD_isError(n) && n == size;
+    }
+#endif
+        break;
+    }
+    return false;
+}
@@ -0,0 +1,45 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/compression.h — сжатие фрагментов перед шифрованием
+//
+// Кодек выбирается на файл и записывается в заголовок контейнера; каждый
+// фрагмент сжимается отдельно и хранится сжатым, только если это выгодно.
+// Несжимаемые данные (архивы, видео, уже зашифрованное) распознаются по
+// пробе из середины фрагмента: на них не тратится полное сжатие.
+//
+//   Deflate — zlib из QtCore (qCompress, уровень 1), есть всегда.
+//   Zstd    — libzstd, уровень 1; только в сборке с -DDIPLOM_ZSTD=ON.
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <QByteArray>
+#include <QString>
+#include "container.h"
+
+class Compression
+{
+public:
+    // Проба: столько байт из середины фрагмента сжимается первым
+    static constexpr int SampleSize = 16 * 1024;
+
+    static bool isAvailable(CompressionId codec);
+    static QString name(CompressionId codec);
+    // "none" / "deflate" / "zstd" из настроек → идентификатор
+    static bool fromName(const QString &name, CompressionId *codec);
+
+    // Сжатые данные; пустой массив — хранить фрагмент как есть
+    static QByteArray compress(CompressionId codec, const QByteArray &data);
+    // Распаковка не длиннее maxSize; false — данные повреждены
+    static bool decompress(CompressionId codec, const QByteArray &data, int maxSize, QByteArray &out);
+
+private:
+    static QByteArray compressAll(CompressionId codec, const QByteArray &data);
+};
+
+#endif // COMPRESSION_H
@@ -0,0 +1,366 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/container.cpp
+#include "container.h"
+#include "algorithms.h"
+#include <QIODevice>
+#include <QtEndian>
+
+static const char Magic[4] = { 'G', 'O', 'S', 'T' };
+static const quint32 LastChunkFlag = 0x80000000u;
+static const quint32 HoleChunkFlag = 0x40000000u;
+static const quint32 CompressedChunkFlag = 0x20000000u;
+static const quint32 ChunkSizeMask = 0x1fffffffu;
+static const quint8 CompressionExtension = 1;
+static const char TrailerMagic[8] = { 'G', 'O', 'S', 'T', 'T', 'A', 'I', 'L' };
+
+int algorithmBlockSize(AlgorithmId algorithm)
+{
+    const AlgorithmInfo *info = findAlgorithm(algorithm);
+    return info ? info->blockSize : 0;
+}
+
+bool macFromName(const QString &name, MacId *mac)
+{
+    const QString clean = name.trimmed().toLower();
+    if (clean.isEmpty() || clean == QLatin1String("hmac"))
+        *mac = MacId::HmacStreebog256;
+    else if (clean == QLatin1String("mgm"))
+        *mac = MacId::Mgm;
+    else if (clean == QLatin1String("cmac"))
+        *mac = MacId::Cmac;
+    else
+        return false;
+    return true;
+}
+
+QByteArray ContainerHeader::serialize() const
+{
+    QByteArray extensions;
+    if (compression != CompressionId::None) {
+        extensions.append(char(CompressionExtension));
+        extensions.append(char(1));
+        extensions.append(char(compression));
+    }
+
+    QByteArray out(FixedSize, 0);
+    uchar *p = reinterpret_cast<uchar *>(out.data());
+    memcpy(p, Magic, 4);
+    p[4] = Version;
+    p[5] = static_cast<quint8>(algorithm);
+    p[6] = static_cast<quint8>(mac);
+    p[7] = flags;
+    qToBigEndian<quint32>(chunkSize, p + 8);
+    qToBigEndian<quint16>(static_cast<quint16>(extensions.size()), p + 12);
+    memcpy(p + 14, salt.constData(), SaltSize);
+    out.append(iv);
+    out.append(extensions);
+    return out;
+}
+
+bool ContainerHeader::parse(const QByteArray &data, ContainerHeader &out, int *consumed)
+{
+    if (data.size() < FixedSize)
+        return false;
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    if (memcmp(p, Magic, 4) != 0 || p[4] != Version)
+        return false;
+
+    ContainerHeader h;
+    h.algorithm = static_cast<AlgorithmId>(p[5]);
+    h.mac = static_cast<MacId>(p[6]);
+    h.flags = p[7];
+    h.chunkSize = qFromBigEndian<quint32>(p + 8);
+    const int extLength = qFromBigEndian<quint16>(p + 12);
+
+    const int ivSize = algorithmBlockSize(h.algorithm);
+    if (ivSize == 0 || h.mac < MacId::HmacStreebog256 || h.mac > MacId::Cmac
+        || (h.flags & ~(FlagInPlace | FlagSparse | FlagDelta | FlagArchive)) != 0)
+        return false;
+    // Синхропосылки MGM не рассчитаны на перезапись фрагментов; хвост
+    // «на месте» — только с HMAC
+    if ((h.mac == MacId::Mgm && (h.flags & FlagDelta))
+        || (h.mac != MacId::HmacStreebog256 && (h.flags & FlagInPlace)))
+        return false;
+    // Обновляемый контейнер и архив держат записи по местам: без дыр
+    // и «на месте»; вместе они не бывают
+    if ((h.flags & (FlagDelta | FlagArchive)) && (h.flags & (FlagInPlace | FlagSparse)))
+        return false;
+    if ((h.flags & FlagDelta) && (h.flags & FlagArchive))
+        return false;
+    // Размер фрагмента — степень двойки в допустимых пределах, кратная блоку
+    if (h.chunkSize < MinChunkSize || h.chunkSize > MaxChunkSize
+        || (h.chunkSize & (h.chunkSize - 1)) != 0)
+        return false;
+
+    const int total = FixedSize + ivSize + extLength;
+    if (data.size() < total)
+        return false;
+
+    h.salt = data.mid(14, SaltSize);
+    h.iv = data.mid(FixedSize, ivSize);
+
+    // Расширения: каждое не больше одного раза, все известны
+    const uchar *ext = p + FixedSize + ivSize;
+    bool seen[256] = {};
+    for (int at = 0; at < extLength;) {
+        if (extLength - at < 2 || extLength - at - 2 < ext[at + 1] || seen[ext[at]])
+            return false;
+        const quint8 type = ext[at];
+        const int length = ext[at + 1];
+        const uchar *value = ext + at + 2;
+        seen[type] = true;
+        if (type == CompressionExtension) {
+            if (length != 1 || value[0] == quint8(CompressionId::None) || value[0] > quint8(CompressionId::Zstd))
+                return false;
+            h.compression = static_cast<CompressionId>(value[0]);
+        } else {
+            return false;
+        }
+        at += 2 + length;
+    }
+    // …и без сжатия, меняющего длину записей
+    if ((h.flags & (FlagDelta | FlagArchive)) && h.compression != CompressionId::None)
+        return false;
+
+    out = h;
+    if (consumed)
+        *consumed = total;
+    return true;
+}
+
+quint32 chunkInfo(bool last, int size, bool hole, bool compressed)
+{
+    return (last ? LastChunkFlag : 0u) | (hole ? HoleChunkFlag : 0u) | (compressed ? CompressedChunkFlag : 0u)
+         | static_cast<quint32>(size);
+}
+
+quint32 ContainerChunk::info() const
+{
+    return chunkInfo(last, isHole() ? int(holeSize) : data.size(), isHole(), compressed);
+}
+
+QByteArray ContainerChunk::deltaFields() const
+{
+    if (fingerprint.isEmpty())
+        return QByteArray();
+    QByteArray fields(8, 0);
+    qToBigEndian<quint64>(generation, fields.data());
+    fields.append(fingerprint);
+    return fields;
+}
+
+QByteArray chunkMacInput(const QByteArray &headerDigest, quint64 index, quint32 info)
+{
+    QByteArray prefix = headerDigest;
+    prefix.resize(headerDigest.size() + 12);
+    uchar *p = reinterpret_cast<uchar *>(prefix.data()) + headerDigest.size();
+    qToBigEndian<quint64>(index, p);
+    qToBigEndian<quint32>(info, p + 8);
+    return prefix;
+}
+
+QByteArray InPlaceTrailer::serialize() const
+{
+    QByteArray out = headerBytes;
+    out.append(tags);
+    QByteArray footer(FooterSize, 0);
+    uchar *p = reinterpret_cast<uchar *>(footer.data());
+    qToBigEndian<quint64>(dataSize, p);
+    qToBigEndian<quint32>(static_cast<quint32>(out.size() + FooterSize), p + 8);
+    memcpy(p + 12, TrailerMagic, sizeof(TrailerMagic));
+    out.append(footer);
+    return out;
+}
+
+bool InPlaceTrailer::read(QIODevice *device, InPlaceTrailer &out, QString *error)
+{
+    auto fail = [error](const QString &message) {
+        if (error)
+            *error = message;
+        return false;
+    };
+
+    const qint64 fileSize = device->size();
+    if (fileSize < FooterSize || !device->seek(fileSize - FooterSize))
+        return fail(QString());
+    const QByteArray footer = device->read(FooterSize);
+    if (footer.size() != FooterSize || memcmp(footer.constData() + 12, TrailerMagic, sizeof(TrailerMagic)) != 0)
+        return fail(QString());
+
+    // Дальше — точно контейнер «на месте»: все поля сверяются друг с другом
+    const uchar *p = reinterpret_cast<const uchar *>(footer.constData());
+    const quint64 dataSize = qFromBigEndian<quint64>(p);
+    const quint32 length = qFromBigEndian<quint32>(p + 8);
+    if (length < quint32(FooterSize + ContainerHeader::FixedSize) || quint64(fileSize) < length
+        || dataSize != quint64(fileSize) - length)
+        return fail(QStringLiteral("Повреждён хвост контейнера"));
+
+    if (!device->seek(qint64(dataSize)))
+        return fail(QStringLiteral("Повреждён хвост контейнера"));
+    const QByteArray tail = device->read(length - FooterSize);
+    InPlaceTrailer t;
+    int consumed = 0;
+    if (tail.size() != int(length - FooterSize) || !ContainerHeader::parse(tail, t.header, &consumed)
+        || t.header.flags != ContainerHeader::FlagInPlace || t.header.compression != CompressionId::None)
+        return fail(QStringLiteral("Неверный заголовок контейнера"));
+
+    t.dataSize = dataSize;
+    if (quint64(tail.size() - consumed) != t.chunkCount() * quint64(t.header.tagSize()))
+        return fail(QStringLiteral("Повреждён хвост контейнера"));
+    t.headerBytes = tail.left(consumed);
+    t.tags = tail.mid(consumed);
+    out = t;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+ContainerReader::ContainerReader(QIODevice *device)
+    : m_device(device)
+{
+}
+
+bool ContainerReader::fail(const QString &error)
+{
+    m_error = error;
+    m_finished = true;
+    return false;
+}
+
+bool ContainerReader::readHeader()
+{
+    // Сначала фиксированная часть — из неё известны длины остального
+    QByteArray data = m_device->read(ContainerHeader::FixedSize);
+    if (data.size() < ContainerHeader::FixedSize)
+        return fail(QStringLiteral("Файл слишком короткий"));
+
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const int ivSize = algorithmBlockSize(static_cast<AlgorithmId>(p[5]));
+    const int extLength = qFromBigEndian<quint16>(p + 12);
+    data.append(m_device->read(ivSize + extLength));
+
+    int consumed = 0;
+    if (!ContainerHeader::parse(data, m_header, &consumed) || consumed != data.size())
+        return fail(QStringLiteral("Неверный заголовок контейнера"));
+    // Заголовок «на месте» бывает только в хвосте файла
+    if (m_header.flags & ContainerHeader::FlagInPlace)
+        return fail(QStringLiteral("Неверный заголовок контейнера"));
+
+    m_headerBytes = data;
+    m_headerRead = true;
+    return true;
+}
+
+bool ContainerReader::seekChunk(quint64 index)
+{
+    if (!m_headerRead || !m_header.hasFixedRecords())
+        return fail(QStringLiteral("Контейнер не допускает произвольного доступа"));
+    if (!m_device->seek(m_header.chunkOffset(m_headerBytes.size(), index)))
+        return fail(QStringLiteral("Контейнер обрезан во фрагменте %1").arg(index));
+    m_nextIndex = index;
+    m_finished = false;
+    m_error.clear();
+    return true;
+}
+
+bool ContainerReader::readChunk(ContainerChunk &chunk, bool withData)
+{
+    if (!m_headerRead || m_finished)
+        return false;
+
+    const QByteArray infoBytes = m_device->read(4);
+    if (infoBytes.size() != 4)
+        return fail(QStringLiteral("Контейнер обрезан: нет последнего фрагмента"));
+
+    const quint32 info = qFromBigEndian<quint32>(infoBytes.constData());
+    const bool last = (info & LastChunkFlag) != 0;
+    const bool hole = (info & HoleChunkFlag) != 0;
+    const bool compressed = (info & CompressedChunkFlag) != 0;
+    const quint32 size = info & ChunkSizeMask;
+
+    // Полный фрагмент не может быть последним, неполный — промежуточным.
+    // Сжатый проверяется так после распаковки, а здесь он только короче полного
+    if (compressed ? (size == 0 || size >= m_header.chunkSize || hole
+                      || m_header.compression == CompressionId::None)
+                   : (size > m_header.chunkSize || last != (size < m_header.chunkSize)))
+        return fail(QStringLiteral("Неверная длина фрагмента %1").arg(m_nextIndex));
+    // Дыры — только в разреженном контейнере и только непустые
+    if (hole && (!(m_header.flags & ContainerHeader::FlagSparse) || size == 0))
+        return fail(QStringLiteral("Неверный фрагмент-дыра %1").arg(m_nextIndex));
+
+    chunk.index = m_nextIndex;
+    chunk.last = last;
+    chunk.holeSize = hole ? size : 0;
+    chunk.compressed = compressed;
+    chunk.generation = 0;
+    chunk.fingerprint.clear();
+    if (m_header.isDelta()) {
+        const QByteArray fields = m_device->read(ContainerHeader::DeltaFieldsSize);
+        if (fields.size() != ContainerHeader::DeltaFieldsSize)
+            return fail(QStringLiteral("Контейнер обрезан во фрагменте %1").arg(m_nextIndex));
+        chunk.generation = qFromBigEndian<quint64>(fields.constData());
+        chunk.fingerprint = fields.mid(8);
+    }
+    if (withData) {
+        chunk.data = m_device->read(hole ? 0 : size);
+        chunk.tag = m_device->read(m_header.tagSize());
+        if (chunk.data.size() != static_cast<int>(hole ? 0 : size) || chunk.tag.size() != m_header.tagSize())
+            return fail(QStringLiteral("Контейнер обрезан во фрагменте %1").arg(m_nextIndex));
+    } else {
+        const qint64 next = m_device->pos() + (hole ? 0 : size) + m_header.tagSize();
+        chunk.data.clear();
+        chunk.tag.clear();
+        if (next > m_device->size() || !m_device->seek(next))
+            return fail(QStringLiteral("Контейнер обрезан во фрагменте %1").arg(m_nextIndex));
+    }
+
+    if (last) {
+        m_finished = true;
+        if (!m_device->atEnd())
+            return fail(QStringLiteral("Лишние данные после последнего фрагмента"));
+    }
+    ++m_nextIndex;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+
+ContainerWriter::ContainerWriter(QIODevice *device)
+    : m_device(device)
+{
+}
+
+bool ContainerWriter::writeHeader(const ContainerHeader &header)
+{
+    m_headerBytes = header.serialize();
+    m_delta = header.isDelta();
+    return m_device->write(m_headerBytes) == m_headerBytes.size();
+}
+
+void ContainerWriter::resume(const ContainerHeader &header, const QByteArray &headerBytes)
+{
+    m_headerBytes = headerBytes;
+    m_delta = header.isDelta();
+}
+
+bool ContainerWriter::writeChunk(const ContainerChunk &chunk)
+{
+    QByteArray record(4, 0);
+    qToBigEndian<quint32>(chunk.info(), record.data());
+    if (m_delta) {
+        if (chunk.fingerprint.size() != ContainerHeader::FingerprintSize)
+            return false;
+        record.append(chunk.deltaFields());
+    }
+    return m_device->write(record) == record.size()
+        && m_device->write(chunk.data) == chunk.data.size()
+        && m_device->write(chunk.tag) == chunk.tag.size();
+}
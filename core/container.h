@@ -0,0 +1,257 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/container.h — формат зашифрованного файла (.kuz / .mag)
+//
+//   Заголовок:
+//     0   4  сигнатура "GOST"
+//     4   1  версия формата (1)
+//     5   1  алгоритм шифрования (AlgorithmId)
+//     6   1  алгоритм имитовставки (MacId)
+//     7   1  флаги: FlagInPlace, FlagSparse, FlagDelta, FlagArchive
+//     8   4  размер фрагмента, big-endian
+//    12   2  длина расширений, big-endian
+//    14  16  соль
+//    30   n  синхропосылка, n = размер блока шифра
+//     …      расширения — записи «тип (1), длина (1), значение»:
+//              1  сжатие фрагментов, 1 байт CompressionId
+//            неизвестный тип делает заголовок неверным
+//
+//   Далее фрагменты, каждый:
+//     4  info: бит 31 — последний фрагмент, бит 30 — дыра, бит 29 —
+//        данные сжаты, биты 0..28 — длина данных
+//     8  поколение фрагмента, big-endian      ┐ только в контейнере
+//    32  отпечаток открытого текста         ┘ с FlagDelta
+//     …  шифртекст фрагмента (не длиннее размера фрагмента)
+//     t  имитовставка (заголовок, номер, info, [поколение, отпечаток,]
+//        шифртекст): HMAC-Стрибог при MacId::HmacStreebog256 (t = 32),
+//        CMAC шифра на ключе имитовставки при MacId::Cmac (t = размер
+//        блока); при MacId::Mgm (t = размер блока) — см. ниже
+//
+// В контейнере с FlagSparse фрагмент, целиком попавший в дыру разреженного
+// файла, хранится без шифртекста: info с битом «дыра» и длиной открытого
+// текста, затем имитовставка с пустыми данными. При расшифровании на его
+// месте снова получается дыра. Номер фрагмента и счётчик CTR соседей от
+// этого не меняются.
+//
+// В контейнере со сжатием фрагмент может храниться сжатым кодеком из
+// заголовка: шифруется и покрывается имитовставкой сжатый текст. Правило
+// «последний фрагмент короче полного» тогда проверяется после распаковки.
+//
+// Обновляемый контейнер (FlagDelta) — без сжатия и дыр, поэтому все записи,
+// кроме последней, одной длины и запись i лежит по известному смещению.
+// Отпечаток — HMAC открытого текста фрагмента на отдельном ключе: по нему
+// обновление находит изменённые фрагменты, не расшифровывая контейнер,
+// а содержимое из отпечатка не восстановить. Изменённый фрагмент
+// перезаписывается с поколением больше всех прежних; счётчик CTR поколения
+// g > 0 начинается не с синхропосылки, а с Streebog(синхропосылка, g),
+// и гамма нового шифртекста не повторяет гамму прежнего.
+//
+// Открытый текст контейнера с FlagArchive — папка целиком (core/archive.h).
+// Архив тоже без сжатия и дыр: записи одной длины, и отдельный файл
+// читается по оглавлению, с расшифрованием только своих фрагментов.
+//
+// Фрагмент i шифруется в режиме CTR со счётчика iv + i * (размер фрагмента /
+// размер блока), поэтому фрагменты можно обрабатывать независимо. Последний
+// фрагмент всегда короче полного (возможно, пустой) — обрезанный файл
+// отличим от целого.
+//
+// В контейнере с MacId::Mgm фрагмент шифруется и покрывается имитовставкой
+// за один проход режимом MGM (crypto/mgm.h) на ключе шифрования, без HMAC.
+// Синхропосылка фрагмента i — iv, к младшим 64 битам которого прибавлено i;
+// ассоциированные данные — дайджест заголовка, номер и info, как у HMAC.
+// Такой контейнер не бывает обновляемым и «на месте»; контейнер с CMAC
+// не бывает «на месте».
+//
+// Контейнер «на месте» (FlagInPlace) получается шифрованием файла поверх
+// него самого: шифртекст лежит с нулевого смещения той же длины, что
+// исходные данные, а всё остальное дописано в конец:
+//     N  шифртекст; фрагмент i — с позиции i * размер фрагмента
+//     …  заголовок (с флагом FlagInPlace)
+//  32×k  имитовставки фрагментов, k = N / размер фрагмента + 1
+//     8  N, big-endian
+//     4  длина хвоста от заголовка до конца файла, big-endian
+//     8  сигнатура "GOSTTAIL"
+// Имитовставки считаются так же, как в обычном контейнере.
+#ifndef CONTAINER_H
+#define CONTAINER_H
+
+#include <QByteArray>
+#include <QString>
+
+class QIODevice;
+
+enum class AlgorithmId : quint8 {
+    Kuznechik = 1,
+    Magma = 2
+};
+
+enum class MacId : quint8 {
+    HmacStreebog256 = 1,
+    Mgm = 2,    // шифрование с имитовставкой, вместо CTR и HMAC
+    Cmac = 3    // ГОСТ Р 34.13-2015, п. 4.6, на шифре контейнера
+};
+
+enum class CompressionId : quint8 {
+    None = 0,
+    Deflate = 1,
+    Zstd = 2
+};
+
+// Размер блока шифра или 0 для неизвестного алгоритма
+int algorithmBlockSize(AlgorithmId algorithm);
+// "hmac" / "mgm" / "cmac" из настроек; пусто — HMAC
+bool macFromName(const QString &name, MacId *mac);
+
+struct ContainerHeader
+{
+    static constexpr quint8 Version = 1;
+    static constexpr quint8 FlagInPlace = 0x01;
+    static constexpr quint8 FlagSparse = 0x02;
+    static constexpr quint8 FlagDelta = 0x04;
+    static constexpr quint8 FlagArchive = 0x08;
+    static constexpr int FixedSize = 30;
+    static constexpr int SaltSize = 16;
+    static constexpr int HmacTagSize = 32;
+    static constexpr int FingerprintSize = 32;
+    static constexpr int DeltaFieldsSize = 8 + FingerprintSize;
+    static constexpr quint32 DefaultChunkSize = 1 << 20;
+    static constexpr quint32 MinChunkSize = 1 << 10;
+    static constexpr quint32 MaxChunkSize = 1 << 26;
+
+    AlgorithmId algorithm = AlgorithmId::Kuznechik;
+    MacId mac = MacId::HmacStreebog256;
+    quint8 flags = 0;
+    quint32 chunkSize = DefaultChunkSize;
+    QByteArray salt;
+    QByteArray iv;
+    CompressionId compression = CompressionId::None;    // расширение 1
+
+    bool isDelta() const { return (flags & FlagDelta) != 0; }
+    bool isArchive() const { return (flags & FlagArchive) != 0; }
+    // Длина имитовставки фрагмента: у MGM и CMAC — блок шифра
+    int tagSize() const { return mac == MacId::HmacStreebog256 ? HmacTagSize : algorithmBlockSize(algorithm); }
+    // Все записи фрагментов, кроме последней, одной длины: без сжатия и дыр
+    bool hasFixedRecords() const
+    {
+        return compression == CompressionId::None && !(flags & (FlagSparse | FlagInPlace));
+    }
+    // Длина записи фрагмента: info, поля FlagDelta, данные, имитовставка
+    qint64 recordSize(int dataSize) const
+    {
+        return 4 + (isDelta() ? DeltaFieldsSize : 0) + dataSize + tagSize();
+    }
+    // Смещение записи фрагмента index при hasFixedRecords()
+    qint64 chunkOffset(int headerSize, quint64 index) const
+    {
+        return headerSize + qint64(index) * recordSize(int(chunkSize));
+    }
+
+    QByteArray serialize() const;
+
+    // Разбор заголовка из начала data. При успехе в *consumed — его длина.
+    // Возвращает false для чужих, повреждённых или неполных данных.
+    static bool parse(const QByteArray &data, ContainerHeader &out, int *consumed = nullptr);
+};
+
+// Один фрагмент контейнера в том виде, как он лежит в файле
+struct ContainerChunk
+{
+    quint64 index = 0;
+    bool last = false;
+    QByteArray data;   // шифртекст; у дыры пуст
+    QByteArray tag;
+    quint32 holeSize = 0;   // > 0 — фрагмент-дыра из holeSize нулей
+    bool compressed = false;    // data — шифртекст сжатых данных
+    quint64 generation = 0;     // FlagDelta: поколение счётчика CTR
+    QByteArray fingerprint;     // FlagDelta: отпечаток открытого текста
+
+    bool isHole() const { return holeSize > 0; }
+    // Поле info, как оно записывается и входит в имитовставку
+    quint32 info() const;
+    // Поколение и отпечаток, как они записываются; без отпечатка — пусто
+    QByteArray deltaFields() const;
+};
+
+// Последовательное чтение контейнера с проверкой всех границ.
+// Не доверяет ни одному полю файла: размеры сверяются с заголовком,
+// конец данных до последнего фрагмента считается ошибкой.
+class ContainerReader
+{
+public:
+    explicit ContainerReader(QIODevice *device);
+
+    bool readHeader();
+    // false — ошибка или конец контейнера (после последнего фрагмента).
+    // Без withData шифртекст и имитовставка пропускаются (нужен seek)
+    bool readChunk(ContainerChunk &chunk, bool withData = true);
+    // Перейти к записи фрагмента index (только при hasFixedRecords())
+    bool seekChunk(quint64 index);
+
+    const ContainerHeader &header() const { return m_header; }
+    const QByteArray &headerBytes() const { return m_headerBytes; }
+    bool atEnd() const { return m_finished; }
+    quint64 nextChunkIndex() const { return m_nextIndex; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool fail(const QString &error);
+
+    QIODevice *m_device;
+    ContainerHeader m_header;
+    QByteArray m_headerBytes;
+    quint64 m_nextIndex = 0;
+    bool m_headerRead = false;
+    bool m_finished = false;
+    QString m_error;
+};
+
+class ContainerWriter
+{
+public:
+    explicit ContainerWriter(QIODevice *device);
+
+    bool writeHeader(const ContainerHeader &header);
+    // Дописывать фрагменты в контейнер с уже записанным заголовком
+    void resume(const ContainerHeader &header, const QByteArray &headerBytes);
+    bool writeChunk(const ContainerChunk &chunk);
+
+    const QByteArray &headerBytes() const { return m_headerBytes; }
+
+private:
+    QIODevice *m_device;
+    QByteArray m_headerBytes;
+    bool m_delta = false;
+};
+
+// Хвост контейнера «на месте»
+struct InPlaceTrailer
+{
+    static constexpr int FooterSize = 20;
+    // Имитовставки держатся в памяти целиком: больше фрагментов не бывает
+    static constexpr quint64 MaxChunks = (quint64(1) << 30) / ContainerHeader::HmacTagSize;
+
+    ContainerHeader header;
+    QByteArray headerBytes;
+    quint64 dataSize = 0;
+    QByteArray tags;        // chunkCount() × header.tagSize()
+
+    static quint64 chunkCount(quint64 dataSize, quint32 chunkSize) { return dataSize / chunkSize + 1; }
+    quint64 chunkCount() const { return chunkCount(dataSize, header.chunkSize); }
+
+    QByteArray serialize() const;
+    // Читает хвост с произвольным доступом; false — это не контейнер «на месте»
+    // или хвост повреждён (тогда в *error — причина)
+    static bool read(QIODevice *device, InPlaceTrailer &out, QString *error = nullptr);
+};
+
+// Поле info фрагмента и данные, покрываемые имитовставкой
+quint32 chunkInfo(bool last, int size, bool hole = false, bool compressed = false);
+QByteArray chunkMacInput(const QByteArray &headerDigest, quint64 index, quint32 info);
+
+#endif // CONTAINER_H
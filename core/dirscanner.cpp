@@ -0,0 +1,145 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/dirscanner.cpp
+#include "dirscanner.h"
+#include "trace.h"
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QThread>
+#include <chrono>
+#include <thread>
+
+DirectoryScanner::DirectoryScanner(int threads)
+    : m_threads(threads > 0 ? threads : qMax(1, QThread::idealThreadCount()))
+{
+    for (int i = 0; i < m_threads; ++i)
+        m_queues.push_back(std::make_unique<WorkQueue>());
+}
+
+void DirectoryScanner::scan(const QStringList &roots, const FileSink &sink)
+{
+    // Отмена до начала обхода не теряется: флаг не сбрасывается
+    if (isCancelled())
+        return;
+    m_sink = &sink;
+    m_directories.store(0, std::memory_order_relaxed);
+    m_files.store(0, std::memory_order_relaxed);
+
+    // Корни раздаются по очередям по кругу; остальное разойдётся кражей
+    int next = 0;
+    for (const QString &root : roots) {
+        const QFileInfo info(root);
+        if (info.isDir()) {
+            m_pending.fetch_add(1, std::memory_order_relaxed);
+            m_queues[next]->dirs.push_back(root);
+            next = (next + 1) % m_threads;
+        } else if (info.isFile() && !isCancelled()) {
+            m_files.fetch_add(1, std::memory_order_relaxed);
+            if (!sink(root, info.size()))
+                cancel();
+        }
+    }
+
+    if (m_pending.load(std::memory_order_relaxed) > 0) {
+        std::vector<std::thread> workers;
+        workers.reserve(m_threads);
+        for (int i = 0; i < m_threads; ++i)
+            workers.emplace_back(&DirectoryScanner::run, this, i);
+        for (std::thread &worker : workers)
+            worker.join();
+    }
+    m_sink = nullptr;
+}
+
+void DirectoryScanner::run(int self)
+{
+    Trace::setThreadName(QStringLiteral("scanner %1").arg(self));
+
+    QString dir;
+    for (;;) {
+        if (takeLocal(self, &dir) || steal(self, &dir)) {
+            if (!isCancelled())
+                listDirectory(self, dir);
+            if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::lock_guard<std::mutex> lock(m_idleMutex);
+                m_idle.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_idleMutex);
+        if (m_pending.load(std::memory_order_acquire) == 0)
+            return;
+        // Каталог мог появиться между неудачной кражей и ожиданием —
+        // короткий таймаут дешевле точного учёта спящих потоков
+        m_idle.wait_for(lock, std::chrono::milliseconds(1));
+    }
+}
+
+bool DirectoryScanner::takeLocal(int self, QString *dir)
+{
+    WorkQueue &queue = *m_queues[self];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.dirs.empty())
+        return false;
+    *dir = std::move(queue.dirs.back());
+    queue.dirs.pop_back();
+    return true;
+}
+
+bool DirectoryScanner::steal(int self, QString *dir)
+{
+    for (int i = 1; i < m_threads; ++i) {
+        WorkQueue &victim = *m_queues[(self + i) % m_threads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.dirs.empty())
+            continue;
+        *dir = std::move(victim.dirs.front());
+        victim.dirs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void DirectoryScanner::push(int self, const QString &dir)
+{
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        WorkQueue &queue = *m_queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.dirs.push_back(dir);
+    }
+    m_idle.notify_one();
+}
+
+void DirectoryScanner::listDirectory(int self, const QString &dir)
+{
+    DIPLOM_TRACE_SPAN_ARG("list_dir", "scan", "path", dir);
+    m_directories.fetch_add(1, std::memory_order_relaxed);
+
+    QDir::Filters filters = QDir::Files | QDir::AllDirs | QDir::NoDotAndDotDot;
+    if (m_includeHidden)
+        filters |= QDir::Hidden;
+    QDirIterator it(dir, filters);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.isDir()) {
+            if (!info.isSymLink())
+                push(self, path);
+            continue;
+        }
+
+        m_files.fetch_add(1, std::memory_order_relaxed);
+        if (!(*m_sink)(path, info.size()))
+            cancel();
+        if (isCancelled())
+            return;
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/dirscanner.h — параллельный обход дерева каталогов
+//
+// У каждого потока своя очередь каталогов: найденные подкаталоги кладутся
+// в конец своей очереди и оттуда же берутся (обход в глубину, горячий кэш
+// каталога), а простаивающий поток крадёт из начала чужой очереди — там
+// лежат каталоги ближе к корню, то есть самые крупные поддеревья.
+//
+// Найденные файлы сразу отдаются в sink из рабочих потоков, поэтому
+// обработка может начаться до конца обхода. Фильтры — как у прежнего
+// QDirIterator(QDir::Files, Subdirectories): скрытые файлы и каталоги
+// пропускаются (если не включён setIncludeHidden), по символическим
+// ссылкам на каталоги обход не идёт.
+#ifndef DIRSCANNER_H
+#define DIRSCANNER_H
+
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class DirectoryScanner
+{
+public:
+    // Вызывается из рабочих потоков; false — прекратить обход.
+    // Размер берётся из того же чтения каталога, без лишнего stat()
+    using FileSink = std::function<bool(const QString &filePath, qint64 size)>;
+
+    // threads <= 0 — по числу ядер
+    explicit DirectoryScanner(int threads = 0);
+
+    // Обойти корни и вернуться, когда обход закончен или прерван.
+    // Корень-файл передаётся в sink как есть.
+    void scan(const QStringList &roots, const FileSink &sink);
+    // Брать и скрытые файлы и каталоги — для архива папки целиком
+    void setIncludeHidden(bool include) { m_includeHidden = include; }
+    // Прервать обход из любого потока; отменённый до scan() обходчик
+    // сразу возвращается из него
+    void cancel() { m_cancelled.store(true, std::memory_order_relaxed); }
+    bool isCancelled() const { return m_cancelled.load(std::memory_order_relaxed); }
+
+    int threadCount() const { return m_threads; }
+    quint64 directoryCount() const { return m_directories.load(std::memory_order_relaxed); }
+    quint64 fileCount() const { return m_files.load(std::memory_order_relaxed); }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<QString> dirs;
+    };
+
+    void run(int self);
+    bool takeLocal(int self, QString *dir);
+    bool steal(int self, QString *dir);
+    void push(int self, const QString &dir);
+    void listDirectory(int self, const QString &dir);
+
+    int m_threads;
+    bool m_includeHidden = false;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    const FileSink *m_sink = nullptr;
+
+    // Каталогов в очередях и в обработке; ноль — обход закончен
+    std::atomic<qint64> m_pending{0};
+    std::atomic<bool> m_cancelled{false};
+    std::mutex m_idleMutex;
+    std::condition_variable m_idle;
+
+    std::atomic<quint64> m_directories{0};
+    std::atomic<quint64> m_files{0};
+};
+
+#endif // DIRSCANNER_H
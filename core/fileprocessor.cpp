@@ -0,0 +1,1542 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/fileprocessor.cpp
+#include "fileprocessor.h"
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtEndian>
+#include "crypto/ctr.h"
+#include "crypto/cmac.h"
+#include "crypto/hmac.h"
+#include "crypto/mgm.h"
+#include "crypto/random.h"
+#include "algorithms.h"
+#include "compression.h"
+#include "groupcommit.h"
+#include "inplacejournal.h"
+#include "manifest.h"
+#include "metrics.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#if defined(Q_OS_UNIX)
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+// Имитовставка в сообщениях об ошибках
+static QString macTitle(MacId mac)
+{
+    switch (mac) {
+    case MacId::Mgm:  return QStringLiteral("Имитовставка MGM");
+    case MacId::Cmac: return QStringLiteral("Имитовставка CMAC");
+    default:          return QStringLiteral("HMAC");
+    }
+}
+
+// Сравнение имитовставок за время, не зависящее от содержимого
+static bool equalTags(const QByteArray &a, const QByteArray &b)
+{
+    if (a.size() != b.size())
+        return false;
+    quint8 diff = 0;
+    for (int i = 0; i < a.size(); ++i)
+        diff |= static_cast<quint8>(a[i] ^ b[i]);
+    return diff == 0;
+}
+
+// Читать, пока не наберётся size байт или не кончатся данные
+static bool readFully(QIODevice &in, QByteArray &buffer, int size)
+{
+    buffer.resize(size);
+    qint64 total = 0;
+    while (total < size) {
+        const qint64 n = in.read(buffer.data() + total, size - total);
+        if (n < 0)
+            return false;
+        if (n == 0 && (in.atEnd() || !in.waitForReadyRead(-1)))
+            break;
+        total += n;
+    }
+    buffer.resize(static_cast<int>(total));
+    return true;
+}
+
+// Данные под имитовставкой фрагмента обычного контейнера
+static QByteArray chunkMacData(const QByteArray &headerDigest, const ContainerChunk &chunk)
+{
+    return chunkMacInput(headerDigest, chunk.index, chunk.info()) + chunk.deltaFields() + chunk.data;
+}
+
+// Наложить гамму на size байт фрагмента с его блока firstBlock. Поколение 0
+// идёт одним счётчиком от синхропосылки заголовка, как в обычном
+// контейнере. У каждой перезаписи фрагмента своя синхропосылка, выведенная
+// из заголовочной, поколения и номера: счётчик перезаписанного фрагмента
+// начинается с нуля от неё и занимает лишь блоки этого фрагмента, так что
+// с прежней гаммой может сойтись только случайно, а не из-за длины файла
+template<typename Cipher>
+static void chunkGamma(const Cipher &cipher, const ContainerHeader &header, quint64 generation, quint64 index,
+                       quint64 firstBlock, char *data, qint64 size)
+{
+    if (generation == 0) {
+        const quint64 blocksPerChunk = header.chunkSize / CipherTraits<Cipher>::BlockSize;
+        applyCTR(cipher, header.iv, index * blocksPerChunk + firstBlock, data, size);
+        return;
+    }
+    QByteArray input = header.iv;
+    input.resize(header.iv.size() + 16);
+    qToBigEndian<quint64>(generation, input.data() + header.iv.size());
+    qToBigEndian<quint64>(index, input.data() + header.iv.size() + 8);
+    applyCTR(cipher, streebog256(input).left(header.iv.size()), firstBlock, data, size);
+}
+
+// Синхропосылка MGM фрагмента index: к младшим 64 битам синхропосылки
+// заголовка прибавлен номер. Старший бит отбрасывает Mgm, и у номеров
+// меньше 2^63 синхропосылки разные
+static QByteArray mgmNonce(const QByteArray &iv, quint64 index)
+{
+    QByteArray nonce = iv;
+    uchar *low = reinterpret_cast<uchar *>(nonce.data()) + nonce.size() - 8;
+    qToBigEndian<quint64>(qFromBigEndian<quint64>(low) + index, low);
+    return nonce;
+}
+
+// Имитовставка фрагмента отдельным от шифрования проходом: HMAC-Стрибог
+// или CMAC шифра контейнера на ключе имитовставки. Ключ CMAC развёрнут
+// один раз на контейнер, как и ключ шифрования
+template<typename Cipher>
+class ChunkMac
+{
+public:
+    ChunkMac(MacId mac, const QByteArray &key, const QByteArray &headerDigest)
+        : m_mac(mac)
+        , m_key(key)
+        , m_headerDigest(headerDigest)
+        , m_cipher(mac == MacId::Cmac ? Cipher(key) : Cipher())
+    {
+    }
+
+    const QByteArray &headerDigest() const { return m_headerDigest; }
+
+    QByteArray tag(const ContainerChunk &chunk) const
+    {
+        if (m_mac != MacId::Cmac)
+            return hmacStreebog(chunkMacData(m_headerDigest, chunk), m_key);
+        // Шифртекст подаётся на месте, без склейки с полями
+        const QByteArray head = chunkMacInput(m_headerDigest, chunk.index, chunk.info()) + chunk.deltaFields();
+        Cmac<Cipher> cmac(m_cipher);
+        cmac.update(head.constData(), head.size());
+        cmac.update(chunk.data.constData(), chunk.data.size());
+        QByteArray tag(Cmac<Cipher>::TagSize, 0);
+        cmac.finish(reinterpret_cast<quint8 *>(tag.data()));
+        return tag;
+    }
+
+private:
+    MacId m_mac;
+    QByteArray m_key;
+    QByteArray m_headerDigest;
+    Cipher m_cipher;
+};
+
+// Зашифровать фрагмент и выработать его имитовставку по режиму заголовка:
+// CTR и имитовставка двумя проходами или MGM одним
+template<typename Cipher>
+static void sealChunk(const Cipher &cipher, const ContainerHeader &header, const ChunkMac<Cipher> &mac,
+                      ContainerChunk &chunk)
+{
+    if (header.mac == MacId::Mgm) {
+        DIPLOM_STAGE_TIMER(Cipher);
+        const QByteArray ad = chunkMacInput(mac.headerDigest(), chunk.index, chunk.info());
+        const QByteArray nonce = mgmNonce(header.iv, chunk.index);
+        chunk.tag.resize(Mgm<Cipher>::TagSize);
+        Mgm<Cipher>(cipher, reinterpret_cast<const quint8 *>(nonce.constData()))
+            .encrypt(ad.constData(), ad.size(), chunk.data.data(), chunk.data.size(),
+                     reinterpret_cast<quint8 *>(chunk.tag.data()));
+        return;
+    }
+    {
+        DIPLOM_STAGE_TIMER(Cipher);
+        chunkGamma(cipher, header, chunk.generation, chunk.index, 0, chunk.data.data(), chunk.data.size());
+    }
+    {
+        DIPLOM_STAGE_TIMER(Mac);
+        chunk.tag = mac.tag(chunk);
+    }
+}
+
+// Имитовставка прочитанного фрагмента совпадает с вычисленной
+template<typename Cipher>
+static bool chunkTagValid(const Cipher &cipher, const ContainerHeader &header, const ChunkMac<Cipher> &mac,
+                          const ContainerChunk &chunk)
+{
+    DIPLOM_STAGE_TIMER(Mac);
+    if (header.mac == MacId::Mgm) {
+        const QByteArray ad = chunkMacInput(mac.headerDigest(), chunk.index, chunk.info());
+        const QByteArray nonce = mgmNonce(header.iv, chunk.index);
+        QByteArray expected(Mgm<Cipher>::TagSize, 0);
+        Mgm<Cipher>(cipher, reinterpret_cast<const quint8 *>(nonce.constData()))
+            .computeTag(ad.constData(), ad.size(), chunk.data.constData(), chunk.data.size(),
+                        reinterpret_cast<quint8 *>(expected.data()));
+        return equalTags(expected, chunk.tag);
+    }
+    return equalTags(mac.tag(chunk), chunk.tag);
+}
+
+// Расшифровать size байт фрагмента с его блока firstBlock — после проверки
+// имитовставки
+template<typename Cipher>
+static void openChunk(const Cipher &cipher, const ContainerHeader &header, const ContainerChunk &chunk,
+                      quint64 firstBlock, char *data, qint64 size)
+{
+    DIPLOM_STAGE_TIMER(Cipher);
+    if (header.mac == MacId::Mgm) {
+        const QByteArray nonce = mgmNonce(header.iv, chunk.index);
+        Mgm<Cipher>(cipher, reinterpret_cast<const quint8 *>(nonce.constData())).crypt(firstBlock, data, size);
+        return;
+    }
+    chunkGamma(cipher, header, chunk.generation, chunk.index, firstBlock, data, size);
+}
+
+// Отпечаток открытого текста фрагмента для обновления — HMAC на своём
+// ключе. Номер и info входят в него: одинаковые фрагменты в разных местах
+// не совпадают, а совпавший отпечаток значит и ту же длину
+static QByteArray chunkFingerprint(const QByteArray &key, quint64 index, bool last, const QByteArray &plain)
+{
+    QByteArray input(12, 0);
+    qToBigEndian<quint64>(index, input.data());
+    qToBigEndian<quint32>(chunkInfo(last, plain.size()), input.data() + 8);
+    return hmacStreebog(input + plain, key);
+}
+
+// Метка прерванного обновления: пока она есть, контейнер может содержать
+// недописанные фрагменты. Внутри — поколение, которым шло обновление.
+static const char UpdateSuffix[] = ".diplom-update";
+
+static QString updateMarkerFor(const QString &containerPath)
+{
+    const QFileInfo info(containerPath);
+    return info.path() + QStringLiteral("/.") + info.fileName() + QLatin1String(UpdateSuffix);
+}
+
+// Дыры разреженного входного файла по SEEK_DATA / SEEK_HOLE. Для потоков,
+// не-файлов и систем без этих запросов дыр нет — файл читается целиком.
+class HoleFinder
+{
+public:
+    explicit HoleFinder(QIODevice &in)
+    {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        QFileDevice *file = qobject_cast<QFileDevice *>(&in);
+        if (file && !file->isSequential()) {
+            m_fd = file->handle();
+            m_size = file->size();
+        }
+#else
+        Q_UNUSED(in);
+#endif
+    }
+
+    bool hasHoles()
+    {
+        return m_fd >= 0 && query(0, SeekHole) < m_size;
+    }
+
+    // В [offset, offset + length) нет ни байта данных
+    bool isHole(qint64 offset, qint64 length)
+    {
+        if (m_fd < 0 || length <= 0)
+            return false;
+        // Следующие данные запоминаются: на длинной дыре — один запрос
+        if (m_nextData < offset)
+            m_nextData = query(offset, SeekData);
+        return m_nextData >= offset + length;
+    }
+
+private:
+    enum Whence { SeekData, SeekHole };
+
+    // Смещение следующих данных или дыры; за концом данных — размер файла.
+    // Позиция дескриптора возвращается: QFile читает с неё же
+    qint64 query(qint64 offset, Whence whence)
+    {
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+        const off_t saved = ::lseek(m_fd, 0, SEEK_CUR);
+        const off_t found = ::lseek(m_fd, off_t(offset), whence == SeekData ? SEEK_DATA : SEEK_HOLE);
+        const int error = errno;
+        ::lseek(m_fd, saved, SEEK_SET);
+        if (found >= 0)
+            return qint64(found);
+        // ENXIO — дальше данных нет; прочие ошибки — считать всё данными
+        if (error == ENXIO)
+            return m_size;
+        m_fd = -1;
+        return offset;
+#else
+        Q_UNUSED(whence);
+        return offset;
+#endif
+    }
+
+    int m_fd = -1;
+    qint64 m_size = 0;
+    qint64 m_nextData = -1;
+};
+
+static void countChunk(int dataSize, int blockSize, qint64 bytesIn, qint64 bytesOut)
+{
+    DIPLOM_COUNT(Chunks, 1);
+    DIPLOM_COUNT(Blocks, (dataSize + blockSize - 1) / blockSize);
+    DIPLOM_COUNT(BytesIn, bytesIn);
+    DIPLOM_COUNT(BytesOut, bytesOut);
+}
+
+FileProcessor::FileProcessor(const QString &password)
+    : m_password(password.toUtf8())
+{
+}
+
+QString FileProcessor::extensionFor(AlgorithmId algorithm)
+{
+    const AlgorithmInfo *info = findAlgorithm(algorithm);
+    return QString::fromLatin1(info ? info->extension : Algorithms[0].extension);
+}
+
+bool FileProcessor::isEncryptedName(const QString &fileName)
+{
+    for (const AlgorithmInfo &info : Algorithms) {
+        if (fileName.endsWith(QLatin1String(info.extension)))
+            return true;
+    }
+    return false;
+}
+
+bool FileProcessor::isServiceName(const QString &fileName)
+{
+    return GroupCommit::isTempName(fileName) || InPlaceJournal::isJournalName(fileName)
+        || Manifest::isManifestName(fileName) || fileName.endsWith(QLatin1String(UpdateSuffix));
+}
+
+bool FileProcessor::algorithmFromName(const QString &name, AlgorithmId *algorithm)
+{
+    const AlgorithmInfo *info = findAlgorithm(name.trimmed());
+    if (!info)
+        return false;
+    *algorithm = info->id;
+    return true;
+}
+
+bool FileProcessor::fail(const QString &error)
+{
+    m_error = error;
+    return false;
+}
+
+void FileProcessor::reportRead(quint64 bytes)
+{
+    m_bytesRead += bytes;
+    if (m_progress)
+        m_progress->fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// PBKDF: итерации Streebog(salt + key), затем раздельные ключи
+// шифрования и имитовставки
+FileProcessor::Keys FileProcessor::deriveKeys(const QByteArray &salt) const
+{
+    DIPLOM_STAGE_TIMER(Kdf);
+
+    QByteArray key = m_password;
+    for (int i = 0; i < m_kdfIterations; ++i) {
+        key = streebog256(salt + key);
+    }
+
+    Keys keys;
+    keys.enc = hmacStreebog(QByteArrayLiteral("enc"), key);
+    keys.mac = hmacStreebog(QByteArrayLiteral("mac"), key);
+    keys.fingerprint = hmacStreebog(QByteArrayLiteral("fingerprint"), key);
+    return keys;
+}
+
+template<typename Cipher>
+bool FileProcessor::encryptChunks(QIODevice &in, ContainerWriter &writer, const ContainerHeader &header, const Keys &keys)
+{
+    const Cipher cipher(keys.enc);
+    if (!cipher.isValid())
+        return fail(QStringLiteral("Не удалось установить ключ"));
+
+    const ChunkMac<Cipher> mac(header.mac, keys.mac, streebog256(writer.headerBytes()));
+
+    DIPLOM_COUNT(BytesOut, writer.headerBytes().size());
+
+    // Длина файла известна заранее: дыру не читают, чтобы узнать её конец
+    HoleFinder holes(in);
+    const bool sparse = (header.flags & ContainerHeader::FlagSparse) != 0;
+    const qint64 inSize = sparse ? in.size() : 0;
+
+    ContainerChunk chunk;
+    for (;;) {
+        DIPLOM_TRACE_SPAN_ARG("chunk", "chunk", "index", QString::number(chunk.index));
+        const qint64 offset = qint64(chunk.index) * header.chunkSize;
+        const qint64 length = qMin<qint64>(header.chunkSize, inSize - offset);
+        if (sparse && holes.isHole(offset, length)) {
+            if (!in.seek(offset + length))
+                return fail(QStringLiteral("Ошибка чтения"));
+            reportRead(quint64(length));
+
+            chunk.data.clear();
+            chunk.holeSize = quint32(length);
+            chunk.compressed = false;
+            chunk.last = length < qint64(header.chunkSize);
+            sealChunk(cipher, header, mac, chunk);
+            {
+                DIPLOM_STAGE_TIMER(Write);
+                if (!writer.writeChunk(chunk))
+                    return fail(QStringLiteral("Ошибка записи"));
+            }
+            DIPLOM_COUNT(Chunks, 1);
+            DIPLOM_COUNT(BytesIn, length);
+            DIPLOM_COUNT(BytesOut, header.recordSize(0));
+            chunk.holeSize = 0;
+
+            if (chunk.last)
+                return true;
+            ++chunk.index;
+            continue;
+        }
+
+        {
+            DIPLOM_STAGE_TIMER(Read);
+            if (!readFully(in, chunk.data, static_cast<int>(header.chunkSize)))
+                return fail(QStringLiteral("Ошибка чтения"));
+        }
+        reportRead(chunk.data.size());
+
+        const int plainSize = chunk.data.size();
+        chunk.last = plainSize < static_cast<int>(header.chunkSize);
+        chunk.compressed = false;
+        if (header.isDelta()) {
+            DIPLOM_STAGE_TIMER(Mac);
+            chunk.fingerprint = chunkFingerprint(keys.fingerprint, chunk.index, chunk.last, chunk.data);
+        }
+        if (header.compression != CompressionId::None) {
+            DIPLOM_STAGE_TIMER(Compress);
+            QByteArray packed = Compression::compress(header.compression, chunk.data);
+            if (!packed.isEmpty()) {
+                chunk.data.swap(packed);
+                chunk.compressed = true;
+            }
+        }
+        sealChunk(cipher, header, mac, chunk);
+        {
+            DIPLOM_STAGE_TIMER(Write);
+            if (!writer.writeChunk(chunk))
+                return fail(QStringLiteral("Ошибка записи"));
+        }
+        countChunk(chunk.data.size(), CipherTraits<Cipher>::BlockSize, plainSize, header.recordSize(chunk.data.size()));
+
+        if (chunk.last)
+            return true;
+        ++chunk.index;
+    }
+}
+
+template<typename Cipher>
+bool FileProcessor::decryptChunks(ContainerReader &reader, QIODevice &out, const Keys &keys)
+{
+    const Cipher cipher(keys.enc);
+    if (!cipher.isValid())
+        return fail(QStringLiteral("Не удалось установить ключ"));
+
+    const ContainerHeader &header = reader.header();
+    const ChunkMac<Cipher> mac(header.mac, keys.mac, streebog256(reader.headerBytes()));
+
+    DIPLOM_COUNT(BytesIn, reader.headerBytes().size());
+    reportRead(reader.headerBytes().size());
+
+    qint64 pendingHole = 0;
+    ContainerChunk chunk;
+    for (;;) {
+        DIPLOM_TRACE_SPAN_ARG("chunk", "chunk", "index", QString::number(reader.nextChunkIndex()));
+        {
+            DIPLOM_STAGE_TIMER(Read);
+            if (!reader.readChunk(chunk))
+                break;
+        }
+        reportRead(header.recordSize(chunk.data.size()));
+        if (!chunkTagValid(cipher, header, mac, chunk))
+            return fail(QStringLiteral("%1 не совпадает: файл подделан или повреждён (фрагмент %2)")
+                            .arg(macTitle(header.mac)).arg(chunk.index));
+        if (chunk.isHole()) {
+            // Дыра не пишется: следующая запись или конец её пропустят
+            pendingHole += chunk.holeSize;
+            DIPLOM_COUNT(Chunks, 1);
+            DIPLOM_COUNT(BytesIn, header.recordSize(0));
+            DIPLOM_COUNT(BytesOut, chunk.holeSize);
+            if (chunk.last)
+                return skipHole(out, pendingHole, true);
+            continue;
+        }
+        openChunk(cipher, header, chunk, 0, chunk.data.data(), chunk.data.size());
+        const int storedSize = chunk.data.size();
+        if (chunk.compressed) {
+            DIPLOM_STAGE_TIMER(Compress);
+            QByteArray plain;
+            if (!Compression::decompress(header.compression, chunk.data, int(header.chunkSize), plain))
+                return fail(QStringLiteral("Повреждён сжатый фрагмент %1").arg(chunk.index));
+            // Правило длины, которое читатель не мог проверить до распаковки
+            if (chunk.last != (plain.size() < int(header.chunkSize)))
+                return fail(QStringLiteral("Неверная длина фрагмента %1").arg(chunk.index));
+            chunk.data.swap(plain);
+        }
+        // Перед последним фрагментом длина задаётся сразу: пустой
+        // последний фрагмент сам файл не удлинит
+        if (pendingHole > 0 && !skipHole(out, pendingHole, chunk.last))
+            return false;
+        {
+            DIPLOM_STAGE_TIMER(Write);
+            if (out.write(chunk.data) != chunk.data.size())
+                return fail(QStringLiteral("Ошибка записи"));
+        }
+        countChunk(storedSize, CipherTraits<Cipher>::BlockSize, header.recordSize(storedSize), chunk.data.size());
+
+        if (chunk.last)
+            return true;
+    }
+    return fail(reader.errorString());
+}
+
+// Пропуск дыры в выходе. Файл за пропущенным местом остаётся разреженным:
+// в середине — seek за конец перед следующей записью, в конце — resize
+// (ftruncate). Последовательный выход получает нули.
+bool FileProcessor::skipHole(QIODevice &out, qint64 &size, bool atEnd)
+{
+    DIPLOM_STAGE_TIMER(Write);
+    const qint64 end = out.pos() + size;
+    QFileDevice *file = qobject_cast<QFileDevice *>(&out);
+    bool ok = false;
+    if (atEnd && file && !file->isSequential())
+        ok = file->resize(end) && file->seek(end);
+    else if (!out.isSequential())
+        ok = out.seek(end);     // QBuffer дописывает нули сам
+    else {
+        const QByteArray zeros(int(qMin<qint64>(size, ContainerHeader::MaxChunkSize)), 0);
+        ok = true;
+        for (qint64 left = size; ok && left > 0; left -= zeros.size())
+            ok = out.write(zeros.constData(), qMin<qint64>(left, zeros.size())) == qMin<qint64>(left, zeros.size());
+    }
+    size = 0;
+    return ok || fail(QStringLiteral("Ошибка записи"));
+}
+
+bool FileProcessor::encryptStream(QIODevice &in, QIODevice &out, AlgorithmId algorithm)
+{
+    return encryptContainer(in, out, algorithm, 0);
+}
+
+bool FileProcessor::encryptContainer(QIODevice &in, QIODevice &out, AlgorithmId algorithm, quint8 flags)
+{
+    m_bytesRead = 0;
+    if (m_password.isEmpty())
+        return fail(QStringLiteral("Пароль не задан"));
+
+    if (!findAlgorithm(algorithm))
+        return fail(QStringLiteral("Неизвестный алгоритм"));
+
+    ContainerHeader header;
+    header.algorithm = algorithm;
+    header.chunkSize = m_chunkSize;
+    header.salt = SecureRandom::bytes(ContainerHeader::SaltSize);
+    header.iv = SecureRandom::bytes(algorithmBlockSize(algorithm));
+    if (header.salt.isEmpty() || header.iv.isEmpty())
+        return fail(QStringLiteral("Нет источника случайных чисел"));
+    header.flags = flags;
+    if (header.isArchive()) {
+        // Записи по местам для извлечения отдельных файлов: без сжатия и дыр
+    } else if (m_delta) {
+        // Записи по местам: дыры читаются нулями, сжатие не применяется
+        header.flags |= ContainerHeader::FlagDelta;
+    } else {
+        // Флаг — только если дыры есть: прочие контейнеры не меняются
+        if (HoleFinder(in).hasHoles())
+            header.flags |= ContainerHeader::FlagSparse;
+        if (!Compression::isAvailable(m_compression))
+            return fail(QStringLiteral("Сжатие %1 не поддерживается этой сборкой").arg(Compression::name(m_compression)));
+        header.compression = m_compression;
+    }
+    // Перезаписываемые фрагменты обновляемого контейнера — только под HMAC
+    header.mac = header.isDelta() && m_mac == MacId::Mgm ? MacId::HmacStreebog256 : m_mac;
+
+    const Keys keys = deriveKeys(header.salt);
+
+    ContainerWriter writer(&out);
+    if (!writer.writeHeader(header))
+        return fail(QStringLiteral("Ошибка записи"));
+
+    return withCipher(algorithm, [&](auto tag) {
+        return encryptChunks<typename decltype(tag)::Type>(in, writer, header, keys);
+    });
+}
+
+bool FileProcessor::decryptStream(QIODevice &in, QIODevice &out)
+{
+    m_bytesRead = 0;
+    if (m_password.isEmpty())
+        return fail(QStringLiteral("Пароль не задан"));
+
+    ContainerReader reader(&in);
+    if (!reader.readHeader())
+        return fail(reader.errorString());
+    if (!Compression::isAvailable(reader.header().compression))
+        return fail(QStringLiteral("Сжатие %1 не поддерживается этой сборкой")
+                        .arg(Compression::name(reader.header().compression)));
+
+    const Keys keys = deriveKeys(reader.header().salt);
+
+    return withCipher(reader.header().algorithm, [&](auto tag) {
+        return decryptChunks<typename decltype(tag)::Type>(reader, out, keys);
+    });
+}
+
+QString FileProcessor::encryptFile(const QString &filePath, AlgorithmId algorithm)
+{
+    DIPLOM_TRACE_SPAN_ARG("encrypt_file", "file", "path", filePath);
+
+    m_resultQueued = false;
+    // Файл в середине работы «на месте»: сначала довести её
+    if (QFile::exists(InPlaceJournal::pathFor(filePath)))
+        return resumeInPlace(filePath);
+
+    QFileInfo info(filePath);
+    const QString outPath = info.path() + "/" + info.fileName() + extensionFor(algorithm);
+    if (!m_keepSource && QFile::exists(outPath)) {
+        fail(QStringLiteral("Файл уже существует: %1").arg(outPath));
+        return QString();
+    }
+    return encryptTo(filePath, outPath, algorithm);
+}
+
+// Шифрование во временный файл с фиксацией под именем outPath
+QString FileProcessor::encryptTo(const QString &filePath, const QString &outPath, AlgorithmId algorithm,
+                                 bool replace)
+{
+    const QString tempPath = GroupCommit::tempPathFor(outPath);
+    QFile inFile(filePath);
+    QFile outFile(tempPath);
+    if (!inFile.open(QIODevice::ReadOnly) || !outFile.open(QIODevice::WriteOnly)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    const bool ok = encryptStream(inFile, outFile, algorithm);
+    inFile.close();
+    outFile.close();
+    if (!ok) {
+        QFile::remove(tempPath);
+        DIPLOM_COUNT(FilesFailed, 1);
+        return QString();
+    }
+    return commitOutput(filePath, tempPath, outPath, replace);
+}
+
+QString FileProcessor::decryptFile(const QString &filePath)
+{
+    DIPLOM_TRACE_SPAN_ARG("decrypt_file", "file", "path", filePath);
+
+    m_resultQueued = false;
+    if (QFile::exists(InPlaceJournal::pathFor(filePath)))
+        return resumeInPlace(filePath);
+    {
+        QFile probe(filePath);
+        InPlaceTrailer trailer;
+        if (probe.open(QIODevice::ReadOnly) && InPlaceTrailer::read(&probe, trailer)) {
+            probe.close();
+            return decryptInPlace(filePath);
+        }
+    }
+
+    QFileInfo info(filePath);
+    const QString fileName = info.fileName();
+    if (!isEncryptedName(fileName)) {
+        fail(QStringLiteral("Файл не зашифрован"));
+        return QString();
+    }
+    if (QFile::exists(updateMarkerFor(filePath))) {
+        fail(QStringLiteral("Обновление контейнера прервано, повторите его: %1").arg(filePath));
+        return QString();
+    }
+    const QString outPath = info.path() + "/" + fileName.left(fileName.length() - 4);
+    if (!m_keepSource && QFile::exists(outPath)) {
+        fail(QStringLiteral("Файл уже существует: %1").arg(outPath));
+        return QString();
+    }
+    {
+        QFile probe(filePath);
+        ContainerReader reader(&probe);
+        if (probe.open(QIODevice::ReadOnly) && reader.readHeader() && reader.header().isArchive()) {
+            probe.close();
+            return extractArchive(filePath, outPath);
+        }
+    }
+
+    const QString tempPath = GroupCommit::tempPathFor(outPath);
+    QFile inFile(filePath);
+    QFile outFile(tempPath);
+    if (!inFile.open(QIODevice::ReadOnly) || !outFile.open(QIODevice::WriteOnly)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    const bool ok = decryptStream(inFile, outFile);
+    inFile.close();
+    outFile.close();
+    if (!ok) {
+        // Частично расшифрованный файл не оставляем
+        QFile::remove(tempPath);
+        DIPLOM_COUNT(FilesFailed, 1);
+        return QString();
+    }
+    return commitOutput(filePath, tempPath, outPath);
+}
+
+QString FileProcessor::commitOutput(const QString &source, const QString &temp, const QString &target, bool replace)
+{
+    DIPLOM_COUNT(FilesDone, 1);
+    const GroupCommit::Entry entry{ temp, target, source, m_keepSource, replace };
+    if (m_commit) {
+        m_commit->add(entry);
+        m_resultQueued = true;
+        return target;
+    }
+
+    QString error;
+    if (!GroupCommit::commitNow(entry, &error)) {
+        fail(error);
+        return QString();
+    }
+    return target;
+}
+
+// ---------------------------------------------------------------------------
+// Архив папки
+
+// Упакованные файлы и опустевшие после них папки. Файлы, появившиеся
+// за время упаковки, остаются вместе со своими папками
+static void removePacked(const QString &root, const ArchiveIndex &index)
+{
+    QSet<QString> dirs;
+    for (const ArchiveEntry &entry : index.entries()) {
+        QFile::remove(root + QLatin1Char('/') + entry.path);
+        for (QString dir = QFileInfo(entry.path).path(); dir != QLatin1String("."); dir = QFileInfo(dir).path())
+            dirs.insert(dir);
+    }
+    // Вложенная папка длиннее своей родительской и удаляется раньше неё
+    QList<QString> ordered = dirs.values();
+    std::sort(ordered.begin(), ordered.end(), [](const QString &a, const QString &b) { return a.size() > b.size(); });
+    for (const QString &dir : std::as_const(ordered))
+        QDir(root).rmdir(dir);
+    QDir().rmdir(root);
+}
+
+QString FileProcessor::encryptDirectory(const QString &dirPath, AlgorithmId algorithm)
+{
+    DIPLOM_TRACE_SPAN_ARG("encrypt_directory", "file", "path", dirPath);
+
+    m_resultQueued = false;
+    m_archiveSize = 0;
+    const QString root = QDir::cleanPath(dirPath);
+    const QString outPath = root + extensionFor(algorithm);
+    if (!m_keepSource && QFile::exists(outPath)) {
+        fail(QStringLiteral("Файл уже существует: %1").arg(outPath));
+        return QString();
+    }
+
+    ArchiveIndex index;
+    if (!index.collect(root)) {
+        fail(index.errorString());
+        return QString();
+    }
+    m_archiveSize = index.streamSize();
+    if (m_queued)
+        m_queued->fetch_add(m_archiveSize, std::memory_order_relaxed);
+
+    const QString tempPath = GroupCommit::tempPathFor(outPath);
+    ArchiveStream stream(root, index);
+    QFile outFile(tempPath);
+    if (!stream.open(QIODevice::ReadOnly | QIODevice::Unbuffered) || !outFile.open(QIODevice::WriteOnly)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    bool ok = encryptContainer(stream, outFile, algorithm, ContainerHeader::FlagArchive);
+    outFile.close();
+    if (!ok) {
+        // Причина точнее общей «Ошибки чтения»: какой файл и что с ним
+        if (!stream.error().isEmpty())
+            fail(stream.error());
+        QFile::remove(tempPath);
+        DIPLOM_COUNT(FilesFailed, 1);
+        return QString();
+    }
+
+    // Фиксация сразу, не пачкой: исходные файлы удаляются только после
+    // того, как архив надёжно на месте. Папка GroupCommit не удаляет
+    QString error;
+    ok = GroupCommit::commitNow({ tempPath, outPath, QString(), m_keepSource }, &error);
+    if (!ok) {
+        fail(error);
+        return QString();
+    }
+    DIPLOM_COUNT(FilesDone, index.entries().size());
+    if (!m_keepSource)
+        removePacked(root, index);
+    return outPath;
+}
+
+// Архив распаковывается во временную папку рядом и фиксируется ею
+// целиком: после сбоя не остаётся наполовину распакованного дерева
+QString FileProcessor::extractArchive(const QString &filePath, const QString &outPath)
+{
+    const QString tempPath = GroupCommit::tempPathFor(outPath);
+    QFile inFile(filePath);
+    ArchiveSink sink(tempPath);
+    if (!inFile.open(QIODevice::ReadOnly) || !sink.open(QIODevice::WriteOnly | QIODevice::Unbuffered)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    bool ok = decryptStream(inFile, sink) && sink.finish();
+    // Причина от распаковки точнее общей «Ошибки записи»
+    if (!ok && !sink.error().isEmpty())
+        fail(sink.error());
+    inFile.close();
+    sink.close();
+    if (!ok) {
+        QDir(tempPath).removeRecursively();
+        DIPLOM_COUNT(FilesFailed, 1);
+        return QString();
+    }
+    return commitOutput(filePath, tempPath, outPath);
+}
+
+bool FileProcessor::openArchive(QFile &file, ContainerReader &reader, Keys *keys, ArchiveIndex *index)
+{
+    m_bytesRead = 0;
+    if (m_password.isEmpty())
+        return fail(QStringLiteral("Пароль не задан"));
+    if (!file.open(QIODevice::ReadOnly))
+        return fail(QStringLiteral("Не удалось открыть файл"));
+    if (!reader.readHeader())
+        return fail(reader.errorString());
+    if (!reader.header().isArchive())
+        return fail(QStringLiteral("Контейнер не архив: %1").arg(file.fileName()));
+
+    *keys = deriveKeys(reader.header().salt);
+
+    // Сначала длина оглавления, затем оно целиком
+    QBuffer head;
+    head.open(QIODevice::WriteOnly);
+    if (!readArchiveRange(reader, *keys, 0, ArchiveIndex::PrefixSize, head))
+        return false;
+    const quint64 size = ArchiveIndex::indexSize(head.data());
+    if (size == 0 || size > ArchiveIndex::MaxIndexSize)
+        return fail(QStringLiteral("Повреждено оглавление архива"));
+    if (!readArchiveRange(reader, *keys, ArchiveIndex::PrefixSize, size - ArchiveIndex::PrefixSize, head))
+        return false;
+    if (!index->parse(head.data()))
+        return fail(index->errorString());
+    return true;
+}
+
+bool FileProcessor::listArchive(const QString &archivePath, QVector<ArchiveEntry> *entries)
+{
+    QFile file(archivePath);
+    ContainerReader reader(&file);
+    Keys keys;
+    ArchiveIndex index;
+    if (!openArchive(file, reader, &keys, &index))
+        return false;
+    *entries = index.entries();
+    return true;
+}
+
+bool FileProcessor::extractFromArchive(const QString &archivePath, const QString &name, QIODevice &out)
+{
+    DIPLOM_TRACE_SPAN_ARG("extract_file", "file", "path", name);
+
+    QFile file(archivePath);
+    ContainerReader reader(&file);
+    Keys keys;
+    ArchiveIndex index;
+    if (!openArchive(file, reader, &keys, &index))
+        return false;
+    const ArchiveEntry *entry = index.find(name);
+    if (!entry)
+        return fail(QStringLiteral("В архиве нет файла: %1").arg(name));
+
+    // Данные файлов начинаются сразу за оглавлением
+    const quint64 dataStart = ArchiveIndex::indexSize(index.serialize());
+    return readArchiveRange(reader, keys, dataStart + entry->offset, entry->size, out);
+}
+
+bool FileProcessor::readArchiveRange(ContainerReader &reader, const Keys &keys, quint64 offset, quint64 length,
+                                     QIODevice &out)
+{
+    return withCipher(reader.header().algorithm, [&](auto tag) {
+        return readRange<typename decltype(tag)::Type>(reader, keys, offset, length, out);
+    });
+}
+
+// Диапазон открытого текста контейнера с записями одной длины: читаются
+// и проверяются только покрывающие его фрагменты, а расшифровывается
+// только нужная часть каждого
+template<typename Cipher>
+bool FileProcessor::readRange(ContainerReader &reader, const Keys &keys, quint64 offset, quint64 length,
+                              QIODevice &out)
+{
+    const Cipher cipher(keys.enc);
+    if (!cipher.isValid())
+        return fail(QStringLiteral("Не удалось установить ключ"));
+
+    const ContainerHeader &header = reader.header();
+    const ChunkMac<Cipher> mac(header.mac, keys.mac, streebog256(reader.headerBytes()));
+    const int blockSize = CipherTraits<Cipher>::BlockSize;
+
+    ContainerChunk chunk;
+    const quint64 first = offset / header.chunkSize;
+    if (length > 0 && !reader.seekChunk(first))
+        return fail(reader.errorString());
+    for (quint64 index = first; length > 0; ++index) {
+        {
+            DIPLOM_STAGE_TIMER(Read);
+            if (!reader.readChunk(chunk))
+                return fail(reader.errorString().isEmpty() ? QStringLiteral("Архив обрезан") : reader.errorString());
+        }
+        reportRead(header.recordSize(chunk.data.size()));
+        if (!chunkTagValid(cipher, header, mac, chunk))
+            return fail(QStringLiteral("%1 не совпадает: файл подделан или повреждён (фрагмент %2)")
+                            .arg(macTitle(header.mac)).arg(chunk.index));
+
+        const quint64 start = index * header.chunkSize;
+        const quint64 from = offset > start ? offset - start : 0;
+        if (from >= quint64(chunk.data.size()))
+            return fail(QStringLiteral("Архив обрезан"));
+        const qint64 size = qint64(qMin<quint64>(length, quint64(chunk.data.size()) - from));
+        // Гамма начинается с блока, в который попадает from
+        const quint64 skipBlocks = from / quint64(blockSize);
+        char *data = chunk.data.data() + skipBlocks * blockSize;
+        const qint64 span = qint64(from % quint64(blockSize)) + size;
+        openChunk(cipher, header, chunk, skipBlocks, data, span);
+        {
+            DIPLOM_STAGE_TIMER(Write);
+            if (out.write(data + (span - size), size) != size)
+                return fail(QStringLiteral("Ошибка записи"));
+        }
+        length -= quint64(size);
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Обновление пофрагментно
+
+QString FileProcessor::updateFile(const QString &filePath, AlgorithmId algorithm)
+{
+    DIPLOM_TRACE_SPAN_ARG("update_file", "file", "path", filePath);
+
+    m_bytesRead = 0;
+    m_resultQueued = false;
+    if (m_password.isEmpty()) {
+        fail(QStringLiteral("Пароль не задан"));
+        return QString();
+    }
+
+    const QString target = filePath + extensionFor(algorithm);
+    bool updatable = false;
+    {
+        // Пробное чтение не создаёт контейнер, если его нет
+        QFile probe(target);
+        ContainerReader reader(&probe);
+        updatable = probe.open(QIODevice::ReadOnly | QIODevice::ExistingOnly) && reader.readHeader()
+                 && reader.header().isDelta() && reader.header().algorithm == algorithm;
+    }
+    if (!updatable) {
+        // Обновлять нечего: контейнер создаётся заново, уже обновляемым,
+        // и заменяет прежний обычный
+        if (QFile::exists(InPlaceJournal::pathFor(filePath)))
+            return resumeInPlace(filePath);
+        const bool delta = m_delta;
+        m_delta = true;
+        const QString result = encryptTo(filePath, target, algorithm, true);
+        m_delta = delta;
+        return result;
+    }
+
+    QFile container(target);
+    ContainerReader reader(&container);
+    if (!container.open(QIODevice::ReadWrite | QIODevice::ExistingOnly) || !reader.readHeader()) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    QFile source(filePath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    const Keys keys = deriveKeys(reader.header().salt);
+    const QString marker = updateMarkerFor(target);
+    const bool ok = withCipher(algorithm, [&](auto tag) {
+        return updateChunks<typename decltype(tag)::Type>(source, container, reader, keys, marker);
+    });
+    source.close();
+    container.close();
+    // При ошибке метка остаётся: следующее обновление доведёт контейнер
+    if (!ok) {
+        DIPLOM_COUNT(FilesFailed, 1);
+        return QString();
+    }
+    if (QFile::exists(marker)) {
+        QFile::remove(marker);
+        GroupCommit::syncDirectory(QFileInfo(marker).path());
+    }
+    if (!m_keepSource)
+        QFile::remove(filePath);
+    DIPLOM_COUNT(FilesDone, 1);
+    return target;
+}
+
+template<typename Cipher>
+bool FileProcessor::updateChunks(QIODevice &in, QFile &container, ContainerReader &reader, const Keys &keys,
+                                 const QString &markerPath)
+{
+    const Cipher cipher(keys.enc);
+    if (!cipher.isValid())
+        return fail(QStringLiteral("Не удалось установить ключ"));
+
+    const ContainerHeader &header = reader.header();
+    const int headerSize = reader.headerBytes().size();
+    const ChunkMac<Cipher> mac(header.mac, keys.mac, streebog256(reader.headerBytes()));
+
+    // После прерванного обновления совпавший отпечаток ещё не значит,
+    // что шифртекст за ним дописан: такие фрагменты сверяются по имитовставке
+    quint64 generation = 0;
+    const bool interrupted = QFile::exists(markerPath);
+    if (interrupted) {
+        QFile marker(markerPath);
+        const QByteArray value = marker.open(QIODevice::ReadOnly) ? marker.read(8) : QByteArray();
+        if (value.size() == 8)
+            generation = qFromBigEndian<quint64>(value.constData());
+    }
+
+    // Читаются только поля фрагментов, без шифртекста
+    std::vector<QByteArray> fingerprints;
+    {
+        DIPLOM_STAGE_TIMER(Read);
+        ContainerChunk stored;
+        while (reader.readChunk(stored, false)) {
+            generation = qMax(generation, stored.generation);
+            fingerprints.push_back(stored.fingerprint);
+        }
+    }
+    // Оборванный конец после сбоя — просто фрагменты на перезапись
+    if (!reader.errorString().isEmpty() && !interrupted)
+        return fail(reader.errorString());
+    if (generation == std::numeric_limits<quint64>::max())
+        return fail(QStringLiteral("Исчерпаны поколения фрагментов"));
+    ++generation;
+
+    // Метка ставится перед первой записью; без изменений файл не трогается
+    bool marked = false;
+    auto mark = [&] {
+        if (marked)
+            return true;
+        QFile marker(markerPath);
+        QByteArray value(8, 0);
+        qToBigEndian<quint64>(generation, value.data());
+        marked = marker.open(QIODevice::WriteOnly) && marker.write(value) == value.size()
+              && GroupCommit::syncFile(marker) && GroupCommit::syncDirectory(QFileInfo(markerPath).path());
+        return marked || fail(QStringLiteral("Не удалось создать метку обновления"));
+    };
+    auto intact = [&](quint64 index) {
+        DIPLOM_STAGE_TIMER(Mac);
+        ContainerChunk stored;
+        return reader.seekChunk(index) && reader.readChunk(stored)
+            && equalTags(mac.tag(stored), stored.tag);
+    };
+
+    ContainerWriter writer(&container);
+    writer.resume(header, reader.headerBytes());
+    ContainerChunk chunk;
+    chunk.generation = generation;
+    for (;; ++chunk.index) {
+        DIPLOM_TRACE_SPAN_ARG("chunk", "chunk", "index", QString::number(chunk.index));
+        {
+            DIPLOM_STAGE_TIMER(Read);
+            if (!readFully(in, chunk.data, static_cast<int>(header.chunkSize)))
+                return fail(QStringLiteral("Ошибка чтения"));
+        }
+        reportRead(chunk.data.size());
+
+        const int plainSize = chunk.data.size();
+        chunk.last = plainSize < static_cast<int>(header.chunkSize);
+        {
+            DIPLOM_STAGE_TIMER(Mac);
+            chunk.fingerprint = chunkFingerprint(keys.fingerprint, chunk.index, chunk.last, chunk.data);
+        }
+        const bool same = chunk.index < fingerprints.size()
+                       && equalTags(fingerprints[size_t(chunk.index)], chunk.fingerprint);
+        if (same && (!interrupted || intact(chunk.index))) {
+            DIPLOM_COUNT(ChunksKept, 1);
+        } else {
+            {
+                DIPLOM_STAGE_TIMER(Cipher);
+                chunkGamma(cipher, header, generation, chunk.index, 0, chunk.data.data(), chunk.data.size());
+            }
+            {
+                DIPLOM_STAGE_TIMER(Mac);
+                chunk.tag = mac.tag(chunk);
+            }
+            if (!mark())
+                return false;
+            {
+                DIPLOM_STAGE_TIMER(Write);
+                if (!container.seek(header.chunkOffset(headerSize, chunk.index)) || !writer.writeChunk(chunk))
+                    return fail(QStringLiteral("Ошибка записи"));
+            }
+            countChunk(plainSize, CipherTraits<Cipher>::BlockSize, plainSize, header.recordSize(plainSize));
+        }
+        if (chunk.last)
+            break;
+    }
+
+    // Файл стал короче — лишние записи отрезаются
+    const qint64 end = header.chunkOffset(headerSize, chunk.index) + header.recordSize(chunk.data.size());
+    if (container.size() != end) {
+        DIPLOM_STAGE_TIMER(Write);
+        if (!mark() || !container.resize(end))
+            return fail(QStringLiteral("Ошибка записи"));
+    }
+    if (marked && !GroupCommit::syncFile(container))
+        return fail(QStringLiteral("Ошибка записи"));
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Работа «на месте»
+
+struct FileProcessor::InPlaceRun
+{
+    QString path;
+    QString target;
+    QFile file;
+    InPlaceJournal journal;
+    ContainerHeader header;
+    QByteArray headerBytes;
+    Keys keys;
+    quint64 dataSize = 0;
+    quint64 first = 0;          // первый необработанный фрагмент
+    bool encrypt = true;
+    QByteArray tags;
+
+    quint64 chunkCount() const { return InPlaceTrailer::chunkCount(dataSize, header.chunkSize); }
+    quint32 chunksPerWindow() const { return qMax<quint32>(1, InPlaceJournal::WindowSize / header.chunkSize); }
+    quint32 windowBytes() const { return chunksPerWindow() * header.chunkSize; }
+    // Длина данных фрагмента; последний — неполный, возможно пустой
+    int chunkLength(quint64 index) const
+    {
+        const quint64 offset = index * header.chunkSize;
+        return int(qMin<quint64>(header.chunkSize, dataSize - offset));
+    }
+};
+
+QString FileProcessor::encryptInPlace(const QString &filePath, AlgorithmId algorithm)
+{
+    DIPLOM_TRACE_SPAN_ARG("encrypt_in_place", "file", "path", filePath);
+
+    m_bytesRead = 0;
+    m_resultQueued = false;
+    if (QFile::exists(InPlaceJournal::pathFor(filePath)))
+        return resumeInPlace(filePath);
+    if (m_password.isEmpty()) {
+        fail(QStringLiteral("Пароль не задан"));
+        return QString();
+    }
+
+    InPlaceRun run;
+    run.path = filePath;
+    run.target = filePath + extensionFor(algorithm);
+    if (QFile::exists(run.target)) {
+        fail(QStringLiteral("Файл уже существует: %1").arg(run.target));
+        return QString();
+    }
+    run.file.setFileName(filePath);
+    if (!run.file.open(QIODevice::ReadWrite)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    run.header.algorithm = algorithm;
+    run.header.chunkSize = m_chunkSize;
+    run.header.flags = ContainerHeader::FlagInPlace;
+    run.header.salt = SecureRandom::bytes(ContainerHeader::SaltSize);
+    run.header.iv = SecureRandom::bytes(algorithmBlockSize(algorithm));
+    if (run.header.salt.isEmpty() || run.header.iv.isEmpty()) {
+        fail(QStringLiteral("Нет источника случайных чисел"));
+        return QString();
+    }
+    run.headerBytes = run.header.serialize();
+    run.dataSize = quint64(run.file.size());
+    if (run.chunkCount() > InPlaceTrailer::MaxChunks) {
+        fail(QStringLiteral("Файл слишком велик для фрагментов такого размера"));
+        return QString();
+    }
+    run.keys = deriveKeys(run.header.salt);
+
+    if (!run.journal.create(InPlaceJournal::pathFor(filePath), InPlaceJournal::Encrypt, run.dataSize,
+                            run.headerBytes, run.windowBytes())) {
+        fail(run.journal.errorString());
+        return QString();
+    }
+    return runInPlace(run) ? run.target : QString();
+}
+
+QString FileProcessor::decryptInPlace(const QString &filePath)
+{
+    DIPLOM_TRACE_SPAN_ARG("decrypt_in_place", "file", "path", filePath);
+
+    m_bytesRead = 0;
+    m_resultQueued = false;
+    if (QFile::exists(InPlaceJournal::pathFor(filePath)))
+        return resumeInPlace(filePath);
+    if (m_password.isEmpty()) {
+        fail(QStringLiteral("Пароль не задан"));
+        return QString();
+    }
+
+    const QFileInfo info(filePath);
+    if (!isEncryptedName(info.fileName())) {
+        fail(QStringLiteral("Файл не зашифрован"));
+        return QString();
+    }
+
+    InPlaceRun run;
+    run.path = filePath;
+    run.target = filePath.left(filePath.length() - 4);
+    run.encrypt = false;
+    if (QFile::exists(run.target)) {
+        fail(QStringLiteral("Файл уже существует: %1").arg(run.target));
+        return QString();
+    }
+    run.file.setFileName(filePath);
+    if (!run.file.open(QIODevice::ReadWrite)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    InPlaceTrailer trailer;
+    QString error;
+    if (!InPlaceTrailer::read(&run.file, trailer, &error)) {
+        fail(error.isEmpty() ? QStringLiteral("Файл зашифрован не на месте") : error);
+        return QString();
+    }
+    run.header = trailer.header;
+    run.headerBytes = trailer.headerBytes;
+    run.dataSize = trailer.dataSize;
+    run.tags = trailer.tags;
+    run.keys = deriveKeys(run.header.salt);
+
+    // Журнал создаётся после проверки всех имитовставок: подделанный
+    // файл остаётся нетронутым
+    const bool verified = withCipher(run.header.algorithm, [&](auto tag) {
+        return verifyInPlace<typename decltype(tag)::Type>(run);
+    });
+    if (!verified) {
+        DIPLOM_COUNT(FilesFailed, 1);
+        return QString();
+    }
+
+    if (!run.journal.create(InPlaceJournal::pathFor(filePath), InPlaceJournal::Decrypt, run.dataSize,
+                            run.headerBytes, run.windowBytes())) {
+        fail(run.journal.errorString());
+        return QString();
+    }
+    return runInPlace(run) ? run.target : QString();
+}
+
+QString FileProcessor::resumeInPlace(const QString &filePath)
+{
+    DIPLOM_TRACE_SPAN_ARG("resume_in_place", "file", "path", filePath);
+
+    m_bytesRead = 0;
+    m_resultQueued = false;
+    InPlaceRun run;
+    run.path = filePath;
+    if (!run.journal.open(InPlaceJournal::pathFor(filePath))) {
+        fail(run.journal.errorString());
+        return QString();
+    }
+    int consumed = 0;
+    if (!ContainerHeader::parse(run.journal.headerBytes(), run.header, &consumed)
+        || consumed != run.journal.headerBytes().size()) {
+        fail(QStringLiteral("Повреждён журнал: %1").arg(filePath));
+        return QString();
+    }
+    run.headerBytes = run.journal.headerBytes();
+    run.dataSize = run.journal.dataSize();
+    run.encrypt = run.journal.mode() == InPlaceJournal::Encrypt;
+    run.target = run.encrypt ? filePath + extensionFor(run.header.algorithm)
+                             : filePath.left(filePath.length() - 4);
+    run.first = run.journal.firstChunk();
+
+    // Сбой между переименованием и удалением журнала: всё уже сделано
+    if (!QFile::exists(filePath) && QFile::exists(run.target) && run.first >= run.chunkCount()) {
+        run.journal.remove();
+        return run.target;
+    }
+
+    run.file.setFileName(filePath);
+    if (!run.file.open(QIODevice::ReadWrite)) {
+        fail(QStringLiteral("Не удалось открыть файл"));
+        return QString();
+    }
+
+    // Окно, которое писалось при сбое, возвращается в прежний вид
+    run.keys = deriveKeys(run.header.salt);
+    const bool rolledBack = withCipher(run.header.algorithm, [&](auto tag) {
+        return rollBackInPlace<typename decltype(tag)::Type>(run);
+    });
+    if (!rolledBack)
+        return QString();
+
+    if (!run.encrypt && run.first < run.chunkCount()) {
+        // Хвост с имитовставками снимается только в самом конце
+        InPlaceTrailer trailer;
+        QString error;
+        if (!InPlaceTrailer::read(&run.file, trailer, &error) || trailer.headerBytes != run.headerBytes) {
+            fail(error.isEmpty() ? QStringLiteral("Повреждён хвост контейнера") : error);
+            return QString();
+        }
+        run.tags = trailer.tags;
+        const bool verified = withCipher(run.header.algorithm, [&](auto tag) {
+            return verifyInPlace<typename decltype(tag)::Type>(run);
+        });
+        if (!verified)
+            return QString();
+    }
+    return runInPlace(run) ? run.target : QString();
+}
+
+bool FileProcessor::runInPlace(InPlaceRun &run)
+{
+    bool ok = withCipher(run.header.algorithm, [&](auto tag) {
+        return processInPlace<typename decltype(tag)::Type>(run);
+    });
+    ok = ok && finishInPlace(run);
+    // Журнал остаётся: повторный вызов продолжит с места остановки
+    if (ok)
+        DIPLOM_COUNT(FilesDone, 1);
+    else
+        DIPLOM_COUNT(FilesFailed, 1);
+    return ok;
+}
+
+// Проверка имитовставок фрагментов с run.first до конца, без записи
+template<typename Cipher>
+bool FileProcessor::verifyInPlace(InPlaceRun &run)
+{
+    const QByteArray headerDigest = streebog256(run.headerBytes);
+    const quint64 count = run.chunkCount();
+    QByteArray data;
+    for (quint64 index = run.first; index < count; ++index) {
+        {
+            DIPLOM_STAGE_TIMER(Read);
+            if (!run.file.seek(qint64(index * run.header.chunkSize))
+                || !readFully(run.file, data, run.chunkLength(index)) || data.size() != run.chunkLength(index))
+                return fail(QStringLiteral("Ошибка чтения"));
+        }
+        DIPLOM_STAGE_TIMER(Mac);
+        const QByteArray expected = hmacStreebog(
+            chunkMacInput(headerDigest, index, chunkInfo(index + 1 == count, data.size())) + data, run.keys.mac);
+        if (!equalTags(expected, run.tags.mid(int(index * ContainerHeader::HmacTagSize), ContainerHeader::HmacTagSize)))
+            return fail(QStringLiteral("HMAC не совпадает: файл подделан или повреждён (фрагмент %1)").arg(index));
+    }
+    return true;
+}
+
+// Участки окна run.first, уже прошедшие гамму, снимают её той же гаммой:
+// после этого всё окно снова в состоянии «до»
+template<typename Cipher>
+bool FileProcessor::rollBackInPlace(InPlaceRun &run)
+{
+    const QVector<quint64> &before = run.journal.before();
+    const QVector<quint64> &after = run.journal.after();
+    if (before.isEmpty())
+        return true;
+
+    const Cipher cipher(run.keys.enc);
+    if (!cipher.isValid())
+        return fail(QStringLiteral("Не удалось установить ключ"));
+
+    const quint32 chunkSize = run.header.chunkSize;
+    const quint64 end = qMin<quint64>(run.chunkCount(), run.first + run.chunksPerWindow());
+    const quint64 offset = run.first * chunkSize;
+    if (run.first >= run.chunkCount() || offset > run.dataSize)
+        return fail(QStringLiteral("Повреждён журнал: %1").arg(run.path));
+    const int length = int(qMin<quint64>(run.dataSize, end * chunkSize) - offset);
+
+    QByteArray window;
+    if (!run.file.seek(qint64(offset)) || !readFully(run.file, window, length) || window.size() != length)
+        return fail(QStringLiteral("Ошибка чтения"));
+    const QVector<quint64> current = InPlaceJournal::unitDigests(window.constData(), window.size());
+    if (current.size() != before.size())
+        return fail(QStringLiteral("Повреждён журнал: %1").arg(run.path));
+
+    const quint64 firstBlock = offset / CipherTraits<Cipher>::BlockSize;
+    bool changed = false;
+    for (int unit = 0; unit < current.size(); ++unit) {
+        if (current[unit] == before[unit])
+            continue;
+        if (current[unit] != after[unit])
+            return fail(QStringLiteral("Файл повреждён при сбое и не может быть восстановлен: %1").arg(run.path));
+        const int at = unit * InPlaceJournal::UnitSize;
+        applyCTR(cipher, run.header.iv, firstBlock + quint64(at) / CipherTraits<Cipher>::BlockSize,
+                 window.data() + at, qMin(InPlaceJournal::UnitSize, window.size() - at));
+        changed = true;
+    }
+    if (changed
+        && (!run.file.seek(qint64(offset)) || run.file.write(window) != window.size()
+            || !GroupCommit::syncFile(run.file)))
+        return fail(QStringLiteral("Ошибка записи"));
+    return true;
+}
+
+template<typename Cipher>
+bool FileProcessor::processInPlace(InPlaceRun &run)
+{
+    const Cipher cipher(run.keys.enc);
+    if (!cipher.isValid())
+        return fail(QStringLiteral("Не удалось установить ключ"));
+
+    const quint32 chunkSize = run.header.chunkSize;
+    const quint64 blocksPerChunk = chunkSize / CipherTraits<Cipher>::BlockSize;
+    const quint64 count = run.chunkCount();
+    const QByteArray headerDigest = streebog256(run.headerBytes);
+    if (count > InPlaceTrailer::MaxChunks)
+        return fail(QStringLiteral("Файл слишком велик для фрагментов такого размера"));
+
+    auto tagChunk = [&](quint64 index, const char *data, int size) {
+        DIPLOM_STAGE_TIMER(Mac);
+        const QByteArray tag = hmacStreebog(
+            chunkMacInput(headerDigest, index, chunkInfo(index + 1 == count, size)) + QByteArray(data, size),
+            run.keys.mac);
+        memcpy(run.tags.data() + index * ContainerHeader::HmacTagSize, tag.constData(), ContainerHeader::HmacTagSize);
+    };
+
+    QByteArray window;
+    if (run.encrypt) {
+        // После сбоя имитовставки готовых фрагментов считаются заново
+        // по уже записанному шифртексту
+        run.tags = QByteArray(int(count * ContainerHeader::HmacTagSize), 0);
+        for (quint64 index = 0; index < qMin(run.first, count); ++index) {
+            if (!run.file.seek(qint64(index * chunkSize)) || !readFully(run.file, window, run.chunkLength(index)))
+                return fail(QStringLiteral("Ошибка чтения"));
+            tagChunk(index, window.constData(), window.size());
+        }
+    }
+
+    for (quint64 first = run.first; first < count; first += run.chunksPerWindow()) {
+        const quint64 end = qMin<quint64>(count, first + run.chunksPerWindow());
+        const quint64 offset = first * chunkSize;
+        const int length = int(qMin<quint64>(run.dataSize, end * chunkSize) - offset);
+        DIPLOM_TRACE_SPAN_ARG("window", "chunk", "first", QString::number(first));
+
+        {
+            DIPLOM_STAGE_TIMER(Read);
+            if (!run.file.seek(qint64(offset)) || !readFully(run.file, window, length) || window.size() != length)
+                return fail(QStringLiteral("Ошибка чтения"));
+        }
+        reportRead(quint64(length));
+
+        // Фрагменты окна идут подряд, и счётчик CTR непрерывен через них.
+        // В журнал — только дайджесты участков: само окно пишется один раз
+        const QVector<quint64> before = InPlaceJournal::unitDigests(window.constData(), window.size());
+        {
+            DIPLOM_STAGE_TIMER(Cipher);
+            applyCTR(cipher, run.header.iv, first * blocksPerChunk, window.data(), window.size());
+        }
+        {
+            DIPLOM_STAGE_TIMER(Write);
+            if (!run.journal.record(first, before, InPlaceJournal::unitDigests(window.constData(), window.size())))
+                return fail(run.journal.errorString());
+        }
+        for (quint64 index = first; index < end; ++index) {
+            const int at = int((index - first) * chunkSize);
+            const int size = run.chunkLength(index);
+            if (run.encrypt)
+                tagChunk(index, window.constData() + at, size);
+            countChunk(size, CipherTraits<Cipher>::BlockSize, size, size);
+        }
+
+        {
+            DIPLOM_STAGE_TIMER(Write);
+            if (!run.file.seek(qint64(offset)) || run.file.write(window) != window.size()
+                || !GroupCommit::syncFile(run.file))
+                return fail(QStringLiteral("Ошибка записи"));
+        }
+    }
+
+    // Все фрагменты готовы; дальше только хвост и имя
+    if (run.first < count) {
+        if (!run.journal.record(count, QVector<quint64>(), QVector<quint64>()))
+            return fail(run.journal.errorString());
+        run.first = count;
+    }
+    return true;
+}
+
+bool FileProcessor::finishInPlace(InPlaceRun &run)
+{
+    DIPLOM_STAGE_TIMER(Write);
+
+    // Хвост мог быть дописан частично до сбоя — файл обрезается до данных
+    if (run.encrypt) {
+        InPlaceTrailer trailer;
+        trailer.header = run.header;
+        trailer.headerBytes = run.headerBytes;
+        trailer.dataSize = run.dataSize;
+        trailer.tags = run.tags;
+        const QByteArray tail = trailer.serialize();
+        if (!run.file.resize(qint64(run.dataSize)) || !run.file.seek(qint64(run.dataSize))
+            || run.file.write(tail) != tail.size())
+            return fail(QStringLiteral("Ошибка записи"));
+        DIPLOM_COUNT(BytesOut, tail.size());
+    } else {
+        const qint64 tail = run.file.size() - qint64(run.dataSize);
+        if (tail > 0)
+            reportRead(quint64(tail));
+        if (!run.file.resize(qint64(run.dataSize)))
+            return fail(QStringLiteral("Ошибка записи"));
+    }
+    if (!GroupCommit::syncFile(run.file))
+        return fail(QStringLiteral("Ошибка записи"));
+    run.file.close();
+
+    if (QFile::exists(run.target) || !QFile::rename(run.path, run.target))
+        return fail(QStringLiteral("Не удалось сохранить результат: %1").arg(run.target));
+    GroupCommit::syncDirectory(QFileInfo(run.target).path());
+    run.journal.remove();
+    return true;
+}
@@ -0,0 +1,167 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/fileprocessor.h — потоковое шифрование/расшифрование файлов
+#ifndef FILEPROCESSOR_H
+#define FILEPROCESSOR_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "archive.h"
+#include "container.h"
+
+#include <atomic>
+
+class QFile;
+class QIODevice;
+class GroupCommit;
+
+class FileProcessor
+{
+public:
+    static constexpr int DefaultKdfIterations = 1000;
+
+    explicit FileProcessor(const QString &password);
+
+    // Зашифровать файл рядом с исходным (file → file.kuz / file.mag),
+    // исходный удаляется. Возвращает путь результата или пустую строку.
+    // Результат пишется во временный файл и фиксируется через GroupCommit:
+    // сразу, если очередь фиксации не задана, иначе — её пачкой.
+    QString encryptFile(const QString &filePath, AlgorithmId algorithm);
+    // Расшифровать .kuz / .mag; алгоритм берётся из заголовка.
+    // Контейнер «на месте» расшифровывается на месте, архив — в папку.
+    QString decryptFile(const QString &filePath);
+
+    // Упаковать папку в один архив рядом с ней (dir → dir.kuz / dir.mag,
+    // core/archive.h). Упакованные файлы и опустевшие папки удаляются
+    // после фиксации архива, если не задан setKeepSource(true).
+    QString encryptDirectory(const QString &dirPath, AlgorithmId algorithm);
+    // Оглавление архива и один файл из него: расшифровываются только
+    // фрагменты оглавления и этого файла
+    bool listArchive(const QString &archivePath, QVector<ArchiveEntry> *entries);
+    bool extractFromArchive(const QString &archivePath, const QString &name, QIODevice &out);
+
+    // Шифрование «на месте»: данные перезаписываются в том же файле,
+    // заголовок и имитовставки дописываются в конец, затем файл
+    // переименовывается. Свободного места нужно на хвост, а не на копию.
+    // Прерванная работа продолжается по журналу при следующем вызове
+    // любой из операций над тем же файлом.
+    QString encryptInPlace(const QString &filePath, AlgorithmId algorithm);
+    QString decryptInPlace(const QString &filePath);
+    QString resumeInPlace(const QString &filePath);
+
+    // Обновить обновляемый контейнер рядом с исходным (FlagDelta): заново
+    // шифруются и пишутся на место только фрагменты, чей отпечаток
+    // разошёлся с исходным файлом, остальные записи не трогаются. Нет
+    // контейнера или он обычный — файл шифруется заново, уже обновляемым,
+    // и заменяет прежний. Исходный не удаляется только при setKeepSource(true).
+    QString updateFile(const QString &filePath, AlgorithmId algorithm);
+
+    // Потоковые операции: память — O(размер фрагмента) при любом размере файла.
+    // Расшифрованные данные пишутся только после проверки имитовставки фрагмента.
+    // Фрагменты, целиком лежащие в дырах разреженного входного файла,
+    // не читаются и не шифруются; при расшифровании в файл дыры
+    // восстанавливаются.
+    bool encryptStream(QIODevice &in, QIODevice &out, AlgorithmId algorithm);
+    bool decryptStream(QIODevice &in, QIODevice &out);
+
+    void setKdfIterations(int iterations) { m_kdfIterations = iterations; }
+    void setChunkSize(quint32 chunkSize) { m_chunkSize = chunkSize; }
+    // Кодек сжатия фрагментов перед шифрованием (core/compression.h);
+    // работа «на месте» всегда без сжатия — ей нужна та же длина
+    void setCompression(CompressionId codec) { m_compression = codec; }
+    // Имитовставка новых контейнеров: HMAC-Стрибог или CMAC (crypto/cmac.h)
+    // после CTR, или MGM за один проход (crypto/mgm.h). «На месте» — всегда
+    // HMAC, обновляемые с MGM — тоже HMAC
+    void setMac(MacId mac) { m_mac = mac; }
+    // Новые контейнеры — обновляемые (FlagDelta): с отпечатками фрагментов
+    // для updateFile, без сжатия и дыр
+    void setDelta(bool delta) { m_delta = delta; }
+    // Счётчик, к которому по мере чтения прибавляются байты входа:
+    // ход большого файла виден, не дожидаясь его конца
+    void setProgressCounter(std::atomic<quint64> *counter) { m_progress = counter; }
+    // Счётчик объёма входа: размер архива папки известен только после
+    // сбора оглавления, и encryptDirectory прибавляет его сюда сам
+    void setQueuedCounter(std::atomic<quint64> *counter) { m_queued = counter; }
+    // Очередь фиксации: файл считается готовым, когда её обработчик
+    // получит его без ошибки
+    void setGroupCommit(GroupCommit *commit) { m_commit = commit; }
+    // Исходный файл не удалять, а прежний результат заменить новым
+    // (повторный прогон по описи, core/manifest.h)
+    void setKeepSource(bool keep) { m_keepSource = keep; }
+    // Байт входа, прочитанных последней операцией
+    quint64 bytesRead() const { return m_bytesRead; }
+    // Открытый текст последнего архива папки; 0 — оглавление не собрано
+    quint64 archiveSize() const { return m_archiveSize; }
+    // Результат последней операции ждёт в очереди фиксации, а не на месте
+    bool resultQueued() const { return m_resultQueued; }
+    QString errorString() const { return m_error; }
+
+    static QString extensionFor(AlgorithmId algorithm);
+    // Имя с расширением контейнера (.kuz / .mag)
+    static bool isEncryptedName(const QString &fileName);
+    // Временный файл, журнал или метка незавершённой операции
+    static bool isServiceName(const QString &fileName);
+    // "Кузнечик" / "Магма" из интерфейса → идентификатор алгоритма
+    static bool algorithmFromName(const QString &name, AlgorithmId *algorithm);
+
+private:
+    struct Keys {
+        QByteArray enc;
+        QByteArray mac;
+        QByteArray fingerprint;
+    };
+    struct InPlaceRun;
+
+    Keys deriveKeys(const QByteArray &salt) const;
+    bool fail(const QString &error);
+    void reportRead(quint64 bytes);
+    QString encryptTo(const QString &filePath, const QString &outPath, AlgorithmId algorithm, bool replace = false);
+    QString commitOutput(const QString &source, const QString &temp, const QString &target, bool replace = false);
+    bool skipHole(QIODevice &out, qint64 &size, bool atEnd);
+    bool encryptContainer(QIODevice &in, QIODevice &out, AlgorithmId algorithm, quint8 flags);
+    QString extractArchive(const QString &filePath, const QString &outPath);
+    bool openArchive(QFile &file, ContainerReader &reader, Keys *keys, ArchiveIndex *index);
+    bool readArchiveRange(ContainerReader &reader, const Keys &keys, quint64 offset, quint64 length, QIODevice &out);
+
+    template<typename Cipher>
+    bool encryptChunks(QIODevice &in, ContainerWriter &writer, const ContainerHeader &header, const Keys &keys);
+    template<typename Cipher>
+    bool decryptChunks(ContainerReader &reader, QIODevice &out, const Keys &keys);
+    template<typename Cipher>
+    bool readRange(ContainerReader &reader, const Keys &keys, quint64 offset, quint64 length, QIODevice &out);
+    template<typename Cipher>
+    bool updateChunks(QIODevice &in, QFile &container, ContainerReader &reader, const Keys &keys,
+                      const QString &markerPath);
+    template<typename Cipher>
+    bool verifyInPlace(InPlaceRun &run);
+    template<typename Cipher>
+    bool rollBackInPlace(InPlaceRun &run);
+    template<typename Cipher>
+    bool processInPlace(InPlaceRun &run);
+    bool runInPlace(InPlaceRun &run);
+    bool finishInPlace(InPlaceRun &run);
+
+    QByteArray m_password;
+    int m_kdfIterations = DefaultKdfIterations;
+    quint32 m_chunkSize = ContainerHeader::DefaultChunkSize;
+    CompressionId m_compression = CompressionId::None;
+    MacId m_mac = MacId::HmacStreebog256;
+    bool m_delta = false;
+    QString m_error;
+    std::atomic<quint64> *m_progress = nullptr;
+    std::atomic<quint64> *m_queued = nullptr;
+    GroupCommit *m_commit = nullptr;
+    quint64 m_bytesRead = 0;
+    quint64 m_archiveSize = 0;
+    bool m_resultQueued = false;
+    bool m_keepSource = false;
+};
+
+#endif // FILEPROCESSOR_H
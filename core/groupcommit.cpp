@@ -0,0 +1,341 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/groupcommit.cpp
+#include "groupcommit.h"
+#include "trace.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QtGlobal>
+#include <chrono>
+#include <iterator>
+#include <utility>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#elif defined(Q_OS_WIN)
+#include <io.h>
+#include <windows.h>
+#endif
+
+namespace {
+
+const char TempSuffix[] = ".diplom-part";
+
+// С этого размера пачки один syncfs дешевле fsync каждого файла
+constexpr size_t SyncfsThreshold = 16;
+
+QString parentOf(const QString &path)
+{
+    return QFileInfo(path).path();
+}
+
+// Переименование с заменой существующего файла, атомарное там, где ОС умеет
+bool renameOver(const QString &from, const QString &to)
+{
+#if defined(Q_OS_UNIX)
+    return ::rename(QFile::encodeName(from).constData(), QFile::encodeName(to).constData()) == 0;
+#elif defined(Q_OS_WIN)
+    return ::MoveFileExW(reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(from).utf16()),
+                         reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(to).utf16()),
+                         MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    QFile::remove(to);
+    return QFile::rename(from, to);
+#endif
+}
+
+// Новое имя без замены; временный результат бывает и каталогом
+// (распакованный архив)
+bool renameNew(const QString &from, const QString &to)
+{
+    if (QFile::exists(to))
+        return false;
+    return QFileInfo(from).isDir() ? QDir().rename(from, to) : QFile::rename(from, to);
+}
+
+void removeTemp(const QString &temp)
+{
+    if (QFileInfo(temp).isDir())
+        QDir(temp).removeRecursively();
+    else
+        QFile::remove(temp);
+}
+
+#if defined(Q_OS_UNIX)
+
+bool syncPath(const QString &path, int flags)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), flags);
+    if (fd < 0)
+        return false;
+    const bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+#if defined(Q_OS_LINUX)
+// Вся файловая система, на которой лежит path
+bool syncFilesystem(const QString &path)
+{
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+        return false;
+    const bool ok = ::syncfs(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+#endif
+
+// Каталог целиком: на Linux — один syncfs, иначе файл за файлом
+bool syncTree(const QString &dir)
+{
+#if defined(Q_OS_LINUX)
+    return syncFilesystem(dir);
+#else
+    bool ok = true;
+    QDirIterator it(dir, QDir::Files | QDir::Dirs | QDir::Hidden | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        ok = syncPath(path, it.fileInfo().isDir() ? O_RDONLY | O_DIRECTORY : O_RDONLY) && ok;
+    }
+    return syncPath(dir, O_RDONLY | O_DIRECTORY) && ok;
+#endif
+}
+
+// Данные временных файлов — на диск; synced[i] — удалось ли для entries[i]
+std::vector<bool> syncData(const std::vector<const GroupCommit::Entry *> &entries)
+{
+    std::vector<bool> synced(entries.size(), false);
+#if defined(Q_OS_LINUX)
+    if (entries.size() >= SyncfsThreshold) {
+        // Один syncfs на файловую систему вместо fsync на файл; сбой
+        // syncfs — сбой всех файлов на ней
+        QHash<quint64, bool> devices;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const QString dir = parentOf(entries[i]->temp);
+            struct stat st;
+            if (::stat(QFile::encodeName(dir).constData(), &st) != 0)
+                continue;
+            const quint64 device = quint64(st.st_dev);
+            if (!devices.contains(device))
+                devices.insert(device, syncFilesystem(dir));
+            synced[i] = devices.value(device);
+        }
+        return synced;
+    }
+#endif
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const QString &temp = entries[i]->temp;
+        synced[i] = QFileInfo(temp).isDir() ? syncTree(temp) : syncPath(temp, O_RDONLY);
+    }
+    return synced;
+}
+
+// Новые имена в каталогах — на диск, по разу на каталог; возвращает
+// каталоги, которые сбросить не удалось
+QSet<QString> syncDirectories(const QSet<QString> &dirs)
+{
+    QSet<QString> failed;
+    for (const QString &dir : dirs) {
+        if (!syncPath(dir, O_RDONLY | O_DIRECTORY))
+            failed.insert(dir);
+    }
+    return failed;
+}
+
+#else
+
+std::vector<bool> syncData(const std::vector<const GroupCommit::Entry *> &entries)
+{
+#if defined(Q_OS_WIN)
+    std::vector<bool> synced(entries.size(), false);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        QFile file(entries[i]->temp);
+        synced[i] = file.open(QIODevice::ReadWrite) && ::_commit(file.handle()) == 0;
+    }
+    return synced;
+#else
+    return std::vector<bool>(entries.size(), true);
+#endif
+}
+
+// Переименование в NTFS журналируется самой файловой системой
+QSet<QString> syncDirectories(const QSet<QString> &)
+{
+    return QSet<QString>();
+}
+
+#endif
+
+} // namespace
+
+GroupCommit::GroupCommit(Callback done, int batchSize, int delayMs)
+    : m_done(std::move(done))
+    , m_batchSize(size_t(qMax(1, batchSize)))
+    , m_delayMs(qMax(1, delayMs))
+{
+    m_thread = std::thread(&GroupCommit::run, this);
+}
+
+GroupCommit::~GroupCommit()
+{
+    finish();
+}
+
+void GroupCommit::add(Entry entry)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    // Очередь ограничена: при медленном диске притормаживают рабочие потоки
+    m_space.wait(lock, [this] { return m_pending.size() < 4 * m_batchSize; });
+    m_pending.push_back(std::move(entry));
+    if (m_pending.size() >= m_batchSize)
+        m_wake.notify_one();
+}
+
+void GroupCommit::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void GroupCommit::run()
+{
+    Trace::setThreadName(QStringLiteral("commit"));
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        // Пачка уходит, когда набралась или когда истекла пауза
+        m_wake.wait_for(lock, std::chrono::milliseconds(m_delayMs), [this] {
+            return m_stopping || m_pending.size() >= m_batchSize;
+        });
+        if (m_pending.empty()) {
+            if (m_stopping)
+                return;
+            continue;
+        }
+
+        // Не больше batchSize за раз: пачка не растёт, пока идёт фиксация
+        std::vector<Entry> batch;
+        if (m_pending.size() <= m_batchSize) {
+            batch.swap(m_pending);
+        } else {
+            const auto end = m_pending.begin() + std::ptrdiff_t(m_batchSize);
+            batch.assign(std::make_move_iterator(m_pending.begin()), std::make_move_iterator(end));
+            m_pending.erase(m_pending.begin(), end);
+        }
+        lock.unlock();
+        m_space.notify_all();
+
+        commitBatch(batch, m_done);
+        m_batches.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
+
+void GroupCommit::commitBatch(const std::vector<Entry> &batch, const Callback &done)
+{
+    DIPLOM_TRACE_SPAN_ARG("group_commit", "commit", "files", QString::number(batch.size()));
+
+    std::vector<const Entry *> entries;
+    entries.reserve(batch.size());
+    for (const Entry &entry : batch)
+        entries.push_back(&entry);
+    const std::vector<bool> synced = syncData(entries);
+
+    // Несброшенный результат не переименовывается: исходный остаётся.
+    // QFile::rename не заменяет существующий файл; замена — только для keep
+    std::vector<const Entry *> renamed;
+    renamed.reserve(batch.size());
+    QSet<QString> dirs;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Entry &entry = *entries[i];
+        if (!synced[i]) {
+            removeTemp(entry.temp);
+            done(entry, QStringLiteral("Не удалось сбросить результат на диск: %1").arg(entry.target));
+            continue;
+        }
+        const bool moved = entry.keep || entry.replace ? renameOver(entry.temp, entry.target) : renameNew(entry.temp, entry.target);
+        if (!moved) {
+            removeTemp(entry.temp);
+            done(entry, QStringLiteral("Не удалось сохранить результат: %1").arg(entry.target));
+            continue;
+        }
+        renamed.push_back(&entry);
+        dirs.insert(parentOf(entry.target));
+    }
+    const QSet<QString> unsynced = syncDirectories(dirs);
+
+    // Новое имя могло не попасть на диск: исходный файл остаётся второй копией
+    for (const Entry *entry : renamed) {
+        if (unsynced.contains(parentOf(entry->target))) {
+            done(*entry, QStringLiteral("Не удалось сбросить каталог на диск: %1").arg(parentOf(entry->target)));
+            continue;
+        }
+        if (!entry->keep)
+            QFile::remove(entry->source);
+        done(*entry, QString());
+    }
+}
+
+bool GroupCommit::commitNow(const Entry &entry, QString *error)
+{
+    bool ok = false;
+    commitBatch({ entry }, [&](const Entry &, const QString &message) {
+        ok = message.isEmpty();
+        if (error)
+            *error = message;
+    });
+    return ok;
+}
+
+QString GroupCommit::tempPathFor(const QString &target)
+{
+    const QFileInfo info(target);
+    return info.path() + QStringLiteral("/.") + info.fileName() + QLatin1String(TempSuffix);
+}
+
+bool GroupCommit::isTempName(const QString &fileName)
+{
+    return fileName.endsWith(QLatin1String(TempSuffix));
+}
+
+bool GroupCommit::syncFile(QFile &file)
+{
+    if (!file.flush())
+        return false;
+#if defined(Q_OS_UNIX)
+    return ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+    return ::_commit(file.handle()) == 0;
+#else
+    return true;
+#endif
+}
+
+bool GroupCommit::syncDirectory(const QString &dir)
+{
+#if defined(Q_OS_UNIX)
+    return syncPath(dir, O_RDONLY | O_DIRECTORY);
+#else
+    Q_UNUSED(dir);
+    return true;
+#endif
+}
@@ -0,0 +1,104 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/groupcommit.h — надёжная фиксация результатов пачками
+//
+// Результат пишется во временный файл рядом с целевым. Фиксация:
+//   1. данные временных файлов сбрасываются на диск;
+//   2. временные файлы переименовываются в целевые (без замены);
+//   3. каталоги с новыми именами сбрасываются на диск;
+//   4. только после этого удаляются исходные файлы.
+// При сбое на любом шаге на диске остаётся хотя бы одна целая копия:
+// исходный файл или уже зафиксированный результат. Если не удался сброс
+// на шаге 1 или 3, исходный файл остаётся, а запись завершается ошибкой.
+//
+// fsync на каждый файл упирает поток мелких файлов в задержку диска,
+// поэтому файлы копятся в пачку, а для большой пачки данные сбрасываются
+// одним syncfs на файловую систему (Linux). Пачки фиксирует отдельный
+// поток: рабочие потоки не ждут диска, пока очередь не переполнена.
+//
+// Запись с keep (повторный прогон по описи, core/manifest.h) заменяет
+// прежний результат атомарным переименованием поверх и исходный не трогает.
+// Запись с replace заменяет прежний результат так же, но исходный удаляет.
+// Временным результатом может быть и каталог (распакованный архив,
+// core/archive.h): он сбрасывается на диск целиком и переименовывается так же.
+//
+// Удаление исходных файлов отдельно не сбрасывается: если оно потеряется
+// при сбое, рядом с результатом окажется исходный файл — лишняя, но целая
+// копия.
+#ifndef GROUPCOMMIT_H
+#define GROUPCOMMIT_H
+
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class QFile;
+
+class GroupCommit
+{
+public:
+    struct Entry {
+        QString temp;       // записанный и закрытый временный файл
+        QString target;     // итоговое имя
+        QString source;     // удаляется после фиксации
+        bool keep = false;  // исходный остаётся, прежний результат заменяется
+        bool replace = false;   // прежний результат заменяется и без keep
+    };
+    // error пуст при успехе; вызывается из потока фиксации
+    using Callback = std::function<void(const Entry &entry, const QString &error)>;
+
+    static constexpr int DefaultBatchSize = 256;
+    static constexpr int DefaultDelayMs = 50;
+
+    explicit GroupCommit(Callback done, int batchSize = DefaultBatchSize, int delayMs = DefaultDelayMs);
+    ~GroupCommit();
+
+    GroupCommit(const GroupCommit &) = delete;
+    GroupCommit &operator=(const GroupCommit &) = delete;
+
+    // Поставить файл в очередь; ждёт, только если очередь переполнена
+    void add(Entry entry);
+    // Зафиксировать всё поставленное и остановить поток фиксации
+    void finish();
+
+    quint64 batchCount() const { return m_batches.load(std::memory_order_relaxed); }
+
+    // Фиксация одного файла в вызывающем потоке
+    static bool commitNow(const Entry &entry, QString *error);
+    // Имя временного файла для target: скрытое, рядом с ним
+    static QString tempPathFor(const QString &target);
+    static bool isTempName(const QString &fileName);
+
+    // Сброс на диск открытого файла и записей каталога; там, где ОС
+    // не даёт такой операции, — true без действий
+    static bool syncFile(QFile &file);
+    static bool syncDirectory(const QString &dir);
+
+private:
+    void run();
+    static void commitBatch(const std::vector<Entry> &batch, const Callback &done);
+
+    Callback m_done;
+    const size_t m_batchSize;
+    const int m_delayMs;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;     // поток фиксации
+    std::condition_variable m_space;    // ожидающие в add()
+    std::vector<Entry> m_pending;
+    bool m_stopping = false;
+    std::atomic<quint64> m_batches{0};
+    std::thread m_thread;
+};
+
+#endif // GROUPCOMMIT_H
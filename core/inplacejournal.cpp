@@ -0,0 +1,227 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/inplacejournal.cpp
+#include "inplacejournal.h"
+#include "groupcommit.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+const char JournalMagic[8] = { 'G', 'O', 'S', 'T', 'W', 'A', 'L', '2' };
+const char JournalSuffix[] = ".diplom-journal";
+constexpr int PrologFixed = 28;
+constexpr int SlotFixed = 20;
+constexpr int SumSize = 8;
+constexpr int DigestPairSize = 16;
+
+// FNV-1a: журнал защищается не от подделки, а от оборванной записи
+quint64 checksum(const char *data, qint64 size)
+{
+    quint64 hash = 14695981039346656037ull;
+    for (qint64 i = 0; i < size; ++i) {
+        hash ^= static_cast<uchar>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void appendSum(QByteArray &data)
+{
+    QByteArray sum(SumSize, 0);
+    qToBigEndian<quint64>(checksum(data.constData(), data.size()), sum.data());
+    data.append(sum);
+}
+
+// Наибольшее число участков в окне из windowBytes байт
+qint64 unitsFor(quint32 windowBytes)
+{
+    return (qint64(windowBytes) + InPlaceJournal::UnitSize - 1) / InPlaceJournal::UnitSize;
+}
+
+bool sumMatches(const QByteArray &data)
+{
+    if (data.size() < SumSize)
+        return false;
+    const qint64 body = data.size() - SumSize;
+    return qFromBigEndian<quint64>(data.constData() + body) == checksum(data.constData(), body);
+}
+
+} // namespace
+
+QString InPlaceJournal::pathFor(const QString &filePath)
+{
+    const QFileInfo info(filePath);
+    return info.path() + QStringLiteral("/.") + info.fileName() + QLatin1String(JournalSuffix);
+}
+
+bool InPlaceJournal::isJournalName(const QString &fileName)
+{
+    return fileName.endsWith(QLatin1String(JournalSuffix));
+}
+
+// Словами по 8 байт: дайджест различает лишь прежнее и новое содержимое
+// участка, поэтому стойкость не нужна, а скорость — сравнима с гаммой
+QVector<quint64> InPlaceJournal::unitDigests(const char *data, qint64 size)
+{
+    QVector<quint64> digests;
+    digests.reserve(int((size + UnitSize - 1) / UnitSize));
+    for (qint64 offset = 0; offset < size; offset += UnitSize) {
+        const qint64 length = qMin<qint64>(UnitSize, size - offset);
+        const char *p = data + offset;
+        quint64 hash = 14695981039346656037ull ^ quint64(length);
+        qint64 i = 0;
+        for (; i + 8 <= length; i += 8) {
+            quint64 word;
+            memcpy(&word, p + i, 8);
+            hash = (hash ^ word) * 1099511628211ull;
+            hash ^= hash >> 29;
+        }
+        for (; i < length; ++i)
+            hash = (hash ^ static_cast<uchar>(p[i])) * 1099511628211ull;
+        hash ^= hash >> 32;
+        digests.append(hash);
+    }
+    return digests;
+}
+
+bool InPlaceJournal::fail(const QString &error)
+{
+    m_error = error;
+    return false;
+}
+
+bool InPlaceJournal::create(const QString &path, Mode mode, quint64 dataSize, const QByteArray &headerBytes,
+                            quint32 windowBytes)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::NewOnly))
+        return fail(QStringLiteral("Не удалось создать журнал: %1").arg(path));
+
+    QByteArray prolog(PrologFixed, 0);
+    uchar *p = reinterpret_cast<uchar *>(prolog.data());
+    memcpy(p, JournalMagic, sizeof(JournalMagic));
+    p[8] = mode;
+    qToBigEndian<quint64>(dataSize, p + 12);
+    qToBigEndian<quint32>(windowBytes, p + 20);
+    qToBigEndian<quint32>(static_cast<quint32>(headerBytes.size()), p + 24);
+    prolog.append(headerBytes);
+    appendSum(prolog);
+
+    m_mode = mode;
+    m_dataSize = dataSize;
+    m_headerBytes = headerBytes;
+    m_prologSize = prolog.size();
+    m_slotSize = SlotFixed + unitsFor(windowBytes) * DigestPairSize + SumSize;
+    m_sequence = 0;
+    m_firstChunk = 0;
+    m_before.clear();
+    m_after.clear();
+
+    // Сам журнал должен пережить сбой раньше, чем тронут файл
+    if (m_file.write(prolog) != prolog.size() || !GroupCommit::syncFile(m_file)
+        || !GroupCommit::syncDirectory(QFileInfo(path).path()))
+        return fail(QStringLiteral("Ошибка записи журнала"));
+    return true;
+}
+
+bool InPlaceJournal::open(const QString &path)
+{
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite))
+        return fail(QStringLiteral("Не удалось открыть журнал: %1").arg(path));
+
+    QByteArray prolog = m_file.read(PrologFixed);
+    if (prolog.size() != PrologFixed || memcmp(prolog.constData(), JournalMagic, sizeof(JournalMagic)) != 0)
+        return fail(QStringLiteral("Повреждён журнал: %1").arg(path));
+    const uchar *p = reinterpret_cast<const uchar *>(prolog.constData());
+    const quint8 mode = p[8];
+    const quint64 dataSize = qFromBigEndian<quint64>(p + 12);
+    const quint32 windowBytes = qFromBigEndian<quint32>(p + 20);
+    const quint32 headerSize = qFromBigEndian<quint32>(p + 24);
+    if ((mode != Encrypt && mode != Decrypt) || headerSize > 4096 || windowBytes > (1u << 30))
+        return fail(QStringLiteral("Повреждён журнал: %1").arg(path));
+    prolog.append(m_file.read(headerSize + SumSize));
+    if (!sumMatches(prolog))
+        return fail(QStringLiteral("Повреждён журнал: %1").arg(path));
+
+    m_mode = Mode(mode);
+    m_dataSize = dataSize;
+    m_headerBytes = prolog.mid(PrologFixed, int(headerSize));
+    m_prologSize = prolog.size();
+    m_slotSize = SlotFixed + unitsFor(windowBytes) * DigestPairSize + SumSize;
+    m_sequence = 0;
+    m_firstChunk = 0;
+    m_before.clear();
+    m_after.clear();
+
+    for (int slot = 0; slot < 2; ++slot) {
+        if (!m_file.seek(slotOffset(slot)))
+            continue;
+        QByteArray record = m_file.read(SlotFixed);
+        if (record.size() != SlotFixed)
+            continue;
+        const uchar *r = reinterpret_cast<const uchar *>(record.constData());
+        const quint64 sequence = qFromBigEndian<quint64>(r);
+        const quint64 first = qFromBigEndian<quint64>(r + 8);
+        const quint32 units = qFromBigEndian<quint32>(r + 16);
+        if (units > unitsFor(windowBytes))
+            continue;
+        record.append(m_file.read(qint64(units) * DigestPairSize + SumSize));
+        if (!sumMatches(record) || sequence <= m_sequence)
+            continue;
+        m_sequence = sequence;
+        m_firstChunk = first;
+        m_before.resize(int(units));
+        m_after.resize(int(units));
+        const uchar *d = reinterpret_cast<const uchar *>(record.constData()) + SlotFixed;
+        for (int i = 0; i < int(units); ++i, d += DigestPairSize) {
+            m_before[i] = qFromBigEndian<quint64>(d);
+            m_after[i] = qFromBigEndian<quint64>(d + 8);
+        }
+    }
+    return true;
+}
+
+bool InPlaceJournal::record(quint64 firstChunk, const QVector<quint64> &before, const QVector<quint64> &after)
+{
+    const int units = before.size();
+    if (after.size() != units || SlotFixed + qint64(units) * DigestPairSize + SumSize > m_slotSize)
+        return fail(QStringLiteral("Окно больше ячейки журнала"));
+
+    ++m_sequence;
+    QByteArray record(SlotFixed + units * DigestPairSize, 0);
+    uchar *r = reinterpret_cast<uchar *>(record.data());
+    qToBigEndian<quint64>(m_sequence, r);
+    qToBigEndian<quint64>(firstChunk, r + 8);
+    qToBigEndian<quint32>(static_cast<quint32>(units), r + 16);
+    for (int i = 0; i < units; ++i) {
+        qToBigEndian<quint64>(before[i], r + SlotFixed + i * DigestPairSize);
+        qToBigEndian<quint64>(after[i], r + SlotFixed + i * DigestPairSize + 8);
+    }
+    appendSum(record);
+
+    // Ячейки по очереди: нечётные номера — в первую, чётные — во вторую
+    if (!m_file.seek(slotOffset(m_sequence % 2 ? 0 : 1)) || m_file.write(record) != record.size()
+        || !GroupCommit::syncFile(m_file))
+        return fail(QStringLiteral("Ошибка записи журнала"));
+
+    m_firstChunk = firstChunk;
+    m_before = before;
+    m_after = after;
+    return true;
+}
+
+bool InPlaceJournal::remove()
+{
+    const QString path = m_file.fileName();
+    m_file.close();
+    return QFile::remove(path);
+}
@@ -0,0 +1,98 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/inplacejournal.h — журнал упреждающей записи для работы «на месте»
+//
+// Файл перезаписывается окнами по несколько фрагментов. Перед записью
+// окна в журнал сохраняются его номер и дайджесты каждого участка окна
+// (UnitSize байт — сектор, который диск пишет целиком) до и после
+// наложения гаммы; окно в самом файле сбрасывается до записи следующего
+// окна в журнал. Прежнее содержимое не нужно: гамма CTR обратна сама себе.
+// После сбоя всё до окна из последней целой записи уже обработано, всё
+// после — не тронуто, а участки самого окна, чей дайджест совпал с «после»,
+// возвращаются в прежний вид той же гаммой. Участок, не совпавший ни с
+// одним дайджестом, — повреждение, которое журнал исправить не может.
+//
+//   Пролог (один раз):
+//     8  сигнатура "GOSTWAL2"
+//     1  режим (1 — шифрование, 2 — расшифрование)
+//     3  нули
+//     8  длина данных N, big-endian
+//     4  наибольшая длина окна, big-endian
+//     4  длина заголовка контейнера, big-endian
+//     …  заголовок контейнера
+//     8  контрольная сумма пролога
+//   Две ячейки записей по очереди, каждая:
+//     8  порядковый номер, big-endian
+//     8  первый фрагмент окна, big-endian
+//     4  число участков окна n, big-endian
+//     …  n пар дайджестов (до, после) по 8 байт, big-endian
+//     8  контрольная сумма ячейки
+// Оборванная запись портит только свою ячейку; берётся целая ячейка
+// с бо́льшим номером.
+#ifndef INPLACEJOURNAL_H
+#define INPLACEJOURNAL_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+class InPlaceJournal
+{
+public:
+    enum Mode : quint8 { Encrypt = 1, Decrypt = 2 };
+
+    // Окно по умолчанию: столько байт перезаписывается между сбросами на диск
+    static constexpr quint32 WindowSize = 8u << 20;
+    // Участок окна с отдельным дайджестом; кратен блоку любого шифра
+    static constexpr int UnitSize = 512;
+
+    static QString pathFor(const QString &filePath);
+    static bool isJournalName(const QString &fileName);
+    // Дайджесты участков данных по UnitSize байт; последний может быть короче
+    static QVector<quint64> unitDigests(const char *data, qint64 size);
+
+    // Новый журнал; windowBytes — наибольшая длина окна
+    bool create(const QString &path, Mode mode, quint64 dataSize, const QByteArray &headerBytes,
+                quint32 windowBytes);
+    // Прочитать существующий журнал
+    bool open(const QString &path);
+    // Записать окно и сбросить журнал на диск; before и after — дайджесты
+    // участков окна до и после гаммы, пустые — все фрагменты готовы
+    bool record(quint64 firstChunk, const QVector<quint64> &before, const QVector<quint64> &after);
+    // Удалить журнал: работа над файлом закончена
+    bool remove();
+
+    Mode mode() const { return m_mode; }
+    quint64 dataSize() const { return m_dataSize; }
+    const QByteArray &headerBytes() const { return m_headerBytes; }
+    // Последняя целая запись; без записей — окно 0 без дайджестов
+    quint64 firstChunk() const { return m_firstChunk; }
+    const QVector<quint64> &before() const { return m_before; }
+    const QVector<quint64> &after() const { return m_after; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool fail(const QString &error);
+    qint64 slotOffset(int slot) const { return m_prologSize + slot * m_slotSize; }
+
+    QFile m_file;
+    Mode m_mode = Encrypt;
+    quint64 m_dataSize = 0;
+    QByteArray m_headerBytes;
+    qint64 m_prologSize = 0;
+    qint64 m_slotSize = 0;
+    quint64 m_sequence = 0;
+    quint64 m_firstChunk = 0;
+    QVector<quint64> m_before;
+    QVector<quint64> m_after;
+    QString m_error;
+};
+
+#endif // INPLACEJOURNAL_H
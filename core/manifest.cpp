@@ -0,0 +1,283 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/manifest.cpp
+#include "manifest.h"
+#include "fileprocessor.h"
+#include "crypto/hmac.h"
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+const char ManifestMagic[8] = { 'D', 'I', 'P', 'L', 'O', 'M', 'M', 'F' };
+const char ManifestName[] = ".diplom-manifest";
+constexpr int DigestPiece = 1 << 20;
+
+void appendNumber(QByteArray &out, quint64 value, int bytes)
+{
+    char buffer[8];
+    qToBigEndian<quint64>(value, buffer);
+    out.append(buffer + 8 - bytes, bytes);
+}
+
+} // namespace
+
+Manifest::Manifest(const QString &root)
+    : m_root(QDir::cleanPath(root))
+{
+}
+
+QString Manifest::pathFor(const QString &root)
+{
+    return root + QLatin1Char('/') + QLatin1String(ManifestName);
+}
+
+bool Manifest::isManifestName(const QString &fileName)
+{
+    return fileName.endsWith(QLatin1String(ManifestName));
+}
+
+Manifest::Entry Manifest::stat(const QString &path)
+{
+    Entry entry;
+#if defined(Q_OS_UNIX)
+    struct ::stat st;
+    if (::stat(QFile::encodeName(path).constData(), &st) != 0)
+        return entry;
+    entry.size = qint64(st.st_size);
+    entry.mtimeNs = qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    entry.inode = quint64(st.st_ino);
+#else
+    const QFileInfo info(path);
+    if (!info.exists())
+        return entry;
+    entry.size = info.size();
+    entry.mtimeNs = info.lastModified().toMSecsSinceEpoch() * 1000000;
+#endif
+    return entry;
+}
+
+QByteArray Manifest::fileDigest(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    QByteArray digests;
+    quint64 total = 0;
+    for (;;) {
+        const QByteArray piece = file.read(DigestPiece);
+        if (piece.isEmpty())
+            break;
+        total += quint64(piece.size());
+        digests.append(streebog256(piece));
+    }
+    appendNumber(digests, total, 8);
+    return streebog256(digests);
+}
+
+bool Manifest::covers(const QString &path) const
+{
+    return path.startsWith(m_root) && path.size() > m_root.size() && path.at(m_root.size()) == QLatin1Char('/');
+}
+
+QString Manifest::key(const QString &path) const
+{
+    return path.mid(m_root.size() + 1);
+}
+
+bool Manifest::unchanged(const QString &path, bool useDigest, Entry *current)
+{
+    const QString name = key(path);
+    *current = stat(path);
+
+    Entry known;
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_seen.insert(name);
+        const auto it = m_entries.constFind(name);
+        if (it != m_entries.constEnd()) {
+            known = it.value();
+            found = true;
+        }
+    }
+    if (current->size < 0)
+        return false;
+    if (found && known.sameStat(*current)) {
+        current->digest = known.digest;
+        // Запись из прогона без дайджестов дополняется один раз
+        if (useDigest && known.digest.isEmpty()) {
+            current->digest = fileDigest(path);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.insert(name, *current);
+        }
+        return true;
+    }
+    if (!useDigest)
+        return false;
+
+    // stat разошёлся (копирование, touch, восстановление из резервной
+    // копии) — решает содержимое; при изменении дайджест пойдёт в опись
+    current->digest = fileDigest(path);
+    if (!found || known.digest.isEmpty() || known.size != current->size || current->digest != known.digest)
+        return false;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.insert(name, *current);
+    return true;
+}
+
+void Manifest::stage(const QString &path, const Entry &entry)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pending.insert(key(path), entry);
+}
+
+void Manifest::commit(const QString &path)
+{
+    const QString name = key(path);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto it = m_pending.find(name);
+    if (it == m_pending.end())
+        return;
+    m_entries.insert(name, it.value());
+    m_pending.erase(it);
+}
+
+int Manifest::size() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+QByteArray Manifest::serialize(bool prune) const
+{
+    QByteArray body;
+    quint32 count = 0;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        if (prune && !m_seen.contains(it.key()))
+            continue;
+        const QByteArray path = it.key().toUtf8();
+        const Entry &entry = it.value();
+        appendNumber(body, quint64(path.size()), 2);
+        body.append(path);
+        appendNumber(body, quint64(entry.size), 8);
+        appendNumber(body, quint64(entry.mtimeNs), 8);
+        appendNumber(body, entry.inode, 8);
+        body.append(char(entry.digest.size()));
+        body.append(entry.digest);
+        ++count;
+    }
+
+    QByteArray out(ManifestMagic, sizeof(ManifestMagic));
+    appendNumber(out, count, 4);
+    return out + body;
+}
+
+bool Manifest::parse(const QByteArray &data)
+{
+    const int header = int(sizeof(ManifestMagic)) + 4;
+    if (data.size() < header || memcmp(data.constData(), ManifestMagic, sizeof(ManifestMagic)) != 0)
+        return false;
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    const quint32 count = qFromBigEndian<quint32>(p + sizeof(ManifestMagic));
+
+    QHash<QString, Entry> entries;
+    int at = header;
+    for (quint32 i = 0; i < count; ++i) {
+        if (data.size() - at < 2)
+            return false;
+        const int pathSize = qFromBigEndian<quint16>(p + at);
+        at += 2;
+        if (data.size() - at < pathSize + 25)
+            return false;
+        const QString path = QString::fromUtf8(data.constData() + at, pathSize);
+        at += pathSize;
+        Entry entry;
+        entry.size = qint64(qFromBigEndian<quint64>(p + at));
+        entry.mtimeNs = qint64(qFromBigEndian<quint64>(p + at + 8));
+        entry.inode = qFromBigEndian<quint64>(p + at + 16);
+        const int digestSize = p[at + 24];
+        at += 25;
+        if (data.size() - at < digestSize)
+            return false;
+        entry.digest = data.mid(at, digestSize);
+        at += digestSize;
+        entries.insert(path, entry);
+    }
+    if (at != data.size())
+        return false;
+    m_entries = entries;
+    return true;
+}
+
+bool Manifest::load(const QString &password, int kdfIterations)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_pending.clear();
+    m_seen.clear();
+
+    QFile file(pathFor(m_root));
+    if (!file.exists())
+        return true;
+    if (!file.open(QIODevice::ReadOnly)) {
+        m_error = QStringLiteral("Не удалось открыть опись: %1").arg(file.fileName());
+        return false;
+    }
+
+    FileProcessor processor(password);
+    processor.setKdfIterations(kdfIterations);
+    QBuffer plain;
+    plain.open(QIODevice::WriteOnly);
+    if (!processor.decryptStream(file, plain)) {
+        m_error = QStringLiteral("Опись не расшифрована: %1").arg(processor.errorString());
+        return false;
+    }
+    if (!parse(plain.data())) {
+        m_error = QStringLiteral("Повреждена опись: %1").arg(file.fileName());
+        return false;
+    }
+    return true;
+}
+
+bool Manifest::save(const QString &password, int kdfIterations, bool prune)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QBuffer plain;
+    plain.setData(serialize(prune));
+    plain.open(QIODevice::ReadOnly);
+
+    // QSaveFile заменяет прежнюю опись целиком и только после fsync
+    QSaveFile file(pathFor(m_root));
+    if (!file.open(QIODevice::WriteOnly)) {
+        m_error = QStringLiteral("Не удалось записать опись: %1").arg(file.fileName());
+        return false;
+    }
+    FileProcessor processor(password);
+    processor.setKdfIterations(kdfIterations);
+    if (!processor.encryptStream(plain, file, AlgorithmId::Kuznechik)) {
+        file.cancelWriting();
+        m_error = processor.errorString();
+        return false;
+    }
+    if (!file.commit()) {
+        m_error = QStringLiteral("Не удалось записать опись: %1").arg(file.fileName());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/manifest.h — опись зашифрованных файлов папки для повторных прогонов
+//
+// Для каждого исходного файла, чей результат зафиксирован, опись хранит
+// размер, время изменения и номер inode, по желанию — дайджест Стрибога.
+// Повторный прогон сверяет с ней stat() файла и пропускает неизменённые,
+// не читая их. Опись лежит в корне папки (.diplom-manifest) и сама
+// зашифрована тем же паролем в обычном контейнере.
+//
+//   Открытый текст описи:
+//     8  сигнатура "DIPLOMMF"
+//     4  число записей, big-endian
+//   Записи:
+//     2  длина пути, big-endian; путь в UTF-8 относительно корня
+//     8  размер, 8  время изменения в нс, 8  inode — big-endian
+//     1  длина дайджеста (0 или 32), дайджест
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <mutex>
+
+class Manifest
+{
+public:
+    struct Entry {
+        qint64 size = -1;       // -1 — файла нет
+        qint64 mtimeNs = 0;
+        quint64 inode = 0;
+        QByteArray digest;      // пуст, если не считался
+
+        // Дайджест не сравнивается: он нужен, только когда stat разошёлся
+        bool sameStat(const Entry &other) const
+        {
+            return size == other.size && mtimeNs == other.mtimeNs && inode == other.inode;
+        }
+    };
+
+    explicit Manifest(const QString &root);
+
+    static QString pathFor(const QString &root);
+    static bool isManifestName(const QString &fileName);
+    static Entry stat(const QString &path);
+    // Стрибог-256 от дайджестов кусков по 1 МиБ и длины: память не растёт с файлом
+    static QByteArray fileDigest(const QString &path);
+
+    const QString &root() const { return m_root; }
+    // Путь лежит внутри корня описи
+    bool covers(const QString &path) const;
+
+    // Нет файла описи — пустая опись и true; чужой пароль или
+    // повреждение — false, опись пуста
+    bool load(const QString &password, int kdfIterations);
+    // prune — забыть файлы, которых не было в этом прогоне
+    bool save(const QString &password, int kdfIterations, bool prune);
+
+    // Сверка файла с описью; *current — его нынешнее состояние.
+    // С useDigest разошедшийся stat перепроверяется по содержимому.
+    // Вызывается из потоков обхода.
+    bool unchanged(const QString &path, bool useDigest, Entry *current);
+    // Результат файла зафиксирован: запомнить состояние, сверенное при обходе
+    void stage(const QString &path, const Entry &entry);
+    void commit(const QString &path);
+
+    int size() const;
+    QString errorString() const { return m_error; }
+
+private:
+    QString key(const QString &path) const;
+    QByteArray serialize(bool prune) const;
+    bool parse(const QByteArray &data);
+
+    const QString m_root;
+    mutable std::mutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    QHash<QString, Entry> m_pending;    // в работе, ещё не зафиксированы
+    QSet<QString> m_seen;               // встречены обходом этого прогона
+    QString m_error;
+};
+
+#endif // MANIFEST_H
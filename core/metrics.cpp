@@ -0,0 +1,209 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/metrics.cpp
+#include "metrics.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+
+std::atomic<bool> Metrics::s_enabled{false};
+
+namespace {
+
+std::atomic<quint64> stageTime[Metrics::StageCount];
+std::atomic<quint64> stageCount[Metrics::StageCount];
+std::atomic<quint64> counters[Metrics::CounterCount];
+std::atomic<qint64> gauges[Metrics::GaugeCount];
+std::atomic<qint64> gaugesMax[Metrics::GaugeCount];
+
+QElapsedTimer runTimer;
+qint64 runStarted = 0;
+
+const char *const StageNames[Metrics::StageCount] = { "kdf", "cipher", "mac", "read", "write", "compress" };
+const char *const CounterNames[Metrics::CounterCount] = {
+    "bytes_in", "bytes_out", "blocks", "chunks", "chunks_kept", "files_done", "files_failed"
+};
+const char *const GaugeNames[Metrics::GaugeCount] = { "queue_depth" };
+
+double seconds(quint64 nsecs)
+{
+    return static_cast<double>(nsecs) / 1e9;
+}
+
+bool saveAtomically(const QString &path, const QByteArray &data)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+} // namespace
+
+void Metrics::reset()
+{
+    for (int i = 0; i < StageCount; ++i) {
+        stageTime[i].store(0, std::memory_order_relaxed);
+        stageCount[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < CounterCount; ++i)
+        counters[i].store(0, std::memory_order_relaxed);
+    for (int i = 0; i < GaugeCount; ++i) {
+        gauges[i].store(0, std::memory_order_relaxed);
+        gaugesMax[i].store(0, std::memory_order_relaxed);
+    }
+    runTimer.start();
+    runStarted = QDateTime::currentMSecsSinceEpoch();
+}
+
+void Metrics::addTime(Stage stage, qint64 nsecs)
+{
+    stageTime[stage].fetch_add(static_cast<quint64>(nsecs), std::memory_order_relaxed);
+    stageCount[stage].fetch_add(1, std::memory_order_relaxed);
+}
+
+void Metrics::finishStage(Stage stage, qint64 startNs)
+{
+    const qint64 duration = Trace::now() - startNs;
+    if (isEnabled())
+        addTime(stage, duration);
+    if (Trace::isEnabled())
+        Trace::addSpan(StageNames[stage], "stage", startNs, duration);
+}
+
+void Metrics::add(Counter counter, quint64 value)
+{
+    counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+void Metrics::setGauge(Gauge gauge, qint64 value)
+{
+    gauges[gauge].store(value, std::memory_order_relaxed);
+    qint64 seen = gaugesMax[gauge].load(std::memory_order_relaxed);
+    while (value > seen && !gaugesMax[gauge].compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+    }
+}
+
+quint64 Metrics::stageNsecs(Stage stage)
+{
+    return stageTime[stage].load(std::memory_order_relaxed);
+}
+
+quint64 Metrics::stageCalls(Stage stage)
+{
+    return stageCount[stage].load(std::memory_order_relaxed);
+}
+
+quint64 Metrics::counter(Counter counter)
+{
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+qint64 Metrics::gauge(Gauge gauge)
+{
+    return gauges[gauge].load(std::memory_order_relaxed);
+}
+
+qint64 Metrics::gaugeMax(Gauge gauge)
+{
+    return gaugesMax[gauge].load(std::memory_order_relaxed);
+}
+
+const char *Metrics::stageName(Stage stage)
+{
+    return StageNames[stage];
+}
+
+QByteArray Metrics::toJson()
+{
+    QJsonObject stages;
+    for (int i = 0; i < StageCount; ++i) {
+        QJsonObject stage;
+        stage["seconds"] = seconds(stageNsecs(Stage(i)));
+        stage["calls"] = static_cast<qint64>(stageCalls(Stage(i)));
+        stages[StageNames[i]] = stage;
+    }
+
+    QJsonObject counterValues;
+    for (int i = 0; i < CounterCount; ++i)
+        counterValues[CounterNames[i]] = static_cast<qint64>(counter(Counter(i)));
+
+    QJsonObject gaugeValues;
+    for (int i = 0; i < GaugeCount; ++i) {
+        QJsonObject g;
+        g["current"] = gauge(Gauge(i));
+        g["max"] = gaugeMax(Gauge(i));
+        gaugeValues[GaugeNames[i]] = g;
+    }
+
+    QJsonObject root;
+    root["started"] = QDateTime::fromMSecsSinceEpoch(runStarted).toString(Qt::ISODate);
+    root["duration_seconds"] = runTimer.isValid() ? seconds(runTimer.nsecsElapsed()) : 0.0;
+    root["stages"] = stages;
+    root["counters"] = counterValues;
+    root["gauges"] = gaugeValues;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray Metrics::toPrometheus()
+{
+    QByteArray out;
+
+    out += "# HELP diplom_stage_seconds_total Time spent in each processing stage.\n"
+           "# TYPE diplom_stage_seconds_total counter\n";
+    for (int i = 0; i < StageCount; ++i) {
+        out += QByteArray("diplom_stage_seconds_total{stage=\"") + StageNames[i] + "\"} "
+             + QByteArray::number(seconds(stageNsecs(Stage(i))), 'f', 6) + '\n';
+    }
+    out += "# HELP diplom_stage_calls_total Number of timed sections per stage.\n"
+           "# TYPE diplom_stage_calls_total counter\n";
+    for (int i = 0; i < StageCount; ++i) {
+        out += QByteArray("diplom_stage_calls_total{stage=\"") + StageNames[i] + "\"} "
+             + QByteArray::number(stageCalls(Stage(i))) + '\n';
+    }
+
+    for (int i = 0; i < CounterCount; ++i) {
+        const QByteArray name = QByteArray("diplom_") + CounterNames[i] + "_total";
+        out += "# TYPE " + name + " counter\n";
+        out += name + ' ' + QByteArray::number(counter(Counter(i))) + '\n';
+    }
+
+    for (int i = 0; i < GaugeCount; ++i) {
+        const QByteArray name = QByteArray("diplom_") + GaugeNames[i];
+        out += "# TYPE " + name + " gauge\n";
+        out += name + ' ' + QByteArray::number(gauge(Gauge(i))) + '\n';
+        out += "# TYPE " + name + "_max gauge\n";
+        out += name + "_max " + QByteArray::number(gaugeMax(Gauge(i))) + '\n';
+    }
+
+    out += "# HELP diplom_run_duration_seconds Wall time of the last run.\n"
+           "# TYPE diplom_run_duration_seconds gauge\n";
+    out += "diplom_run_duration_seconds "
+         + QByteArray::number(runTimer.isValid() ? seconds(runTimer.nsecsElapsed()) : 0.0, 'f', 6) + '\n';
+    out += "# HELP diplom_run_timestamp_seconds Unix time the last run finished.\n"
+           "# TYPE diplom_run_timestamp_seconds gauge\n";
+    out += "diplom_run_timestamp_seconds " + QByteArray::number(QDateTime::currentSecsSinceEpoch()) + '\n';
+    return out;
+}
+
+bool Metrics::writeJson(const QString &path)
+{
+    return saveAtomically(path, toJson());
+}
+
+bool Metrics::writePrometheus(const QString &path)
+{
+    return saveAtomically(path, toPrometheus());
+}
@@ -0,0 +1,122 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/metrics.h — замеры времени по стадиям и счётчики обработки
+//
+// Все значения — атомарные, пишутся из любого потока. Сбор включается
+// Metrics::setEnabled(true); выключенный замер стоит одной проверки флага.
+// Замеры стадий попадают и в трассу (core/trace.h), если она пишется.
+// Со сборкой -DDIPLOM_METRICS=OFF макросы DIPLOM_* раскрываются в ничто.
+//
+// Итог прогона выгружается в JSON и в текстовый формат Prometheus
+// (для textfile collector у node_exporter).
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include "trace.h"
+
+class Metrics
+{
+public:
+    enum Stage {
+        Kdf,        // выработка ключей из пароля
+        Cipher,     // наложение гаммы
+        Mac,        // вычисление и проверка имитовставок
+        Read,       // чтение исходных данных
+        Write,      // запись результата
+        Compress,   // сжатие и распаковка фрагментов
+        StageCount
+    };
+
+    enum Counter {
+        BytesIn,
+        BytesOut,
+        Blocks,     // блоков шифра
+        Chunks,     // фрагментов контейнера
+        ChunksKept, // фрагментов, оставленных обновлением без перезаписи
+        FilesDone,
+        FilesFailed,
+        CounterCount
+    };
+
+    enum Gauge {
+        QueueDepth, // файлов в очереди на обработку
+        GaugeCount
+    };
+
+    static void setEnabled(bool enabled) { s_enabled.store(enabled, std::memory_order_relaxed); }
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Обнулить всё и начать отсчёт нового прогона
+    static void reset();
+
+    static void addTime(Stage stage, qint64 nsecs);
+    // Завершение замера: время — в метрики, интервал — в трассу
+    static void finishStage(Stage stage, qint64 startNs);
+    static void add(Counter counter, quint64 value = 1);
+    static void setGauge(Gauge gauge, qint64 value);
+
+    static quint64 stageNsecs(Stage stage);
+    static quint64 stageCalls(Stage stage);
+    static quint64 counter(Counter counter);
+    static qint64 gauge(Gauge gauge);
+    static qint64 gaugeMax(Gauge gauge);
+    static const char *stageName(Stage stage);
+
+    static QByteArray toJson();
+    static QByteArray toPrometheus();
+
+    // Запись через временный файл и переименование: сборщик никогда
+    // не увидит наполовину записанный файл
+    static bool writeJson(const QString &path);
+    static bool writePrometheus(const QString &path);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Замер времени от создания до выхода из области видимости
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(Metrics::Stage stage)
+        : m_stage(stage)
+        , m_start(Metrics::isEnabled() || Trace::isEnabled() ? Trace::now() : -1)
+    {
+    }
+    ~ScopedStageTimer()
+    {
+        if (m_start >= 0)
+            Metrics::finishStage(m_stage, m_start);
+    }
+
+    ScopedStageTimer(const ScopedStageTimer &) = delete;
+    ScopedStageTimer &operator=(const ScopedStageTimer &) = delete;
+
+private:
+    Metrics::Stage m_stage;
+    qint64 m_start;
+};
+
+#if DIPLOM_METRICS
+#define DIPLOM_STAGE_TIMER(stage) \
+    ScopedStageTimer DIPLOM_METRICS_CONCAT(stageTimer_, __LINE__)(Metrics::stage)
+#define DIPLOM_COUNT(counter, value) \
+    do { if (Metrics::isEnabled()) Metrics::add(Metrics::counter, (value)); } while (0)
+#define DIPLOM_GAUGE(gauge, value) \
+    do { if (Metrics::isEnabled()) Metrics::setGauge(Metrics::gauge, (value)); } while (0)
+#else
+#define DIPLOM_STAGE_TIMER(stage) do { } while (0)
+#define DIPLOM_COUNT(counter, value) do { (void)sizeof(value); } while (0)
+#define DIPLOM_GAUGE(gauge, value) do { (void)sizeof(value); } while (0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,115 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/progress.cpp
+#include "progress.h"
+#include <QStringList>
+
+namespace {
+
+const char *const StageLabels[Metrics::StageCount] = {
+    "KDF", "шифр", "имитовставка", "чтение", "запись", "сжатие"
+};
+
+QString formatDuration(qint64 seconds)
+{
+    const qint64 hours = seconds / 3600;
+    const qint64 minutes = seconds / 60 % 60;
+    const QString rest = QStringLiteral("%1:%2").arg(minutes, hours ? 2 : 1, 10, QLatin1Char('0'))
+                                                .arg(seconds % 60, 2, 10, QLatin1Char('0'));
+    return hours ? QStringLiteral("%1:%2").arg(hours).arg(rest) : rest;
+}
+
+} // namespace
+
+ProgressMeter::ProgressMeter(double smoothing)
+    : m_smoothing(smoothing)
+{
+}
+
+void ProgressMeter::start()
+{
+    m_clock.start();
+    m_progress = BatchProgress();
+    m_lastNs = -1;
+    m_lastBytes = 0;
+    m_rate = 0.0;
+    m_hasRate = false;
+    for (int i = 0; i < Metrics::StageCount; ++i) {
+        m_lastStageNs[i] = Metrics::stageNsecs(Metrics::Stage(i));
+        m_utilization[i] = 0.0;
+    }
+}
+
+void ProgressMeter::sample(const BatchProgress &progress)
+{
+    sample(progress, m_clock.isValid() ? m_clock.nsecsElapsed() : 0);
+}
+
+void ProgressMeter::sample(const BatchProgress &progress, qint64 nowNs)
+{
+    m_progress = progress;
+    if (m_lastNs < 0) {
+        m_lastNs = nowNs;
+        m_lastBytes = progress.bytesDone;
+        return;
+    }
+
+    const qint64 elapsed = nowNs - m_lastNs;
+    if (elapsed <= 0)
+        return;
+
+    const double seconds = static_cast<double>(elapsed) / 1e9;
+    const quint64 bytes = progress.bytesDone >= m_lastBytes ? progress.bytesDone - m_lastBytes : 0;
+    const double rate = static_cast<double>(bytes) / seconds;
+    m_rate = m_hasRate ? m_smoothing * rate + (1.0 - m_smoothing) * m_rate : rate;
+    m_hasRate = true;
+
+    const double workerNs = static_cast<double>(elapsed) * qMax(1, progress.workers);
+    for (int i = 0; i < Metrics::StageCount; ++i) {
+        const quint64 stageNs = Metrics::stageNsecs(Metrics::Stage(i));
+        const quint64 delta = stageNs >= m_lastStageNs[i] ? stageNs - m_lastStageNs[i] : 0;
+        const double share = qMin(1.0, static_cast<double>(delta) / workerNs);
+        m_utilization[i] = m_smoothing * share + (1.0 - m_smoothing) * m_utilization[i];
+        m_lastStageNs[i] = stageNs;
+    }
+
+    m_lastNs = nowNs;
+    m_lastBytes = progress.bytesDone;
+}
+
+double ProgressMeter::fraction() const
+{
+    if (m_progress.bytesQueued == 0)
+        return m_progress.scanFinished ? 1.0 : 0.0;
+    return qMin(1.0, static_cast<double>(m_progress.bytesDone) / static_cast<double>(m_progress.bytesQueued));
+}
+
+qint64 ProgressMeter::etaSeconds() const
+{
+    if (!m_progress.scanFinished || m_rate <= 0.0)
+        return -1;
+    const quint64 left = m_progress.bytesQueued > m_progress.bytesDone
+        ? m_progress.bytesQueued - m_progress.bytesDone : 0;
+    return static_cast<qint64>(static_cast<double>(left) / m_rate + 0.5);
+}
+
+QString ProgressMeter::summary() const
+{
+    QString text = QStringLiteral("%1 МБ/с").arg(m_rate / (1024.0 * 1024.0), 0, 'f', 1);
+    const qint64 eta = etaSeconds();
+    text += eta >= 0 ? QStringLiteral(", осталось %1").arg(formatDuration(eta))
+                     : QStringLiteral(", идёт обход");
+
+    QStringList stages;
+    for (int i = 0; i < Metrics::StageCount; ++i) {
+        stages << QStringLiteral("%1 %2%").arg(QString::fromUtf8(StageLabels[i]))
+                                          .arg(qRound(m_utilization[i] * 100));
+    }
+    return text + QStringLiteral("; ") + stages.join(QStringLiteral(", "));
+}
@@ -0,0 +1,71 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/progress.h — ход пакета в байтах, скорость, оценка остатка
+//
+// BatchRunner::progress() отдаёт снимок счётчиков; ProgressMeter по
+// последовательным снимкам считает скорость (скользящее среднее),
+// оставшееся время и загрузку рабочих потоков по стадиям из Metrics.
+// По загрузке видно, во что упирается прогон: в процессор (шифр,
+// имитовставка, KDF) или в диск (чтение и запись).
+#ifndef PROGRESS_H
+#define PROGRESS_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include "metrics.h"
+
+// Снимок хода пакета
+struct BatchProgress
+{
+    quint64 filesQueued = 0;
+    quint64 filesDone = 0;
+    quint64 filesFailed = 0;
+    quint64 bytesQueued = 0;    // размер найденных файлов
+    quint64 bytesDone = 0;      // прочитано из них, включая недоделанные файлы
+    bool scanFinished = false;  // до конца обхода итог ещё растёт
+    int workers = 1;
+};
+
+class ProgressMeter
+{
+public:
+    // smoothing — вес нового замера в скользящем среднем
+    explicit ProgressMeter(double smoothing = 0.3);
+
+    // Начало пакета: обнуляет среднее и запоминает счётчики стадий
+    void start();
+    // Очередной снимок; nowNs — монотонное время, по умолчанию своё
+    void sample(const BatchProgress &progress);
+    void sample(const BatchProgress &progress, qint64 nowNs);
+
+    const BatchProgress &progress() const { return m_progress; }
+    // Доля сделанного по байтам, 0..1
+    double fraction() const;
+    double bytesPerSecond() const { return m_rate; }
+    // Секунд до конца; -1, пока итог не известен или скорость нулевая
+    qint64 etaSeconds() const;
+    // Доля времени рабочих потоков в стадии за последние замеры, 0..1
+    double utilization(Metrics::Stage stage) const { return m_utilization[stage]; }
+
+    // "12.3 МБ/с, осталось 0:42; шифр 55%, имитовставка 30%, ..."
+    QString summary() const;
+
+private:
+    double m_smoothing;
+    QElapsedTimer m_clock;
+    BatchProgress m_progress;
+    qint64 m_lastNs = -1;
+    quint64 m_lastBytes = 0;
+    quint64 m_lastStageNs[Metrics::StageCount] = {};
+    double m_rate = 0.0;
+    bool m_hasRate = false;
+    double m_utilization[Metrics::StageCount] = {};
+};
+
+#endif // PROGRESS_H
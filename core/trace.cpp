@@ -0,0 +1,225 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/trace.cpp
+#include "trace.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> Trace::s_enabled{false};
+
+namespace {
+
+struct Event
+{
+    const char *name;
+    const char *category;
+    qint64 start;
+    qint64 duration;
+    const char *argName;
+    QString argValue;
+};
+
+// Буфер одного потока. Заводится при первом событии записи и переживает
+// свой поток, чтобы его события попали в файл; буферы завершившихся
+// потоков убираются, когда их события записаны или сброшены.
+struct ThreadBuffer
+{
+    int tid = 0;
+    bool exited = false;
+    QString name;
+    std::vector<Event> events;
+};
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>> registry;
+int nextTid = 0;
+qint64 traceOrigin = 0;
+
+// Поток помечает свой буфер при завершении
+struct ThreadSlot
+{
+    ThreadBuffer *buffer = nullptr;
+    QString name;
+
+    ~ThreadSlot()
+    {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffer->exited = true;
+        }
+    }
+};
+
+thread_local ThreadSlot threadSlot;
+
+// Под registryMutex
+void dropExited()
+{
+    registry.erase(std::remove_if(registry.begin(), registry.end(),
+                                  [](const std::unique_ptr<ThreadBuffer> &buffer) { return buffer->exited; }),
+                   registry.end());
+}
+
+const QElapsedTimer &traceClock()
+{
+    static const QElapsedTimer timer = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return timer;
+}
+
+ThreadBuffer &threadBuffer()
+{
+    ThreadSlot &slot = threadSlot;
+    if (!slot.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        registry.push_back(std::make_unique<ThreadBuffer>());
+        slot.buffer = registry.back().get();
+        slot.buffer->tid = ++nextTid;
+        slot.buffer->name = slot.name;
+    }
+    return *slot.buffer;
+}
+
+void appendEscaped(QByteArray &out, const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    for (char c : utf8) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (static_cast<uchar>(c) < 0x20) {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<uchar>(c));
+                out += escaped;
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+// Микросекунды с дробной частью — единица времени формата
+QByteArray micros(qint64 nsecs)
+{
+    return QByteArray::number(static_cast<double>(nsecs) / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+void Trace::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        dropExited();
+        for (const auto &buffer : registry)
+            buffer->events.clear();
+    }
+    traceOrigin = now();
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+// Имя запоминается в потоке; буфер без записи трассы не заводится
+void Trace::setThreadName(const QString &name)
+{
+    ThreadSlot &slot = threadSlot;
+    slot.name = name;
+    if (slot.buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        slot.buffer->name = name;
+    } else if (isEnabled()) {
+        threadBuffer();
+    }
+}
+
+void Trace::addSpan(const char *name, const char *category, qint64 startNs, qint64 durationNs,
+                    const char *argName, const QString &argValue)
+{
+    threadBuffer().events.push_back(Event{ name, category, startNs, durationNs, argName, argValue });
+}
+
+qint64 Trace::now()
+{
+    return traceClock().nsecsElapsed();
+}
+
+int Trace::eventCount()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    size_t count = 0;
+    for (const auto &buffer : registry)
+        count += buffer->events.size();
+    return static_cast<int>(count);
+}
+
+QByteArray Trace::toJson()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&] {
+        if (!first)
+            out += ",\n";
+        first = false;
+    };
+
+    for (const auto &buffer : registry) {
+        const QByteArray tid = QByteArray::number(buffer->tid);
+        if (!buffer->name.isEmpty()) {
+            separator();
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+                 + ",\"args\":{\"name\":\"";
+            appendEscaped(out, buffer->name);
+            out += "\"}}";
+        }
+        for (const Event &e : buffer->events) {
+            separator();
+            out += QByteArray("{\"name\":\"") + e.name + "\",\"cat\":\"" + e.category
+                 + "\",\"ph\":\"X\",\"ts\":" + micros(e.start - traceOrigin)
+                 + ",\"dur\":" + micros(e.duration) + ",\"pid\":" + pid + ",\"tid\":" + tid;
+            if (e.argName) {
+                out += QByteArray(",\"args\":{\"") + e.argName + "\":\"";
+                appendEscaped(out, e.argValue);
+                out += "\"}";
+            }
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Trace::write(const QString &path)
+{
+    const QByteArray data = toJson();
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (file.write(data) != data.size()) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit())
+        return false;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    dropExited();
+    return true;
+}
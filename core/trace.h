@@ -0,0 +1,97 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// core/trace.h — запись временной шкалы прогона в формате Chrome Trace Event
+//
+// Каждый поток пишет интервалы в свой буфер без блокировок; буферы
+// собираются в один JSON в Trace::write(). Буфер заводится только при
+// записи трассы, а буферы завершившихся потоков убираются после write()
+// или следующего start(). Файл открывается в Perfetto
+// (ui.perfetto.dev) или chrome://tracing.
+//
+// start() и write() вызываются, когда рабочие потоки не пишут в трассу:
+// до запуска пакета и после его завершения.
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QString>
+#include <atomic>
+
+class Trace
+{
+public:
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Очистить буферы и начать запись
+    static void start();
+    static void stop() { s_enabled.store(false, std::memory_order_relaxed); }
+
+    // Имя текущего потока на временной шкале
+    static void setThreadName(const QString &name);
+
+    // name и category — строковые литералы: хранятся указатели
+    static void addSpan(const char *name, const char *category, qint64 startNs, qint64 durationNs,
+                        const char *argName = nullptr, const QString &argValue = QString());
+    static qint64 now();
+
+    static int eventCount();
+    static QByteArray toJson();
+    static bool write(const QString &path);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// Интервал от создания до выхода из области видимости
+class TraceSpan
+{
+public:
+    explicit TraceSpan(const char *name, const char *category = "stage",
+                       const char *argName = nullptr, const QString &argValue = QString())
+        : m_name(name), m_category(category), m_argName(argName)
+        , m_start(Trace::isEnabled() ? Trace::now() : -1)
+        , m_argValue(argValue)
+    {
+    }
+    ~TraceSpan()
+    {
+        if (m_start >= 0)
+            Trace::addSpan(m_name, m_category, m_start, Trace::now() - m_start, m_argName, m_argValue);
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    const char *m_argName;
+    qint64 m_start;
+    QString m_argValue;
+};
+
+#ifndef DIPLOM_METRICS
+#define DIPLOM_METRICS 1
+#endif
+
+#define DIPLOM_METRICS_CONCAT_(a, b) a##b
+#define DIPLOM_METRICS_CONCAT(a, b) DIPLOM_METRICS_CONCAT_(a, b)
+
+#if DIPLOM_METRICS
+// Значение аргумента вычисляется, только если трасса пишется
+#define DIPLOM_TRACE_SPAN(name, category) \
+    TraceSpan DIPLOM_METRICS_CONCAT(traceSpan_, __LINE__)(name, category)
+#define DIPLOM_TRACE_SPAN_ARG(name, category, argName, argValue) \
+    TraceSpan DIPLOM_METRICS_CONCAT(traceSpan_, __LINE__)( \
+        name, category, argName, Trace::isEnabled() ? QString(argValue) : QString())
+#else
+#define DIPLOM_TRACE_SPAN(name, category) do { } while (0)
+#define DIPLOM_TRACE_SPAN_ARG(name, category, argName, argValue) do { } while (0)
+#endif
+
+#endif // TRACE_H
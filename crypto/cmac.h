@@ -0,0 +1,114 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/cmac.h — режим выработки имитовставки (ГОСТ Р 34.13-2015, п. 4.6)
+//
+// CMAC (OMAC1) на развёрнутом ключе шифра (KuznechikKey, MagmaKey):
+// сцепление C_i = E(C_{i-1} ⊕ P_i), последний блок перед шифрованием
+// складывается со вспомогательным ключом K1 (полный блок) или K2 (блок,
+// дополненный 1 0…0). K1 и K2 выводятся из R = E(0^n) сдвигом влево
+// и сложением с B_n = 0^120 || 10000111 (n = 128) или 0^59 || 11011 (n = 64).
+// Стандарт допускает имитовставку из s ≤ n старших бит; здесь — полный блок.
+#ifndef CMAC_H
+#define CMAC_H
+
+#include <QtGlobal>
+#include <cstring>
+#include "traits.h"
+
+template<typename Cipher>
+class Cmac
+{
+public:
+    static constexpr int BlockSize = CipherTraits<Cipher>::BlockSize;
+    static constexpr int TagSize = BlockSize;
+
+    // Ключ шифра только читается: один развёрнутый ключ — на все потоки
+    explicit Cmac(const Cipher &cipher)
+        : m_cipher(cipher)
+    {
+        quint8 r[BlockSize] = {};
+        cipher.encryptBlock(r, r);
+        doubleBlock(r, m_k1);
+        doubleBlock(m_k1, m_k2);
+    }
+
+    // Данные можно подавать частями любой длины
+    void update(const char *data, qint64 size)
+    {
+        const quint8 *p = reinterpret_cast<const quint8 *>(data);
+        while (size > 0) {
+            // Полный блок в буфере — не последний, раз данные ещё есть
+            if (m_used == BlockSize) {
+                chain(m_buffer);
+                m_used = 0;
+            }
+            // Целые блоки — прямо из входа; последний остаётся в буфере
+            if (m_used == 0) {
+                for (; size > BlockSize; p += BlockSize, size -= BlockSize)
+                    chain(p);
+            }
+            const int take = int(qMin<qint64>(BlockSize - m_used, size));
+            memcpy(m_buffer + m_used, p, size_t(take));
+            m_used += take;
+            p += take;
+            size -= take;
+        }
+    }
+
+    // Имитовставка TagSize байт; после неё объект не используется
+    void finish(quint8 *tag)
+    {
+        if (m_used == BlockSize) {
+            xorBlock(m_buffer, m_k1);
+        } else {
+            m_buffer[m_used] = 0x80;
+            memset(m_buffer + m_used + 1, 0, size_t(BlockSize - m_used - 1));
+            xorBlock(m_buffer, m_k2);
+        }
+        chain(m_buffer);
+        memcpy(tag, m_state, BlockSize);
+    }
+
+private:
+    static void xorBlock(quint8 *dst, const quint8 *src)
+    {
+        for (int j = 0; j < BlockSize; j += 8) {
+            quint64 a, b;
+            memcpy(&a, dst + j, 8);
+            memcpy(&b, src + j, 8);
+            a ^= b;
+            memcpy(dst + j, &a, 8);
+        }
+    }
+
+    // Сдвиг блока на бит влево по модулю многочлена B_n
+    static void doubleBlock(const quint8 *in, quint8 *out)
+    {
+        const quint8 b = BlockSize == 16 ? 0x87 : 0x1b;
+        const quint8 carry = in[0] >> 7;
+        for (int i = 0; i < BlockSize - 1; ++i)
+            out[i] = quint8((in[i] << 1) | (in[i + 1] >> 7));
+        out[BlockSize - 1] = quint8((in[BlockSize - 1] << 1) ^ (quint8(0 - carry) & b));
+    }
+
+    void chain(const quint8 *block)
+    {
+        xorBlock(m_state, block);
+        m_cipher.encryptBlock(m_state, m_state);
+    }
+
+    const Cipher &m_cipher;
+    alignas(16) quint8 m_state[BlockSize] = {};
+    alignas(16) quint8 m_buffer[BlockSize] = {};
+    quint8 m_k1[BlockSize];
+    quint8 m_k2[BlockSize];
+    int m_used = 0;
+};
+
+#endif // CMAC_H
@@ -0,0 +1,114 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/cpufeatures.cpp
+#include "cpufeatures.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DIPLOM_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#ifdef DIPLOM_X86
+static void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i)
+        regs[i] = static_cast<unsigned>(r[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// Какие регистры сохраняет ОС при переключении контекста (XCR0)
+static quint64 xgetbv0()
+{
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned lo, hi;
+    __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<quint64>(hi) << 32) | lo;
+#endif
+}
+
+static quint32 detect()
+{
+    unsigned r[4] = {};
+    cpuid(0, 0, r);
+    const unsigned maxLeaf = r[0];
+    if (maxLeaf < 1)
+        return 0;
+
+    quint32 flags = 0;
+    cpuid(1, 0, r);
+    const unsigned ecx = r[2], edx = r[3];
+    if (edx & (1u << 26)) flags |= CpuFeatures::SSE2;
+    if (ecx & (1u << 9))  flags |= CpuFeatures::SSSE3;
+    if (ecx & (1u << 19)) flags |= CpuFeatures::SSE41;
+    if (ecx & (1u << 1))  flags |= CpuFeatures::PCLMUL;
+    if (ecx & (1u << 25)) flags |= CpuFeatures::AESNI;
+
+    // AVX пригоден, только если ОС сохраняет регистры YMM (и ZMM для AVX-512)
+    const bool osxsave = (ecx & (1u << 27)) != 0;
+    const quint64 xcr0 = osxsave ? xgetbv0() : 0;
+    const bool ymm = (xcr0 & 0x6) == 0x6;
+    const bool zmm = (xcr0 & 0xE6) == 0xE6;
+    if (ymm && (ecx & (1u << 28)))
+        flags |= CpuFeatures::AVX;
+
+    if (maxLeaf >= 7) {
+        cpuid(7, 0, r);
+        if (ymm && (r[1] & (1u << 5)))
+            flags |= CpuFeatures::AVX2;
+        if (zmm && (r[1] & (1u << 16)))
+            flags |= CpuFeatures::AVX512F;
+    }
+    return flags;
+}
+#else
+static quint32 detect()
+{
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+    return CpuFeatures::NEON;
+#else
+    return 0;
+#endif
+}
+#endif
+
+QStringList CpuFeatures::names() const
+{
+    static const struct { quint32 flag; const char *name; } table[] = {
+        { SSE2, "SSE2" }, { SSSE3, "SSSE3" }, { SSE41, "SSE4.1" }, { AVX, "AVX" },
+        { AVX2, "AVX2" }, { PCLMUL, "PCLMUL" }, { AESNI, "AES-NI" },
+        { AVX512F, "AVX-512F" }, { NEON, "NEON" }
+    };
+    QStringList result;
+    for (const auto &entry : table) {
+        if (flags & entry.flag)
+            result << QString::fromLatin1(entry.name);
+    }
+    return result;
+}
+
+const CpuFeatures &CpuFeatures::host()
+{
+    static const CpuFeatures features = [] {
+        CpuFeatures f;
+        f.flags = detect();
+        return f;
+    }();
+    return features;
+}
@@ -0,0 +1,38 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/cpufeatures.h — расширения набора команд процессора
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#include <QStringList>
+
+struct CpuFeatures
+{
+    enum Flag : quint32 {
+        SSE2    = 1u << 0,
+        SSSE3   = 1u << 1,
+        SSE41   = 1u << 2,
+        AVX     = 1u << 3,   // только при поддержке со стороны ОС (XSAVE)
+        AVX2    = 1u << 4,
+        PCLMUL  = 1u << 5,
+        AESNI   = 1u << 6,
+        AVX512F = 1u << 7,
+        NEON    = 1u << 8
+    };
+
+    quint32 flags = 0;
+
+    bool has(quint32 required) const { return (flags & required) == required; }
+    QStringList names() const;
+
+    // Опрос CPUID выполняется один раз, при первом обращении
+    static const CpuFeatures &host();
+};
+
+#endif // CPUFEATURES_H
@@ -0,0 +1,120 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/ctr.h — режим гаммирования (CTR, ГОСТ Р 34.13-2015, п. 4.2)
+#ifndef CTR_H
+#define CTR_H
+
+#include <QByteArray>
+#include <QtEndian>
+#include <cstring>
+#include "traits.h"
+
+// Счётчик — полный блок iv, увеличивается как big-endian число.
+// Для режима по стандарту iv = IV || 0…0 (половина блока — синхропосылка).
+template<typename Cipher>
+QByteArray encryptCTR(const QByteArray &data, const Cipher &cipher, const QByteArray &iv)
+{
+    QByteArray result;
+    QByteArray counter = iv;
+    const int blockSize = CipherTraits<Cipher>::BlockSize;
+
+    for (int i = 0; i < data.size(); i += blockSize) {
+        QByteArray block = data.mid(i, blockSize);
+        QByteArray encryptedCounter = cipher.encryptBlock(counter);
+        if (encryptedCounter.isEmpty()) return QByteArray();
+
+        for (int j = 0; j < block.size(); ++j) {
+            result.append(encryptedCounter[j] ^ block[j]);
+        }
+
+        // Увеличиваем счётчик (младшие байты)
+        for (int k = counter.size() - 1; k >= 0; --k) {
+            counter[k]++;
+            if (counter[k] != 0) break;
+        }
+    }
+    return result;
+}
+
+// Счётчик из BlockSize / 8 машинных слов, старшее — первое: прибавление
+// и выгрузка в блок без побайтового цикла
+template<int BlockSize>
+struct CtrCounter
+{
+    static constexpr int Words = BlockSize / 8;
+    quint64 w[Words];
+
+    explicit CtrCounter(const QByteArray &iv)
+    {
+        for (int k = 0; k < Words; ++k)
+            w[k] = qFromBigEndian<quint64>(iv.constData() + 8 * k);
+    }
+
+    // Прибавить delta по модулю 2^(8 * BlockSize)
+    void advance(quint64 delta)
+    {
+        for (int k = Words - 1; k >= 0 && delta != 0; --k) {
+            w[k] += delta;
+            delta = w[k] < delta ? 1 : 0;
+        }
+    }
+
+    void store(quint8 *block) const
+    {
+        for (int k = 0; k < Words; ++k)
+            qToBigEndian<quint64>(w[k], block + 8 * k);
+    }
+};
+
+// Наложить гамму на буфер на месте, начиная с блока blockOffset от iv.
+// Позволяет обрабатывать фрагменты потока независимо друг от друга.
+// Гамма вырабатывается на BatchWidth блоков вперёд и накладывается
+// словами; размеры — константы CipherTraits, циклы разворачиваются.
+// iv — ровно один блок шифра.
+template<typename Cipher>
+void applyCTR(const Cipher &cipher, const QByteArray &iv, quint64 blockOffset, char *data, qint64 size)
+{
+    using Traits = CipherTraits<Cipher>;
+    constexpr int n = Traits::BlockSize;
+    CtrCounter<n> counter(iv);
+    counter.advance(blockOffset);
+
+    alignas(16) quint8 gamma[Traits::BatchBytes];
+    for (qint64 offset = 0; offset < size; offset += Traits::BatchBytes) {
+        const qint64 len = qMin<qint64>(Traits::BatchBytes, size - offset);
+        const int blocks = int((len + n - 1) / n);
+        for (int b = 0; b < blocks; ++b) {
+            counter.store(gamma + b * n);
+            cipher.encryptBlock(gamma + b * n, gamma + b * n);
+            counter.advance(1);
+        }
+
+        char *out = data + offset;
+        if (len == Traits::BatchBytes) {
+            for (int j = 0; j < Traits::BatchBytes; j += 8) {
+                quint64 word, key;
+                memcpy(&word, out + j, 8);
+                memcpy(&key, gamma + j, 8);
+                word ^= key;
+                memcpy(out + j, &word, 8);
+            }
+        } else {
+            for (qint64 j = 0; j < len; ++j)
+                out[j] = static_cast<char>(out[j] ^ gamma[j]);
+        }
+    }
+}
+
+template<typename Cipher>
+QByteArray decryptCTR(const QByteArray &data, const Cipher &cipher, const QByteArray &iv)
+{
+    return encryptCTR(data, cipher, iv); // CTR симметричен
+}
+
+#endif // CTR_H
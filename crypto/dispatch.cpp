@@ -0,0 +1,224 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/dispatch.cpp
+#include "dispatch.h"
+#include "cpufeatures.h"
+#include "kuznechik.h"
+#include "magma.h"
+#include "mgm.h"
+#include "striborg.h"
+#include <QDebug>
+#include <atomic>
+#include <iterator>
+#include <mutex>
+
+namespace {
+
+using AnyFn = void (*)();
+
+struct Kernel
+{
+    const char *name;
+    quint32 required;   // CpuFeatures::Flag
+    AnyFn fn;
+};
+
+template<typename Fn>
+AnyFn erase(Fn fn)
+{
+    return reinterpret_cast<AnyFn>(fn);
+}
+
+// Порядок — по убыванию предпочтения; последнее ядро — эталонное
+const Kernel kuznechikKernels[] = {
+    { "table", 0, erase(&Kuznechik::encryptBlockTable) },
+    { "ref",   0, erase(&Kuznechik::encryptBlockRef) },
+};
+const Kernel magmaKernels[] = {
+    { "table", 0, erase(&Magma::encryptBlockTable) },
+    { "ref",   0, erase(&Magma::encryptBlockRef) },
+};
+const Kernel streebogKernels[] = {
+    { "table", 0, erase(&Streebog::lpsTable) },
+    { "ref",   0, erase(&Streebog::lpsRef) },
+};
+const Kernel gf128Kernels[] = {
+#ifdef DIPLOM_HAVE_CLMUL
+    { "pclmul", CpuFeatures::PCLMUL, erase(&MgmField::sum128Clmul) },
+#endif
+    { "ref",    0, erase(&MgmField::sum128Ref) },
+};
+const Kernel gf64Kernels[] = {
+#ifdef DIPLOM_HAVE_CLMUL
+    { "pclmul", CpuFeatures::PCLMUL, erase(&MgmField::sum64Clmul) },
+#endif
+    { "ref",    0, erase(&MgmField::sum64Ref) },
+};
+
+struct Registry
+{
+    const Kernel *kernels;
+    int count;
+    const char *name;
+};
+
+const Registry registry[Dispatch::PrimitiveCount] = {
+    { kuznechikKernels, int(std::size(kuznechikKernels)), "kuznechik" },
+    { magmaKernels,     int(std::size(magmaKernels)),     "magma" },
+    { streebogKernels,  int(std::size(streebogKernels)),  "streebog" },
+    { gf128Kernels,     int(std::size(gf128Kernels)),     "gf128" },
+    { gf64Kernels,      int(std::size(gf64Kernels)),      "gf64" },
+};
+
+std::atomic<int> selectedIndex[Dispatch::PrimitiveCount];
+std::once_flag initFlag;
+
+bool supported(const Kernel &kernel)
+{
+    return CpuFeatures::host().has(kernel.required);
+}
+
+bool selectKernel(Dispatch::Primitive primitive, const QString &kernel)
+{
+    const Registry &r = registry[primitive];
+    for (int i = 0; i < r.count; ++i) {
+        if (kernel == QLatin1String(r.kernels[i].name)) {
+            if (!supported(r.kernels[i]))
+                return false;
+            selectedIndex[primitive].store(i, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Вызывается и из инициализации, поэтому сама ensureInit() не трогает
+bool applyOverrides(const QString &overrides)
+{
+    bool ok = true;
+    const QStringList entries = overrides.split(',', Qt::SkipEmptyParts);
+    for (const QString &entry : entries) {
+        const QStringList parts = entry.split('=');
+        bool applied = false;
+        if (parts.size() == 2) {
+            for (int p = 0; p < Dispatch::PrimitiveCount; ++p) {
+                if (parts[0].trimmed() == QLatin1String(registry[p].name)) {
+                    applied = selectKernel(Dispatch::Primitive(p), parts[1].trimmed());
+                    break;
+                }
+            }
+        }
+        if (!applied) {
+            qWarning() << "Неизвестное или неподдерживаемое ядро:" << entry;
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void ensureInit()
+{
+    std::call_once(initFlag, [] {
+        for (int p = 0; p < Dispatch::PrimitiveCount; ++p) {
+            int chosen = registry[p].count - 1;
+            for (int i = 0; i < registry[p].count; ++i) {
+                if (supported(registry[p].kernels[i])) {
+                    chosen = i;
+                    break;
+                }
+            }
+            selectedIndex[p].store(chosen, std::memory_order_relaxed);
+        }
+        applyOverrides(QString::fromLocal8Bit(qgetenv("DIPLOM_KERNELS")));
+    });
+}
+
+AnyFn current(Dispatch::Primitive primitive)
+{
+    ensureInit();
+    const int index = selectedIndex[primitive].load(std::memory_order_relaxed);
+    return registry[primitive].kernels[index].fn;
+}
+
+} // namespace
+
+Dispatch::KuznechikEncryptFn Dispatch::kuznechikEncrypt()
+{
+    return reinterpret_cast<KuznechikEncryptFn>(current(KuznechikEncrypt));
+}
+
+Dispatch::MagmaEncryptFn Dispatch::magmaEncrypt()
+{
+    return reinterpret_cast<MagmaEncryptFn>(current(MagmaEncrypt));
+}
+
+Dispatch::StreebogLpsFn Dispatch::streebogLps()
+{
+    return reinterpret_cast<StreebogLpsFn>(current(StreebogLps));
+}
+
+Dispatch::GfSumFn Dispatch::gf128Sum()
+{
+    return reinterpret_cast<GfSumFn>(current(Gf128Sum));
+}
+
+Dispatch::GfSumFn Dispatch::gf64Sum()
+{
+    return reinterpret_cast<GfSumFn>(current(Gf64Sum));
+}
+
+bool Dispatch::configure(const QString &overrides)
+{
+    ensureInit();
+    const bool ok = applyOverrides(overrides);
+    // Переменная окружения главнее настроек — удобно для A/B-сравнений
+    applyOverrides(QString::fromLocal8Bit(qgetenv("DIPLOM_KERNELS")));
+    return ok;
+}
+
+bool Dispatch::select(Primitive primitive, const QString &kernel)
+{
+    ensureInit();
+    return selectKernel(primitive, kernel);
+}
+
+QString Dispatch::primitiveName(Primitive primitive)
+{
+    return QString::fromLatin1(registry[primitive].name);
+}
+
+QString Dispatch::selected(Primitive primitive)
+{
+    ensureInit();
+    return QString::fromLatin1(registry[primitive].kernels[selectedIndex[primitive].load()].name);
+}
+
+QStringList Dispatch::available(Primitive primitive)
+{
+    QStringList result;
+    const Registry &r = registry[primitive];
+    for (int i = 0; i < r.count; ++i) {
+        if (supported(r.kernels[i]))
+            result << QString::fromLatin1(r.kernels[i].name);
+    }
+    return result;
+}
+
+QString Dispatch::report()
+{
+    const QStringList features = CpuFeatures::host().names();
+    QString text = QStringLiteral("Процессор: %1\n")
+                       .arg(features.isEmpty() ? QStringLiteral("без расширений") : features.join(' '));
+    for (int p = 0; p < PrimitiveCount; ++p) {
+        text += QStringLiteral("%1: %2 (доступно: %3)\n")
+                    .arg(primitiveName(Primitive(p)), selected(Primitive(p)),
+                         available(Primitive(p)).join(", "));
+    }
+    return text;
+}
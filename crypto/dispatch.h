@@ -0,0 +1,65 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/dispatch.h — выбор реализации (ядра) для каждого примитива
+//
+// Для каждого примитива зарегистрировано несколько ядер, от быстрого
+// к эталонному, с требованиями к процессору. При первом обращении
+// выбирается первое ядро, поддерживаемое процессором (CpuFeatures).
+//
+// Выбор можно переопределить строкой вида "kuznechik=ref,magma=table":
+// из настроек приложения через configure() или переменной окружения
+// DIPLOM_KERNELS (она главнее). Развёрнутые ключи (KuznechikKey,
+// MagmaKey) запоминают ядро при создании, поэтому переопределение
+// действует на ключи, установленные после него.
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <QString>
+#include <QStringList>
+
+class Dispatch
+{
+public:
+    enum Primitive {
+        KuznechikEncrypt,
+        MagmaEncrypt,
+        StreebogLps,
+        Gf128Sum,
+        Gf64Sum,
+        PrimitiveCount
+    };
+
+    // roundKeys — 10 раундовых ключей по 16 байт подряд
+    using KuznechikEncryptFn = void (*)(const quint8 *roundKeys, const quint8 *in, quint8 *out);
+    // key — 8 подключей K1..K8
+    using MagmaEncryptFn = void (*)(const quint32 *key, const quint8 *in, quint8 *out);
+    // Преобразование LPS Стрибога над 64 байтами
+    using StreebogLpsFn = void (*)(const unsigned char *in, unsigned long long *out);
+    // sum ⊕= Σ h_i ⊗ x_i в GF(2^128) или GF(2^64) для имитовставки MGM (mgm.h)
+    using GfSumFn = void (*)(const quint8 *h, const quint8 *x, int blocks, quint8 *sum);
+
+    static KuznechikEncryptFn kuznechikEncrypt();
+    static MagmaEncryptFn magmaEncrypt();
+    static StreebogLpsFn streebogLps();
+    static GfSumFn gf128Sum();
+    static GfSumFn gf64Sum();
+
+    // Применить переопределения; false — если часть из них не распознана
+    static bool configure(const QString &overrides);
+    static bool select(Primitive primitive, const QString &kernel);
+
+    static QString primitiveName(Primitive primitive);
+    static QString selected(Primitive primitive);
+    // Ядра, пригодные для этого процессора, от предпочтительного
+    static QStringList available(Primitive primitive);
+    // Сводка для окна настроек и --version
+    static QString report();
+};
+
+#endif // DISPATCH_H
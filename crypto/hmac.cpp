@@ -0,0 +1,48 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/hmac.cpp
+#include "hmac.h"
+#include "striborg.h"
+
+QByteArray streebog256(const QByteArray &data)
+{
+    Streebog hash(256);
+    QByteArray input = data;
+    unsigned char *h = hash.hash(reinterpret_cast<unsigned char *>(input.data()), input.size());
+    QByteArray result(reinterpret_cast<char *>(h), 32);
+    free(h);
+    return result;
+}
+
+QByteArray hmacStreebog(const QByteArray &data, const QByteArray &key)
+{
+    // Ключ должен быть 32 байта (Streebog-256)
+    QByteArray k = key;
+    if (k.size() > 32) {
+        k = streebog256(k);
+    } else if (k.size() < 32) {
+        k.resize(32, 0);
+    }
+
+    // iPad: 32 байта: key XOR 0x36
+    QByteArray iPad(32, 0x36);
+    for (int i = 0; i < 32; ++i) {
+        iPad[i] ^= k[i];
+    }
+
+    // oPad: key XOR 0x5C
+    QByteArray oPad(32, 0x5C);
+    for (int i = 0; i < 32; ++i) {
+        oPad[i] ^= k[i];
+    }
+
+    // HMAC = H(oPad || H(iPad || data))
+    const QByteArray innerHash = streebog256(iPad + data);
+    return streebog256(oPad + innerHash);
+}
@@ -0,0 +1,21 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/hmac.h — HMAC на основе Стрибога-256
+#ifndef HMAC_H
+#define HMAC_H
+
+#include <QByteArray>
+
+// HMAC = H(oPad || H(iPad || data)), ключ приводится к 32 байтам
+QByteArray hmacStreebog(const QByteArray &data, const QByteArray &key);
+
+// Стрибог-256 от произвольных данных
+QByteArray streebog256(const QByteArray &data);
+
+#endif // HMAC_H
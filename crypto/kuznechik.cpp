@@ -11,8 +11,9 @@
 #include <cstring>
 #include <array>
 
-// Таблица S-блока (S) и обратного S-блока (S⁻¹) — константы ГОСТ Р 34.12-2015
-static const quint8 Sbox[256] = {
+// Таблица S-блока (π) и обратного S-блока (π⁻¹) — константы ГОСТ Р 34.12-2015, п. 4.1.1
+// (та же подстановка π используется в Стрибоге, см. striborg.cpp)
+constexpr quint8 Sbox[256] = {
     0xFC, 0xEE, 0xDD, 0x11, 0xCF, 0x6E, 0x31, 0x16, 0xFB, 0xC4, 0xFA, 0xDA, 0x23, 0xC5, 0x04, 0x4D,
     0xE9, 0x77, 0xF0, 0xDB, 0x93, 0x2E, 0x99, 0xBA, 0x17, 0x36, 0xF1, 0xBB, 0x14, 0xCD, 0x5F, 0xC1,
     0xF9, 0x18, 0x65, 0x5A, 0xE2, 0x5C, 0xEF, 0x21, 0x81, 0x1C, 0x3C, 0x42, 0x8B, 0x01, 0x8E, 0x4F,
@@ -22,220 +23,328 @@ static const quint8 Sbox[256] = {
     0x15, 0xA1, 0x96, 0x29, 0x10, 0x7B, 0x9A, 0xC7, 0xF3, 0x91, 0x78, 0x6F, 0x9D, 0x9E, 0xB2, 0xB1,
     0x32, 0x75, 0x19, 0x3D, 0xFF, 0x35, 0x8A, 0x7E, 0x6D, 0x54, 0xC6, 0x80, 0xC3, 0xBD, 0x0D, 0x57,
     0xDF, 0xF5, 0x24, 0xA9, 0x3E, 0xA8, 0x43, 0xC9, 0xD7, 0x79, 0xD6, 0xF6, 0x7C, 0x22, 0xB9, 0x03,
-    0xE0, 0x0F, 0xEC, 0xDE, 0x7A, 0x97, 0xAC, 0x73, 0x40, 0x85, 0x48, 0x0A, 0xD0, 0x49, 0xA7, 0x27,
-    0x95, 0x83, 0x26, 0x9F, 0x37, 0x52, 0x8C, 0x58, 0x38, 0x7A, 0x1A, 0x84, 0x60, 0x0A, 0x20, 0x69,
-    0xD5, 0x30, 0x3E, 0x49, 0x36, 0x7E, 0x62, 0x4F, 0x81, 0x33, 0x66, 0x3F, 0x4E, 0x62, 0x6A, 0x3B,
-    0x54, 0x48, 0x30, 0x4D, 0x19, 0x1C, 0x50, 0x4E, 0x40, 0x48, 0x2C, 0x43, 0x72, 0x6B, 0x32, 0x45,
-    0x40, 0x4F, 0x24, 0x6D, 0x12, 0x42, 0x39, 0x21, 0x19, 0x2F, 0x3F, 0x24, 0x39, 0x10, 0x3A, 0x47,
-    0x28, 0x5C, 0x4F, 0x44, 0x1F, 0x18, 0x58, 0x59, 0x2B, 0x10, 0x3E, 0x42, 0x38, 0x24, 0x38, 0x31,
-    0x33, 0x3B, 0x44, 0x49, 0x3E, 0x2D, 0x30, 0x3B, 0x53, 0x60, 0x59, 0x4F, 0x44, 0x51, 0x2E, 0x3E
+    0xE0, 0x0F, 0xEC, 0xDE, 0x7A, 0x94, 0xB0, 0xBC, 0xDC, 0xE8, 0x28, 0x50, 0x4E, 0x33, 0x0A, 0x4A,
+    0xA7, 0x97, 0x60, 0x73, 0x1E, 0x00, 0x62, 0x44, 0x1A, 0xB8, 0x38, 0x82, 0x64, 0x9F, 0x26, 0x41,
+    0xAD, 0x45, 0x46, 0x92, 0x27, 0x5E, 0x55, 0x2F, 0x8C, 0xA3, 0xA5, 0x7D, 0x69, 0xD5, 0x95, 0x3B,
+    0x07, 0x58, 0xB3, 0x40, 0x86, 0xAC, 0x1D, 0xF7, 0x30, 0x37, 0x6B, 0xE4, 0x88, 0xD9, 0xE7, 0x89,
+    0xE1, 0x1B, 0x83, 0x49, 0x4C, 0x3F, 0xF8, 0xFE, 0x8D, 0x53, 0xAA, 0x90, 0xCA, 0xD8, 0x85, 0x61,
+    0x20, 0x71, 0x67, 0xA4, 0x2D, 0x2B, 0x09, 0x5B, 0xCB, 0x9B, 0x25, 0xD0, 0xBE, 0xE5, 0x6C, 0x52,
+    0x59, 0xA6, 0x74, 0xD2, 0xE6, 0xF4, 0xB4, 0xC0, 0xD1, 0x66, 0xAF, 0xC2, 0x39, 0x4B, 0x63, 0xB6
 };
 
-static const quint8 SboxInv[256] = {
-    0xA5, 0x2D, 0x32, 0x8F, 0x0B, 0x6D, 0x51, 0x19, 0x09, 0x7D, 0x5F, 0x62, 0x25, 0x55, 0x46, 0x5D,
-    0x0E, 0x1F, 0x35, 0x6F, 0x45, 0x20, 0x78, 0x4B, 0x3D, 0x44, 0x7E, 0x5B, 0x39, 0x74, 0x3F, 0x16,
-    0x6E, 0x2C, 0x08, 0x66, 0x13, 0x0D, 0x6B, 0x4E, 0x7B, 0x11, 0x41, 0x3E, 0x23, 0x75, 0x67, 0x3A,
-    0x02, 0x01, 0x58, 0x03, 0x17, 0x37, 0x27, 0x79, 0x26, 0x22, 0x40, 0x71, 0x1E, 0x1D, 0x30, 0x18,
-    0x52, 0x43, 0x4F, 0x60, 0x0C, 0x34, 0x1A, 0x28, 0x4A, 0x05, 0x0A, 0x5C, 0x50, 0x21, 0x10, 0x12,
-    0x53, 0x0F, 0x24, 0x14, 0x61, 0x2B, 0x1C, 0x2F, 0x4D, 0x76, 0x5E, 0x64, 0x29, 0x42, 0x77, 0x1B,
-    0x07, 0x68, 0x57, 0x3B, 0x2A, 0x72, 0x63, 0x3C, 0x04, 0x70, 0x6C, 0x00, 0x56, 0x65, 0x36, 0x6A,
-    0x2E, 0x54, 0x7C, 0x38, 0x4C, 0x47, 0x69, 0x06, 0x48, 0x31, 0x49, 0x59, 0x73, 0x33, 0x7F, 0x7A,
-    0x5A, 0x15, 0x2F, 0x3B, 0x18, 0x7C, 0x2B, 0x5E, 0x3F, 0x10, 0x75, 0x64, 0x30, 0x47, 0x12, 0x15,
-    0x5C, 0x27, 0x49, 0x01, 0x0E, 0x7D, 0x21, 0x6B, 0x69, 0x4F, 0x09, 0x5F, 0x43, 0x38, 0x36, 0x3D,
-    0x2A, 0x79, 0x06, 0x4E, 0x78, 0x35, 0x55, 0x66, 0x31, 0x1E, 0x26, 0x57, 0x1B, 0x25, 0x60, 0x07,
-    0x4D, 0x58, 0x6D, 0x0A, 0x42, 0x33, 0x28, 0x71, 0x0C, 0x67, 0x44, 0x45, 0x4B, 0x73, 0x6F, 0x74,
-    0x1A, 0x32, 0x61, 0x14, 0x19, 0x39, 0x20, 0x6A, 0x24, 0x70, 0x76, 0x1C, 0x16, 0x23, 0x1D, 0x05,
-    0x54, 0x51, 0x59, 0x04, 0x17, 0x46, 0x3A, 0x4C, 0x41, 0x08, 0x34, 0x37, 0x50, 0x0D, 0x4A, 0x1F,
-    0x22, 0x68, 0x0F, 0x56, 0x48, 0x29, 0x65, 0x3C, 0x11, 0x2D, 0x5B, 0x00, 0x62, 0x7A, 0x72, 0x52,
-    0x7B, 0x5A, 0x5D, 0x13, 0x6C, 0x77, 0x03, 0x0B, 0x7F, 0x6E, 0x2C, 0x3E, 0x7E, 0x24, 0x40, 0x02
+constexpr quint8 SboxInv[256] = {
+    0xA5, 0x2D, 0x32, 0x8F, 0x0E, 0x30, 0x38, 0xC0, 0x54, 0xE6, 0x9E, 0x39, 0x55, 0x7E, 0x52, 0x91,
+    0x64, 0x03, 0x57, 0x5A, 0x1C, 0x60, 0x07, 0x18, 0x21, 0x72, 0xA8, 0xD1, 0x29, 0xC6, 0xA4, 0x3F,
+    0xE0, 0x27, 0x8D, 0x0C, 0x82, 0xEA, 0xAE, 0xB4, 0x9A, 0x63, 0x49, 0xE5, 0x42, 0xE4, 0x15, 0xB7,
+    0xC8, 0x06, 0x70, 0x9D, 0x41, 0x75, 0x19, 0xC9, 0xAA, 0xFC, 0x4D, 0xBF, 0x2A, 0x73, 0x84, 0xD5,
+    0xC3, 0xAF, 0x2B, 0x86, 0xA7, 0xB1, 0xB2, 0x5B, 0x46, 0xD3, 0x9F, 0xFD, 0xD4, 0x0F, 0x9C, 0x2F,
+    0x9B, 0x43, 0xEF, 0xD9, 0x79, 0xB6, 0x53, 0x7F, 0xC1, 0xF0, 0x23, 0xE7, 0x25, 0x5E, 0xB5, 0x1E,
+    0xA2, 0xDF, 0xA6, 0xFE, 0xAC, 0x22, 0xF9, 0xE2, 0x4A, 0xBC, 0x35, 0xCA, 0xEE, 0x78, 0x05, 0x6B,
+    0x51, 0xE1, 0x59, 0xA3, 0xF2, 0x71, 0x56, 0x11, 0x6A, 0x89, 0x94, 0x65, 0x8C, 0xBB, 0x77, 0x3C,
+    0x7B, 0x28, 0xAB, 0xD2, 0x31, 0xDE, 0xC4, 0x5F, 0xCC, 0xCF, 0x76, 0x2C, 0xB8, 0xD8, 0x2E, 0x36,
+    0xDB, 0x69, 0xB3, 0x14, 0x95, 0xBE, 0x62, 0xA1, 0x3B, 0x16, 0x66, 0xE9, 0x5C, 0x6C, 0x6D, 0xAD,
+    0x37, 0x61, 0x4B, 0xB9, 0xE3, 0xBA, 0xF1, 0xA0, 0x85, 0x83, 0xDA, 0x47, 0xC5, 0xB0, 0x33, 0xFA,
+    0x96, 0x6F, 0x6E, 0xC2, 0xF6, 0x50, 0xFF, 0x5D, 0xA9, 0x8E, 0x17, 0x1B, 0x97, 0x7D, 0xEC, 0x58,
+    0xF7, 0x1F, 0xFB, 0x7C, 0x09, 0x0D, 0x7A, 0x67, 0x45, 0x87, 0xDC, 0xE8, 0x4F, 0x1D, 0x4E, 0x04,
+    0xEB, 0xF8, 0xF3, 0x3E, 0x3D, 0xBD, 0x8A, 0x88, 0xDD, 0xCD, 0x0B, 0x13, 0x98, 0x02, 0x93, 0x80,
+    0x90, 0xD0, 0x24, 0x34, 0xCB, 0xED, 0xF4, 0xCE, 0x99, 0x10, 0x44, 0x40, 0x92, 0x3A, 0x01, 0x26,
+    0x12, 0x1A, 0x48, 0x68, 0xF5, 0x81, 0x8B, 0xC7, 0xD6, 0x20, 0x0A, 0x08, 0x00, 0x4C, 0xD7, 0x74
 };
 
-Kuznechik::Kuznechik(QObject *parent) : QObject(parent), m_keySet(false), m_roundKeysGenerated(false)
+// Коэффициенты линейного преобразования ℓ (п. 4.1.2), в порядке a15 … a0
+constexpr quint8 LCoeffs[16] = {
+    148, 32, 133, 16, 194, 192, 1, 251, 1, 192, 194, 16, 133, 32, 148, 1
+};
+
+// Умножение в поле GF(2^8) по модулю p(x) = x^8 + x^7 + x^6 + x + 1
+static constexpr quint8 gfMul(quint8 a, quint8 b)
 {
-    initializeSboxes();
+    quint8 result = 0;
+    while (b) {
+        if (b & 1)
+            result ^= a;
+        a = (a & 0x80) ? static_cast<quint8>((a << 1) ^ 0xC3) : static_cast<quint8>(a << 1);
+        b >>= 1;
+    }
+    return result;
 }
 
-Kuznechik::~Kuznechik() = default;
+namespace {
 
-void Kuznechik::initializeSboxes()
+// Байты блока храним в порядке записи стандарта: [0] — старший (a15)
+using Block = std::array<quint8, 16>;
+
+// Преобразования ГОСТ Р 34.12-2015, п. 4.1
+// X[k]: сложение с раундовым ключом
+void x(Block &a, const quint8 *k)
 {
-    memcpy(Sbox, ::Sbox, 256);
-    memcpy(SboxInv, ::SboxInv, 256);
+    for (int i = 0; i < 16; ++i)
+        a[i] ^= k[i];
 }
-bool Kuznechik::setKey(const QByteArray &key)
+
+// L = R^16, где R(a15..a0) = ℓ(a15..a0) || a15 || … || a1
+void l(Block &a)
 {
-    if (key.size() != 32) {
-        m_keySet = false;
-        return false; // Ключ должен быть ровно 256 бит (32 байта)
+    for (int round = 0; round < 16; ++round) {
+        quint8 t = 0;
+        for (int i = 0; i < 16; ++i)
+            t ^= gfMul(a[i], LCoeffs[i]);
+        memmove(a.data() + 1, a.data(), 15);
+        a[0] = t;
     }
-
-    m_key = key;
-    m_keySet = true;
-    m_roundKeysGenerated = false; // Сбросим флаг — нужно перегенерировать
-    return true;
 }
 
-// Вспомогательная функция: L преобразование
-quint64 Kuznechik::l(const quint64 &r) const
+// L⁻¹ = (R⁻¹)^16, где R⁻¹(a15..a0) = a14 || … || a0 || ℓ(a14, …, a0, a15)
+void l_inv(Block &a)
 {
-    quint64 result = 0;
-    for (int i = 0; i < 8; ++i) {
-        quint8 byte = (r >> (8 * i)) & 0xFF;
-        result ^= (quint64)byte << (8 * i);
+    for (int round = 0; round < 16; ++round) {
+        const quint8 a15 = a[0];
+        memmove(a.data(), a.data() + 1, 15);
+        a[15] = a15;
+        quint8 t = 0;
+        for (int i = 0; i < 16; ++i)
+            t ^= gfMul(a[i], LCoeffs[i]);
+        a[15] = t;
     }
-    return result;
 }
 
-// Прямое S-преобразование (байт за байтом)
-quint64 Kuznechik::pi(const quint64 &a) const
+// Строка таблицы: 16 байт блока в порядке записи стандарта; слова из неё
+// читаются memcpy, поэтому XOR не зависит от endianness
+struct LsRow
 {
-    quint64 result = 0;
-    for (int i = 0; i < 8; ++i) {
-        quint8 byte = (a >> (8 * i)) & 0xFF;
-        result |= (quint64)Sbox[byte] << (8 * i);
-    }
-    return result;
-}
+    alignas(16) quint8 b[16];
+};
+
+// LS(a) = ⊕ L(π(a_i) на позиции i): L линейно, поэтому раунд сводится
+// к 16 выборкам из таблиц и XOR. То же для L⁻¹ и π⁻¹ при расшифровании
+struct LsTable
+{
+    LsRow row[16][256];
+};
 
-// Обратное S-преобразование
-quint64 Kuznechik::pi_inv(const quint64 &a) const
+// Столбцы L (или L⁻¹): образ блока с единицей в байте i. L линейно и над
+// GF(2^8), поэтому L(u на позиции i) = u · столбец i
+struct LColumns
 {
-    quint64 result = 0;
-    for (int i = 0; i < 8; ++i) {
-        quint8 byte = (a >> (8 * i)) & 0xFF;
-        result |= (quint64)SboxInv[byte] << (8 * i);
+    quint8 c[16][16];
+};
+
+constexpr LColumns lColumns(bool inverse)
+{
+    LColumns cols{};
+    for (int i = 0; i < 16; ++i) {
+        quint8 a[16] = {};
+        a[i] = 1;
+        for (int round = 0; round < 16; ++round) {
+            // R и R⁻¹ — как в l() и l_inv()
+            if (inverse) {
+                const quint8 a15 = a[0];
+                for (int j = 0; j < 15; ++j)
+                    a[j] = a[j + 1];
+                a[15] = a15;
+            }
+            quint8 t = 0;
+            for (int j = 0; j < 16; ++j)
+                t ^= gfMul(a[j], LCoeffs[j]);
+            if (inverse) {
+                a[15] = t;
+            } else {
+                for (int j = 15; j > 0; --j)
+                    a[j] = a[j - 1];
+                a[0] = t;
+            }
+        }
+        for (int j = 0; j < 16; ++j)
+            cols.c[i][j] = a[j];
     }
-    return result;
+    return cols;
 }
 
-// Генерация 10 раундовых ключей (выполняется один раз при шифровании)
-void Kuznechik::generateRoundKeys() const
+// Таблица по подстановке sbox и столбцам L или L⁻¹. Умножение на
+// коэффициент столбца для всех 256 значений — по одному XOR на значение:
+// mul[u] = mul[u без младшего бита] ⊕ mul[младший бит u]
+constexpr LsTable makeLsTable(const quint8 (&sbox)[256], bool inverse)
 {
-    if (m_roundKeysGenerated || !m_keySet)
-        return;
-
-    quint64 K1 = 0, K2 = 0;
-    for (int i = 0; i < 8; ++i) {
-        K1 |= (quint64)(quint8)m_key[i] << (8 * i);
-        K2 |= (quint64)(quint8)m_key[8 + i] << (8 * i);
+    const LColumns cols = lColumns(inverse);
+    LsTable table{};
+    for (int i = 0; i < 16; ++i) {
+        for (int j = 0; j < 16; ++j) {
+            quint8 mul[256] = {};
+            for (int k = 0; k < 8; ++k)
+                mul[1 << k] = gfMul(static_cast<quint8>(1 << k), cols.c[i][j]);
+            for (int u = 3; u < 256; ++u) {
+                const int low = u & -u;
+                if (u != low)
+                    mul[u] = mul[u ^ low] ^ mul[low];
+            }
+            for (int v = 0; v < 256; ++v)
+                table.row[i][v].b[j] = mul[sbox[v]];
+        }
     }
+    return table;
+}
 
-    const quint64 C[10] = {
-        0, 1, 2, 3, 4, 5, 6, 7, 8, 9
-    };
+// Вычисляются при компиляции и лежат в .rodata: ни инициализации при
+// запуске, ни копий в объектах, страницы общие у всех процессов
+constexpr LsTable LsEncrypt = makeLsTable(Sbox, false);
+constexpr LsTable LsDecrypt = makeLsTable(SboxInv, true);
 
-    quint64 K[4] = {K1, K2, 0, 0};
+// ⊕ строк таблицы по байтам b
+inline void lsLookup(const LsTable &t, const quint8 *b, quint64 *out)
+{
+    quint64 r0 = 0, r1 = 0;
+    for (int j = 0; j < 16; ++j) {
+        quint64 w[2];
+        memcpy(w, t.row[j][b[j]].b, 16);
+        r0 ^= w[0];
+        r1 ^= w[1];
+    }
+    out[0] = r0;
+    out[1] = r1;
+}
 
-    for (int i = 0; i < 8; ++i) {
-        quint64 N = K[1];
-        quint64 M = K[0] ^ C[i];
-        quint64 temp1 = pi(N);
-        quint64 temp2 = l(temp1);
+} // namespace
 
-        K[2] = temp2 ^ M;
-        K[3] = temp1;
+// Развёртка ключа (п. 4.3): K1 || K2 = ключ, далее по 8 раундов сети Фейстеля
+// с константами C_i = L(Vec128(i)) на каждую следующую пару раундовых ключей
+KuznechikKey::KuznechikKey(const QByteArray &key)
+{
+    if (key.size() != KeySize)
+        return;
 
-        m_roundKeys[i] = {K[2], K[3]}; // high = K[2], low = K[3]
+    Block a1, a0;
+    memcpy(a1.data(), key.constData(), 16);
+    memcpy(a0.data(), key.constData() + 16, 16);
+    memcpy(m_roundKeys, a1.data(), 16);
+    memcpy(m_roundKeys + 16, a0.data(), 16);
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 8; ++j) {
+            Block c{};
+            c[15] = static_cast<quint8>(8 * i + j + 1);
+            l(c);
+
+            Block t = a1;
+            x(t, c.data());
+            for (quint8 &v : t)
+                v = Sbox[v];
+            l(t);
+            x(t, a0.data());
+
+            a0 = a1;
+            a1 = t;
+        }
+        memcpy(m_roundKeys + 16 * (2 + 2 * i), a1.data(), 16);
+        memcpy(m_roundKeys + 16 * (3 + 2 * i), a0.data(), 16);
+    }
+    for (int i = 0; i < 10; ++i) {
+        Block k;
+        memcpy(k.data(), m_roundKeys + 16 * i, 16);
+        l_inv(k);
+        memcpy(m_decryptKeys + 16 * i, k.data(), 16);
+    }
+    m_encrypt = Dispatch::kuznechikEncrypt();
+}
 
-        K[0] = K[2];
-        K[1] = K[3];
+// Расшифрование по таблице L⁻¹π⁻¹ (как у Kuznechik::encryptBlockTable):
+// раунд X[K]π⁻¹L⁻¹ переписан как L⁻¹X[K]π⁻¹ = (L⁻¹π⁻¹) ⊕ L⁻¹(K), поэтому
+// ключи раундов 2…9 хранятся уже умноженными на L⁻¹
+void KuznechikKey::decryptBlock(const quint8 *in, quint8 *out) const
+{
+    quint8 b[16];
+    for (int j = 0; j < 16; ++j)
+        b[j] = Sbox[in[j] ^ m_roundKeys[16 * 9 + j]];
+
+    // Первое L⁻¹ без π⁻¹: π в b сокращается с π⁻¹ таблицы
+    quint64 a[2], k[2];
+    lsLookup(LsDecrypt, b, a);
+    for (int i = 8; i >= 1; --i) {
+        memcpy(b, a, 16);
+        lsLookup(LsDecrypt, b, a);
+        memcpy(k, m_decryptKeys + 16 * i, 16);
+        a[0] ^= k[0];
+        a[1] ^= k[1];
     }
 
-    m_roundKeys[8] = {K[0], K[1]};
-    m_roundKeys[9] = {K[1], K[0]};
+    memcpy(b, a, 16);
+    for (int j = 0; j < 16; ++j)
+        out[j] = SboxInv[b[j]] ^ m_roundKeys[j];
+}
 
-    m_roundKeysGenerated = true;
+Kuznechik::Kuznechik(QObject *parent)
+    : QObject(parent)
+{
 }
-QByteArray Kuznechik::encryptBlock(const QByteArray &block) const
+
+Kuznechik::~Kuznechik() = default;
+
+bool Kuznechik::setKey(const QByteArray &key)
 {
-    if (!m_keySet || block.size() != 16) {
-        return QByteArray(); // Ошибка: ключ не установлен или блок ≠ 16 байт
-    }
+    m_schedule = KuznechikKey(key);
+    return m_schedule.isValid(); // Ключ должен быть ровно 256 бит (32 байта)
+}
 
-    if (!m_roundKeysGenerated) {
-        generateRoundKeys();
-    }
+void Kuznechik::encryptBlockRef(const quint8 *roundKeys, const quint8 *in, quint8 *out)
+{
+    Block a;
+    memcpy(a.data(), in, 16);
 
-    // Собираем входной блок в два 64-битных слова: P и Q
-    quint64 P = 0, Q = 0;
-    for (int i = 0; i < 8; ++i) {
-        P |= (quint64)(quint8)block[i] << (8 * i);
-        Q |= (quint64)(quint8)block[8 + i] << (8 * i);
+    // 9 раундов LSX, затем X с последним ключом
+    for (int i = 0; i < 9; ++i) {
+        x(a, roundKeys + 16 * i);
+        for (int j = 0; j < 16; ++j)
+            a[j] = Sbox[a[j]];
+        l(a);
     }
+    for (int j = 0; j < 16; ++j)
+        out[j] = a[j] ^ roundKeys[16 * 9 + j];
+}
 
-    // 9 раундов шифрования
+void Kuznechik::encryptBlockTable(const quint8 *roundKeys, const quint8 *in, quint8 *out)
+{
+    quint64 a[2], k[2];
+    memcpy(a, in, 16);
     for (int i = 0; i < 9; ++i) {
-        quint64 K_i_high = m_roundKeys[i].high;
+        memcpy(k, roundKeys + 16 * i, 16);
+        a[0] ^= k[0];
+        a[1] ^= k[1];
 
-        quint64 temp = pi(P ^ K_i_high);
-        temp = l(temp);
-        temp ^= Q;
-        Q = P;
-        P = temp;
+        quint8 b[16];
+        memcpy(b, a, 16);
+        lsLookup(LsEncrypt, b, a);
     }
+    memcpy(k, roundKeys + 16 * 9, 16);
+    a[0] ^= k[0];
+    a[1] ^= k[1];
+    memcpy(out, a, 16);
+}
 
-    // Последний раунд: только перестановка
-    P ^= m_roundKeys[9].high;
-    Q ^= m_roundKeys[9].low;
-
-    // Собираем результат
-    QByteArray result;
-    result.resize(16);
-    for (int i = 0; i < 8; ++i) {
-        result[i] = (P >> (8 * i)) & 0xFF;
-        result[8 + i] = (Q >> (8 * i)) & 0xFF;
+QByteArray Kuznechik::encryptBlock(const QByteArray &block) const
+{
+    if (!m_schedule.isValid() || block.size() != 16) {
+        return QByteArray(); // Ошибка: ключ не установлен или блок ≠ 16 байт
     }
 
+    QByteArray result(16, 0);
+    encryptBlock(reinterpret_cast<const quint8 *>(block.constData()),
+                 reinterpret_cast<quint8 *>(result.data()));
     return result;
 }
 
 QByteArray Kuznechik::decryptBlock(const QByteArray &block) const
 {
-    if (!m_keySet || block.size() != 16) {
+    if (!m_schedule.isValid() || block.size() != 16) {
         return QByteArray(); // Ошибка
     }
 
-    if (!m_roundKeysGenerated) {
-        generateRoundKeys();
-    }
-
-    // Собираем блок в P и Q
-    quint64 P = 0, Q = 0;
-    for (int i = 0; i < 8; ++i) {
-        P |= (quint64)(quint8)block[i] << (8 * i);
-        Q |= (quint64)(quint8)block[8 + i] << (8 * i);
-    }
-
-    // Обратный порядок раундовых ключей
-
-    P ^= m_roundKeys[9].high;
-    Q ^= m_roundKeys[9].low;
-
-    for (int i = 8; i >= 0; --i) {
-        quint64 K_i_high = m_roundKeys[i].high;
-
-        quint64 temp = Q;
-        Q = P;
-        P = temp;
-
-        quint64 temp2 = pi(P ^ K_i_high);
-        temp2 = l(temp2);
-        Q ^= temp2;
-    }
-
-    // Собираем расшифрованный блок
-    QByteArray result;
-    result.resize(16);
-    for (int i = 0; i < 8; ++i) {
-        result[i] = (P >> (8 * i)) & 0xFF;
-        result[8 + i] = (Q >> (8 * i)) & 0xFF;
-    }
-
+    QByteArray result(16, 0);
+    decryptBlock(reinterpret_cast<const quint8 *>(block.constData()),
+                 reinterpret_cast<quint8 *>(result.data()));
     return result;
 }
 
 // Дополнительный метод: проверка установки ключа
 bool Kuznechik::isKeySet() const
 {
-    return m_keySet;
+    return m_schedule.isValid();
 }
@@ -12,12 +12,52 @@
 
 #include <QObject>
 #include <QByteArray>
+#include "dispatch.h"
+
+// Развёрнутый ключ Кузнечика: раундовые ключи вычисляются сразу
+// в конструкторе и дальше не меняются. Объект не QObject и не держит
+// своих копий таблиц, поэтому один экземпляр читают без синхронизации
+// все потоки, шифрующие на этом ключе. Ядро (dispatch.h) запоминается
+// при создании.
+class alignas(64) KuznechikKey
+{
+public:
+    static constexpr int KeySize = 32;
+    static constexpr int BlockSize = 16;
+    // Блоков гаммы за проход CTR: строка кэша (traits.h)
+    static constexpr int BatchWidth = 4;
+
+    KuznechikKey() = default;
+    // Ключ не 32 байта — isValid() == false
+    explicit KuznechikKey(const QByteArray &key);
+
+    bool isValid() const { return m_encrypt != nullptr; }
+    int blockSize() const { return BlockSize; }
+
+    // in и out могут совпадать; ключ должен быть установлен
+    void encryptBlock(const quint8 *in, quint8 *out) const { m_encrypt(m_roundKeys, in, out); }
+    void decryptBlock(const quint8 *in, quint8 *out) const;
 
+    // 10 раундовых ключей по 16 байт подряд
+    const quint8 *roundKeys() const { return m_roundKeys; }
+
+private:
+    alignas(64) quint8 m_roundKeys[10 * BlockSize] = {};
+    // L⁻¹ от раундовых ключей — для табличного расшифрования
+    alignas(64) quint8 m_decryptKeys[10 * BlockSize] = {};
+    Dispatch::KuznechikEncryptFn m_encrypt = nullptr;
+};
+
+// Обёртка на QByteArray поверх KuznechikKey — для окон программы и тестов
 class Kuznechik : public QObject
 {
     Q_OBJECT
 
 public:
+    static constexpr int KeySize = KuznechikKey::KeySize;
+    static constexpr int BlockSize = KuznechikKey::BlockSize;
+    static constexpr int BatchWidth = KuznechikKey::BatchWidth;
+
     explicit Kuznechik(QObject *parent = nullptr);
     ~Kuznechik();
 
@@ -30,36 +70,23 @@ public:
     // Расшифровать один блок 16 байт
     QByteArray decryptBlock(const QByteArray &block) const;
 
+    // То же на сырых буферах (in и out могут совпадать, ключ должен быть установлен)
+    void encryptBlock(const quint8 *in, quint8 *out) const { m_schedule.encryptBlock(in, out); }
+    void decryptBlock(const quint8 *in, quint8 *out) const { m_schedule.decryptBlock(in, out); }
+
     // Проверка, установлен ли ключ
     bool isKeySet() const;
+    const KuznechikKey &schedule() const { return m_schedule; }
 
-private:
-    QByteArray m_key;           // 32 байта
-    bool m_keySet;
-
-    struct RoundKey {
-        quint64 high;
-        quint64 low;
-    };
-
-    mutable std::array<RoundKey, 10> m_roundKeys;
-
-    // Внутренние методы шифрования (реализуем далее)
-    quint64 l(const quint64 &r) const;
-    quint64 pi(const quint64 &a) const;
-    quint64 pi_inv(const quint64 &a) const;
-    void generateRoundKeys() const;
-    mutable bool m_roundKeysGenerated;
+    // Ядра зашифрования блока (см. dispatch.h): побайтовое эталонное
+    // и табличное, где S и L свёрнуты в 16 таблиц по 256 значений
+    static void encryptBlockRef(const quint8 *roundKeys, const quint8 *in, quint8 *out);
+    static void encryptBlockTable(const quint8 *roundKeys, const quint8 *in, quint8 *out);
 
-    // Вспомогательные таблицы (S-блок и др.)
-    quint8 Sbox[256];
-    quint8 SboxInv[256];
-
-    void initializeSboxes();
-
-public:
-        int blockSize() const { return 16; }
+    int blockSize() const { return BlockSize; }
 
+private:
+    KuznechikKey m_schedule;
 };
 
 #endif // KUZNECHIK_H
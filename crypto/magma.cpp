@@ -10,29 +10,59 @@
 #include <QtEndian>
 #include <cstring>
 
-// S-блок замены по ГОСТ Р 34.12-2015
-const quint8 Magma::S[8][16] = {
-    { 0xC, 0x5, 0x6, 0xB, 0x9, 0x0, 0xA, 0xD, 0x3, 0xE, 0xF, 0x8, 0x4, 0x7, 0x1, 0x2 },
-    { 0x6, 0x8, 0x2, 0x3, 0x9, 0xA, 0x5, 0xC, 0x1, 0xE, 0x4, 0x7, 0xB, 0xD, 0xF, 0x0 },
-    { 0xD, 0x3, 0x4, 0xF, 0x8, 0x1, 0xA, 0x6, 0x9, 0x0, 0x7, 0xC, 0xB, 0x5, 0xE, 0x2 },
-    { 0xB, 0x0, 0x6, 0x1, 0x5, 0xA, 0x8, 0xE, 0x3, 0xD, 0x7, 0xC, 0xF, 0x9, 0x2, 0x4 },
-    { 0x7, 0x2, 0xC, 0x5, 0x8, 0x4, 0x6, 0xB, 0x1, 0xA, 0x9, 0xE, 0x3, 0xF, 0x0, 0xD },
-    { 0x5, 0xB, 0x0, 0xC, 0x7, 0xA, 0x4, 0x8, 0xE, 0x2, 0xD, 0x6, 0xF, 0x1, 0x3, 0x9 },
-    { 0xA, 0xD, 0x0, 0x3, 0x6, 0x9, 0x2, 0x8, 0xB, 0x1, 0x7, 0x5, 0xF, 0x4, 0xE, 0xC },
-    { 0xC, 0x8, 0x2, 0x1, 0xD, 0x4, 0xF, 0x6, 0x7, 0x0, 0xA, 0x5, 0x3, 0xE, 0x9, 0xB }
+namespace {
+
+// S-блок замены по ГОСТ Р 34.12-2015 (п. 5.1.1): строка i — подстановка π_i,
+// применяемая к i-му (считая от младшего) 4-битному фрагменту
+constexpr quint8 S[8][16] = {
+    { 0xC, 0x4, 0x6, 0x2, 0xA, 0x5, 0xB, 0x9, 0xE, 0x8, 0xD, 0x7, 0x0, 0x3, 0xF, 0x1 },
+    { 0x6, 0x8, 0x2, 0x3, 0x9, 0xA, 0x5, 0xC, 0x1, 0xE, 0x4, 0x7, 0xB, 0xD, 0x0, 0xF },
+    { 0xB, 0x3, 0x5, 0x8, 0x2, 0xF, 0xA, 0xD, 0xE, 0x1, 0x7, 0x4, 0xC, 0x9, 0x6, 0x0 },
+    { 0xC, 0x8, 0x2, 0x1, 0xD, 0x4, 0xF, 0x6, 0x7, 0x0, 0xA, 0x5, 0x3, 0xE, 0x9, 0xB },
+    { 0x7, 0xF, 0x5, 0xA, 0x8, 0x1, 0x6, 0xD, 0x0, 0x9, 0x3, 0xE, 0xB, 0x4, 0x2, 0xC },
+    { 0x5, 0xD, 0xF, 0x6, 0x9, 0x2, 0xC, 0xA, 0xB, 0x7, 0x8, 0x1, 0x4, 0x3, 0xE, 0x0 },
+    { 0x8, 0xE, 0x2, 0x5, 0x6, 0x9, 0x1, 0xC, 0xF, 0x4, 0xB, 0x0, 0xD, 0xA, 0x3, 0x7 },
+    { 0x1, 0x7, 0xE, 0xD, 0x0, 0x5, 0x8, 0x3, 0x4, 0xF, 0xA, 0x6, 0x9, 0xC, 0xB, 0x2 }
 };
 
+constexpr quint32 rotl(quint32 value, int shift) {
+    return (value << shift) | (value >> (32 - shift));
+}
+
+// t и сдвиг на 11 для байта j суммы: π_{2j} и π_{2j+1} сразу на своих местах
+struct GTable
+{
+    quint32 t[4][256];
+};
+
+constexpr GTable makeGTable() {
+    GTable table{};
+    for (int j = 0; j < 4; ++j) {
+        for (int v = 0; v < 256; ++v) {
+            const quint32 sub = (static_cast<quint32>(S[2 * j][v & 0xF])
+                                 | static_cast<quint32>(S[2 * j + 1][v >> 4]) << 4) << (8 * j);
+            table.t[j][v] = rotl(sub, 11);
+        }
+    }
+    return table;
+}
+
+// Вычисляется при компиляции и лежит в .rodata
+constexpr GTable G = makeGTable();
+
+}
+
 // Циклический сдвиг влево на shift битов
 quint32 Magma::rotateLeft(quint32 value, int shift) {
-    return ((value << shift) | (value >> (32 - shift))) & 0xFFFFFFFF;
+    return rotl(value, shift);
 }
 
-// Раундовая функция f
+// Раундовая функция g[k]
 quint32 Magma::f(quint32 half, quint32 key) {
     quint32 sum = (half + key) & 0xFFFFFFFF;  // Сложение по модулю 2^32
     quint32 output = 0;
 
-    // Преобразование через S-блоки (по 4 бита)
+    // Преобразование t через S-блоки (по 4 бита)
     for (int i = 0; i < 8; ++i) {
         quint8 byte = (sum >> (4 * i)) & 0xF;
         output |= static_cast<quint32>(S[i][byte]) << (4 * i);
@@ -41,74 +71,109 @@ quint32 Magma::f(quint32 half, quint32 key) {
     return rotateLeft(output, 11);  // Сдвиг на 11 бит влево
 }
 
-// Конструктор
-Magma::Magma() {
-    keySchedule.fill(0);
+// Итерационный ключ раунда i (0..31): K1..K8 трижды, затем K8..K1
+quint32 Magma::roundKey(const quint32 *key, int i) {
+    return i < 24 ? key[i % 8] : key[7 - i % 8];
 }
 
-// Установка ключа (ожидается 32 байта = 256 бит)
-bool Magma::setKey(const QByteArray &key) {
-    if (key.size() != 32) {
-        return false;  // Ключ должен быть ровно 32 байта
+// K1 — старшие 32 бита ключа, т.е. первые 4 байта (big-endian)
+MagmaKey::MagmaKey(const QByteArray &key) {
+    if (key.size() != KeySize) {
+        return;  // Ключ должен быть ровно 32 байта
     }
-
-    // Используем 8 ключей по 32 бита (в порядке little-endian)
     for (int i = 0; i < 8; ++i) {
-        quint32 k = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(key.constData()) + i * 4);
-        keySchedule[i] = k;
+        m_key[i] = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(key.constData()) + i * 4);
     }
+    m_encrypt = Dispatch::magmaEncrypt();
+}
 
-    return true;
+void MagmaKey::decryptBlock(const quint8 *in, quint8 *out) const {
+    Magma::decryptBlockRef(m_key.data(), in, out);
 }
 
-// Шифрование 8-байтного блока
-QByteArray Magma::encryptBlock(const QByteArray &block) {
-    if (block.size() != 8) {
-        return QByteArray();  // Ошибка: блок не 8 байт
-    }
+bool Magma::setKey(const QByteArray &key) {
+    m_schedule = MagmaKey(key);
+    return m_schedule.isValid();
+}
 
-    // Читаем левую и правую части (32 бита каждая, little-endian)
-    quint32 left = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(block.constData()));
-    quint32 right = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(block.constData() + 4));
+// Шифрование 8-байтного блока: G*[K32] G[K31] … G[K1]
+void Magma::encryptBlockRef(const quint32 *key, const quint8 *in, quint8 *out) {
+    // a1 — старшая половина блока (первые 4 байта), a0 — младшая
+    quint32 a1 = qFromBigEndian<quint32>(in);
+    quint32 a0 = qFromBigEndian<quint32>(in + 4);
 
-    // 32 раунда шифрования
-    for (int i = 0; i < 32; ++i) {
-        quint32 temp = right;
-        right = left ^ f(right, keySchedule[i % 8]);
-        left = temp;
+    for (int i = 0; i < 31; ++i) {
+        quint32 temp = a0;
+        a0 = a1 ^ f(a0, roundKey(key, i));
+        a1 = temp;
     }
+    a1 ^= f(a0, roundKey(key, 31));
 
-    // Результат: right || left (в порядке следования байт)
-    QByteArray result;
-    result.resize(8);
-    qToLittleEndian<quint32>(right, reinterpret_cast<uchar*>(result.data()));
-    qToLittleEndian<quint32>(left, reinterpret_cast<uchar*>(result.data() + 4));
-
-    return result;
+    qToBigEndian<quint32>(a1, out);
+    qToBigEndian<quint32>(a0, out + 4);
 }
 
-// Расшифрование 8-байтного блока
-QByteArray Magma::decryptBlock(const QByteArray &block) {
-    if (block.size() != 8) {
-        return QByteArray();
+void Magma::encryptBlockTable(const quint32 *key, const quint8 *in, quint8 *out) {
+    auto g = [](quint32 half, quint32 k) {
+        const quint32 x = half + k;
+        return G.t[0][x & 0xFF] ^ G.t[1][(x >> 8) & 0xFF]
+             ^ G.t[2][(x >> 16) & 0xFF] ^ G.t[3][x >> 24];
+    };
+
+    quint32 a1 = qFromBigEndian<quint32>(in);
+    quint32 a0 = qFromBigEndian<quint32>(in + 4);
+
+    // Три прохода K1..K8, затем K8..K1; по два раунда за шаг без обмена половин
+    for (int pass = 0; pass < 3; ++pass) {
+        for (int i = 0; i < 8; i += 2) {
+            a1 ^= g(a0, key[i]);
+            a0 ^= g(a1, key[i + 1]);
+        }
     }
+    for (int i = 7; i > 0; i -= 2) {
+        a1 ^= g(a0, key[i]);
+        a0 ^= g(a1, key[i - 1]);
+    }
+
+    // После чётного числа раундов без обмена половины уже на местах G*
+    qToBigEndian<quint32>(a0, out);
+    qToBigEndian<quint32>(a1, out + 4);
+}
 
-    quint32 left = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(block.constData()));
-    quint32 right = qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(block.constData() + 4));
+// Расшифрование 8-байтного блока: G*[K1] G[K2] … G[K32]
+void Magma::decryptBlockRef(const quint32 *key, const quint8 *in, quint8 *out) {
+    quint32 a1 = qFromBigEndian<quint32>(in);
+    quint32 a0 = qFromBigEndian<quint32>(in + 4);
 
-    // 32 раунда расшифрования (в обратном порядке ключей)
-    for (int i = 31; i >= 0; --i) {
-        quint32 temp = left;
-        left = right ^ f(left, keySchedule[i % 8]);
-        right = temp;
+    for (int i = 31; i > 0; --i) {
+        quint32 temp = a0;
+        a0 = a1 ^ f(a0, roundKey(key, i));
+        a1 = temp;
     }
+    a1 ^= f(a0, roundKey(key, 0));
 
-    // Результат: left || right
-    QByteArray result;
-    result.resize(8);
-    qToLittleEndian<quint32>(left, reinterpret_cast<uchar*>(result.data()));
-    qToLittleEndian<quint32>(right, reinterpret_cast<uchar*>(result.data() + 4));
+    qToBigEndian<quint32>(a1, out);
+    qToBigEndian<quint32>(a0, out + 4);
+}
 
+QByteArray Magma::encryptBlock(const QByteArray &block) const {
+    if (!m_schedule.isValid() || block.size() != 8) {
+        return QByteArray();  // Ошибка: ключ не установлен или блок не 8 байт
+    }
+
+    QByteArray result(8, 0);
+    encryptBlock(reinterpret_cast<const quint8*>(block.constData()),
+                 reinterpret_cast<quint8*>(result.data()));
     return result;
 }
 
+QByteArray Magma::decryptBlock(const QByteArray &block) const {
+    if (!m_schedule.isValid() || block.size() != 8) {
+        return QByteArray();
+    }
+
+    QByteArray result(8, 0);
+    decryptBlock(reinterpret_cast<const quint8*>(block.constData()),
+                 reinterpret_cast<quint8*>(result.data()));
+    return result;
+}
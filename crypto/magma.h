@@ -11,21 +11,59 @@
 
 #include <QByteArray>
 #include <array>
+#include "dispatch.h"
+
+// Ключ Магмы K1..K8, разобранный сразу в конструкторе и неизменный:
+// один экземпляр читают без синхронизации все потоки на этом ключе.
+// Ядро (dispatch.h) запоминается при создании.
+class alignas(64) MagmaKey {
+public:
+    static constexpr int KeySize = 32;
+    static constexpr int BlockSize = 8;
+    // Блоков гаммы за проход CTR: строка кэша (traits.h)
+    static constexpr int BatchWidth = 8;
+
+    MagmaKey() = default;
+    explicit MagmaKey(const QByteArray &key);  // ключ не 32 байта — isValid() == false
+
+    bool isValid() const { return m_encrypt != nullptr; }
+    int blockSize() const { return BlockSize; }
+    void encryptBlock(const quint8 *in, quint8 *out) const { m_encrypt(m_key.data(), in, out); }
+    void decryptBlock(const quint8 *in, quint8 *out) const;
+    const quint32 *subkeys() const { return m_key.data(); }
+
+private:
+    std::array<quint32, 8> m_key{};
+    Dispatch::MagmaEncryptFn m_encrypt = nullptr;
+};
 
 class Magma {
 private:
-    std::array<quint32, 8> keySchedule;  // Раундовые ключи (8 * 32 бита = 256 бит)
-    static const quint8 S[8][16];       // S-блок замены (ГОСТ Р 34.12-2015)
-    quint32 f(quint32 half, quint32 key); // Функция f (раундовая)
-    quint32 rotateLeft(quint32 value, int shift); // Циклический сдвиг влево
+    MagmaKey m_schedule;
+    static quint32 f(quint32 half, quint32 key); // Функция f (раундовая)
+    static quint32 rotateLeft(quint32 value, int shift); // Циклический сдвиг влево
+    static quint32 roundKey(const quint32 *key, int i); // Итерационный ключ раунда i
 
 
 public:
-    Magma();
+    static constexpr int KeySize = MagmaKey::KeySize;
+    static constexpr int BlockSize = MagmaKey::BlockSize;
+    static constexpr int BatchWidth = MagmaKey::BatchWidth;
+
     bool setKey(const QByteArray &key);  // Установка 32-байтного ключа
-    QByteArray encryptBlock(const QByteArray &block); // Шифрование 8 байт
-    QByteArray decryptBlock(const QByteArray &block); // Расшифрование 8 байт
-    int blockSize() const { return 8; }
+    QByteArray encryptBlock(const QByteArray &block) const; // Шифрование 8 байт
+    QByteArray decryptBlock(const QByteArray &block) const; // Расшифрование 8 байт
+    // То же на сырых буферах
+    void encryptBlock(const quint8 *in, quint8 *out) const { m_schedule.encryptBlock(in, out); }
+    void decryptBlock(const quint8 *in, quint8 *out) const { m_schedule.decryptBlock(in, out); }
+    int blockSize() const { return BlockSize; }
+    const MagmaKey &schedule() const { return m_schedule; }
+
+    // Ядра зашифрования: эталонное и с таблицами, где подстановки
+    // соседних полубайтов и сдвиг на 11 объединены (4 таблицы по 256)
+    static void encryptBlockRef(const quint32 *key, const quint8 *in, quint8 *out);
+    static void encryptBlockTable(const quint32 *key, const quint8 *in, quint8 *out);
+    static void decryptBlockRef(const quint32 *key, const quint8 *in, quint8 *out);
 };
 
 #endif // MAGMA_H
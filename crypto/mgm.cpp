@@ -0,0 +1,169 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/mgm.cpp
+#include "mgm.h"
+
+#ifdef DIPLOM_HAVE_CLMUL
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define DIPLOM_TARGET_CLMUL
+#else
+#include <wmmintrin.h>
+#include <emmintrin.h>
+#define DIPLOM_TARGET_CLMUL __attribute__((target("pclmul,sse2")))
+#endif
+#endif
+
+namespace {
+
+// Младшие 64 бита произведения многочленов без ветвлений и таблиц
+// (время не зависит от данных): биты разнесены через три, и переносы
+// целочисленного умножения не задевают соседние значимые биты
+quint64 bmul64(quint64 x, quint64 y)
+{
+    const quint64 m0 = 0x1111111111111111ull, m1 = m0 << 1, m2 = m0 << 2, m3 = m0 << 3;
+    const quint64 x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+    const quint64 y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+    const quint64 z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    const quint64 z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    const quint64 z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    const quint64 z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+quint64 rev64(quint64 x)
+{
+    x = ((x >> 1) & 0x5555555555555555ull) | ((x & 0x5555555555555555ull) << 1);
+    x = ((x >> 2) & 0x3333333333333333ull) | ((x & 0x3333333333333333ull) << 2);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0full) | ((x & 0x0f0f0f0f0f0f0f0full) << 4);
+    x = ((x >> 8) & 0x00ff00ff00ff00ffull) | ((x & 0x00ff00ff00ff00ffull) << 8);
+    x = ((x >> 16) & 0x0000ffff0000ffffull) | ((x & 0x0000ffff0000ffffull) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+// Полное 128-битное произведение: старшая половина — через отражённые
+// множители
+void clmul64(quint64 x, quint64 y, quint64 &hi, quint64 &lo)
+{
+    lo = bmul64(x, y);
+    hi = rev64(bmul64(rev64(x), rev64(y))) >> 1;
+}
+
+// Приведение 256-битной суммы p[0] (старшее) … p[3] по модулю
+// x^128 + x^7 + x^2 + x + 1: x^128 ≡ x^7 + x^2 + x + 1, старшие слова
+// складываются вниз по одному
+void reduce128(const quint64 p[4], quint64 &hi, quint64 &lo)
+{
+    quint64 p1 = p[1], p2 = p[2], p3 = p[3];
+    // p[0] · x^192 ≡ p[0] · (x^7 + x^2 + x + 1) · x^64
+    p2 ^= p[0] ^ (p[0] << 1) ^ (p[0] << 2) ^ (p[0] << 7);
+    p1 ^= (p[0] >> 63) ^ (p[0] >> 62) ^ (p[0] >> 57);
+    p3 ^= p1 ^ (p1 << 1) ^ (p1 << 2) ^ (p1 << 7);
+    p2 ^= (p1 >> 63) ^ (p1 >> 62) ^ (p1 >> 57);
+    hi = p2;
+    lo = p3;
+}
+
+// По модулю x^64 + x^4 + x^3 + x + 1
+quint64 reduce64(quint64 hi, quint64 lo)
+{
+    // Старшие биты после первого шага — не больше четырёх
+    const quint64 carry = (hi >> 63) ^ (hi >> 61) ^ (hi >> 60);
+    lo ^= hi ^ (hi << 1) ^ (hi << 3) ^ (hi << 4);
+    return lo ^ carry ^ (carry << 1) ^ (carry << 3) ^ (carry << 4);
+}
+
+quint64 load(const quint8 *p)
+{
+    return qFromBigEndian<quint64>(p);
+}
+
+} // namespace
+
+// Karatsuba на 64-битных половинах: три умножения вместо четырёх;
+// произведения всех блоков складываются и приводятся один раз
+void MgmField::sum128Ref(const quint8 *h, const quint8 *x, int blocks, quint8 *sum)
+{
+    // sum уже приведена: она входит в младшие 128 бит без умножения
+    quint64 p[4] = { 0, 0, load(sum), load(sum + 8) };
+    for (int b = 0; b < blocks; ++b) {
+        const quint64 h1 = load(h + 16 * b), h0 = load(h + 16 * b + 8);
+        const quint64 x1 = load(x + 16 * b), x0 = load(x + 16 * b + 8);
+        quint64 hh, hl, lh, ll, mh, ml;
+        clmul64(h1, x1, hh, hl);
+        clmul64(h0, x0, lh, ll);
+        clmul64(h1 ^ h0, x1 ^ x0, mh, ml);
+        mh ^= hh ^ lh;
+        ml ^= hl ^ ll;
+        p[0] ^= hh;
+        p[1] ^= hl ^ mh;
+        p[2] ^= lh ^ ml;
+        p[3] ^= ll;
+    }
+    quint64 hi, lo;
+    reduce128(p, hi, lo);
+    qToBigEndian<quint64>(hi, sum);
+    qToBigEndian<quint64>(lo, sum + 8);
+}
+
+void MgmField::sum64Ref(const quint8 *h, const quint8 *x, int blocks, quint8 *sum)
+{
+    quint64 hi = 0, lo = load(sum);
+    for (int b = 0; b < blocks; ++b) {
+        quint64 ph, pl;
+        clmul64(load(h + 8 * b), load(x + 8 * b), ph, pl);
+        hi ^= ph;
+        lo ^= pl;
+    }
+    qToBigEndian<quint64>(reduce64(hi, lo), sum);
+}
+
+#ifdef DIPLOM_HAVE_CLMUL
+
+DIPLOM_TARGET_CLMUL
+void MgmField::sum128Clmul(const quint8 *h, const quint8 *x, int blocks, quint8 *sum)
+{
+    __m128i high = _mm_setzero_si128();
+    __m128i low = _mm_set_epi64x(qint64(load(sum)), qint64(load(sum + 8)));
+    __m128i mid = _mm_setzero_si128();
+    for (int b = 0; b < blocks; ++b) {
+        const __m128i hv = _mm_set_epi64x(qint64(load(h + 16 * b)), qint64(load(h + 16 * b + 8)));
+        const __m128i xv = _mm_set_epi64x(qint64(load(x + 16 * b)), qint64(load(x + 16 * b + 8)));
+        high = _mm_xor_si128(high, _mm_clmulepi64_si128(hv, xv, 0x11));
+        low = _mm_xor_si128(low, _mm_clmulepi64_si128(hv, xv, 0x00));
+        mid = _mm_xor_si128(mid, _mm_xor_si128(_mm_clmulepi64_si128(hv, xv, 0x01),
+                                               _mm_clmulepi64_si128(hv, xv, 0x10)));
+    }
+    alignas(16) quint64 hw[2], mw[2], lw[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(hw), high);
+    _mm_store_si128(reinterpret_cast<__m128i *>(mw), mid);
+    _mm_store_si128(reinterpret_cast<__m128i *>(lw), low);
+    // Слова в регистре — младшее первым
+    const quint64 p[4] = { hw[1], hw[0] ^ mw[1], lw[1] ^ mw[0], lw[0] };
+    quint64 hi, lo;
+    reduce128(p, hi, lo);
+    qToBigEndian<quint64>(hi, sum);
+    qToBigEndian<quint64>(lo, sum + 8);
+}
+
+DIPLOM_TARGET_CLMUL
+void MgmField::sum64Clmul(const quint8 *h, const quint8 *x, int blocks, quint8 *sum)
+{
+    __m128i acc = _mm_set_epi64x(0, qint64(load(sum)));
+    for (int b = 0; b < blocks; ++b) {
+        const __m128i hv = _mm_set_epi64x(0, qint64(load(h + 8 * b)));
+        const __m128i xv = _mm_set_epi64x(0, qint64(load(x + 8 * b)));
+        acc = _mm_xor_si128(acc, _mm_clmulepi64_si128(hv, xv, 0x00));
+    }
+    alignas(16) quint64 w[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(w), acc);
+    qToBigEndian<quint64>(reduce64(w[1], w[0]), sum);
+}
+
+#endif // DIPLOM_HAVE_CLMUL
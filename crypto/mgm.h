@@ -0,0 +1,231 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/mgm.h — режим MGM (Р 1323565.1.026-2019, RFC 9058)
+//
+// Шифрование с имитовставкой за один проход по данным. Для синхропосылки
+// ICN (n - 1 бит) вырабатываются две последовательности:
+//   Y_1 = E(0 || ICN), Y_{i+1} = incr_r(Y_i) — гамма: C_i = P_i ⊕ E(Y_i);
+//   Z_1 = E(1 || ICN), Z_{i+1} = incr_l(Z_i) — H_i = E(Z_i).
+// incr_r и incr_l прибавляют единицу к правой и левой половине блока по
+// модулю 2^(n/2). Имитовставка:
+//   T = E(Σ H_i ⊗ A_i ⊕ Σ H_{h+j} ⊗ C_j ⊕ H_{h+q+1} ⊗ (len(A) || len(C))),
+// где A — ассоциированные данные (h блоков), C — шифртекст (q блоков),
+// неполные последние блоки A и C дополнены нулями, длины — в битах,
+// по n/2 бит. Умножение — в GF(2^128) по модулю x^128 + x^7 + x^2 + x + 1
+// для Кузнечика и в GF(2^64) по модулю x^64 + x^4 + x^3 + x + 1 для Магмы;
+// блок — число big-endian, бит i — коэффициент при x^i.
+//
+// Сумму произведений считает ядро Dispatch (gf128 / gf64): с PCLMULQDQ
+// или переносимое. Ядро приводит по модулю один раз на вызов, поэтому
+// вызывается сразу на BatchWidth блоков.
+#ifndef MGM_H
+#define MGM_H
+
+#include <QtEndian>
+#include <QtGlobal>
+#include <cstring>
+#include "dispatch.h"
+#include "traits.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DIPLOM_HAVE_CLMUL 1
+#endif
+
+// Ядра свёртки sum ⊕= Σ H_i ⊗ X_i: h и x — blocks блоков подряд, sum —
+// один блок; все блоки big-endian
+class MgmField
+{
+public:
+    static void sum128Ref(const quint8 *h, const quint8 *x, int blocks, quint8 *sum);
+    static void sum64Ref(const quint8 *h, const quint8 *x, int blocks, quint8 *sum);
+#ifdef DIPLOM_HAVE_CLMUL
+    static void sum128Clmul(const quint8 *h, const quint8 *x, int blocks, quint8 *sum);
+    static void sum64Clmul(const quint8 *h, const quint8 *x, int blocks, quint8 *sum);
+#endif
+};
+
+template<typename Cipher>
+class Mgm
+{
+public:
+    using Traits = CipherTraits<Cipher>;
+    static constexpr int BlockSize = Traits::BlockSize;
+    // Имитовставка — полный блок (S = n)
+    static constexpr int TagSize = BlockSize;
+
+    // nonce — один блок; старший бит не используется (ICN — n - 1 бит).
+    // Пара ключ и синхропосылка не должна повторяться.
+    Mgm(const Cipher &cipher, const quint8 *nonce)
+        : m_cipher(cipher)
+        , m_sum(BlockSize == 16 ? Dispatch::gf128Sum() : Dispatch::gf64Sum())
+    {
+        quint8 block[BlockSize];
+        memcpy(block, nonce, BlockSize);
+        block[0] &= 0x7f;
+        cipher.encryptBlock(block, block);
+        m_y.load(block);
+        memcpy(block, nonce, BlockSize);
+        block[0] |= 0x80;
+        cipher.encryptBlock(block, block);
+        m_z.load(block);
+    }
+
+    // Зашифровать data на месте и выработать имитовставку; гамма и свёртка
+    // идут по одним и тем же BatchBytes байт, пока они в кэше
+    void encrypt(const char *ad, qint64 adSize, char *data, qint64 size, quint8 *tag) const
+    {
+        Hash hash(*this);
+        hash.absorb(ad, adSize);
+        Counter y = m_y;
+        for (qint64 offset = 0; offset < size; offset += Traits::BatchBytes) {
+            const qint64 len = qMin<qint64>(Traits::BatchBytes, size - offset);
+            applyGamma(y, data + offset, len);
+            hash.absorb(data + offset, len);
+        }
+        hash.finish(adSize, size, tag);
+    }
+
+    // Имитовставка над ассоциированными данными и шифртекстом — для
+    // проверки перед расшифрованием
+    void computeTag(const char *ad, qint64 adSize, const char *cipherText, qint64 size, quint8 *tag) const
+    {
+        Hash hash(*this);
+        hash.absorb(ad, adSize);
+        hash.absorb(cipherText, size);
+        hash.finish(adSize, size, tag);
+    }
+
+    // Наложить гамму на data, начиная с блока firstBlock: расшифрование
+    // всего шифртекста или его части после проверки имитовставки
+    void crypt(quint64 firstBlock, char *data, qint64 size) const
+    {
+        Counter y = m_y;
+        y.advanceRight(firstBlock);
+        for (qint64 offset = 0; offset < size; offset += Traits::BatchBytes)
+            applyGamma(y, data + offset, qMin<qint64>(Traits::BatchBytes, size - offset));
+    }
+
+private:
+    static constexpr int Words = (BlockSize + 7) / 8;
+
+    // Блок как слова big-endian; у 64-битного блока половины — 32 бита
+    // одного слова
+    struct Counter
+    {
+        quint64 w[Words];
+
+        void load(const quint8 *block)
+        {
+            for (int k = 0; k < Words; ++k)
+                w[k] = qFromBigEndian<quint64>(block + 8 * k);
+        }
+        void store(quint8 *block) const
+        {
+            for (int k = 0; k < Words; ++k)
+                qToBigEndian<quint64>(w[k], block + 8 * k);
+        }
+        void advanceRight(quint64 delta)
+        {
+            if (Words == 2)
+                w[Words - 1] += delta;
+            else
+                w[0] = (w[0] & 0xffffffff00000000ull) | ((w[0] + delta) & 0xffffffffull);
+        }
+        void advanceLeft(quint64 delta)
+        {
+            w[0] += Words == 2 ? delta : delta << 32;
+        }
+    };
+
+    // Гамма на len ≤ BatchBytes байт с блока y; y сдвигается за них
+    void applyGamma(Counter &y, char *data, qint64 len) const
+    {
+        alignas(16) quint8 gamma[Traits::BatchBytes];
+        const int blocks = int((len + BlockSize - 1) / BlockSize);
+        for (int b = 0; b < blocks; ++b) {
+            y.store(gamma + b * BlockSize);
+            m_cipher.encryptBlock(gamma + b * BlockSize, gamma + b * BlockSize);
+            y.advanceRight(1);
+        }
+        if (len == Traits::BatchBytes) {
+            for (int j = 0; j < Traits::BatchBytes; j += 8) {
+                quint64 word, key;
+                memcpy(&word, data + j, 8);
+                memcpy(&key, gamma + j, 8);
+                word ^= key;
+                memcpy(data + j, &word, 8);
+            }
+        } else {
+            for (qint64 j = 0; j < len; ++j)
+                data[j] = static_cast<char>(data[j] ^ gamma[j]);
+        }
+    }
+
+    // Σ H_i ⊗ X_i по блокам A, затем C
+    class Hash
+    {
+    public:
+        explicit Hash(const Mgm &mgm) : m_mgm(mgm), m_z(mgm.m_z) {}
+
+        // Данные целыми блоками; хвост короче блока дополняется нулями
+        // и завершает свою часть (A или C)
+        void absorb(const char *data, qint64 size)
+        {
+            const quint8 *p = reinterpret_cast<const quint8 *>(data);
+            const qint64 whole = size - size % BlockSize;
+            for (qint64 offset = 0; offset < whole; offset += Traits::BatchBytes)
+                run(p + offset, int(qMin<qint64>(Traits::BatchBytes, whole - offset) / BlockSize));
+            if (whole < size) {
+                quint8 last[BlockSize] = {};
+                memcpy(last, p + whole, size_t(size - whole));
+                run(last, 1);
+            }
+        }
+
+        void finish(qint64 adSize, qint64 size, quint8 *tag)
+        {
+            const quint64 adBits = quint64(adSize) * 8;
+            const quint64 bits = quint64(size) * 8;
+            Counter lengths;
+            if (Words == 2) {
+                lengths.w[0] = adBits;
+                lengths.w[Words - 1] = bits;
+            } else {
+                lengths.w[0] = (adBits << 32) | (bits & 0xffffffffull);
+            }
+            quint8 block[BlockSize];
+            lengths.store(block);
+            run(block, 1);
+            m_mgm.m_cipher.encryptBlock(m_sum, tag);
+        }
+
+    private:
+        void run(const quint8 *x, int blocks)
+        {
+            alignas(16) quint8 h[Traits::BatchBytes];
+            for (int b = 0; b < blocks; ++b) {
+                m_z.store(h + b * BlockSize);
+                m_mgm.m_cipher.encryptBlock(h + b * BlockSize, h + b * BlockSize);
+                m_z.advanceLeft(1);
+            }
+            m_mgm.m_sum(h, x, blocks, m_sum);
+        }
+
+        const Mgm &m_mgm;
+        Counter m_z;
+        alignas(16) quint8 m_sum[BlockSize] = {};
+    };
+
+    const Cipher &m_cipher;
+    Dispatch::GfSumFn m_sum;
+    Counter m_y;
+    Counter m_z;
+};
+
+#endif // MGM_H
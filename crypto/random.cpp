@@ -0,0 +1,254 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/random.cpp
+#include "random.h"
+#include "ctr.h"
+#include "kuznechik.h"
+#include <QtGlobal>
+#include <atomic>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/random.h>
+#include <unistd.h>
+#else
+#include <QRandomGenerator>
+#include <vector>
+#endif
+
+namespace {
+
+std::atomic<int> currentGenerator{ int(SecureRandom::Generator::System) };
+
+// Стереть то, что уже выдано: в памяти не остаётся ни соли, ни пароля
+void wipe(void *data, size_t size)
+{
+    volatile char *p = static_cast<volatile char *>(data);
+    while (size--)
+        *p++ = 0;
+}
+
+#if defined(Q_OS_LINUX)
+// Старые ядра без getrandom (до 3.17) — /dev/urandom
+bool readUrandom(char *data, qint64 size)
+{
+    const int fd = ::open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+    while (size > 0) {
+        const ssize_t n = ::read(fd, data, size_t(size));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0) {
+            ::close(fd);
+            return false;
+        }
+        data += n;
+        size -= n;
+    }
+    ::close(fd);
+    return true;
+}
+#endif
+
+struct SystemSource
+{
+    bool generate(char *data, qint64 size) { return SecureRandom::systemEntropy(data, size); }
+};
+
+// Мелкие запросы (соль, синхропосылка) — из буфера потока, который
+// источник заполняет одним вызовом
+template<typename Source>
+class Pool
+{
+public:
+    ~Pool() { wipe(m_buffer, sizeof(m_buffer)); }
+
+    bool fill(char *data, qint64 size)
+    {
+        // Крупный запрос буфер только удлинил бы
+        if (size >= SecureRandom::BufferSize)
+            return m_source.generate(data, size);
+        while (size > 0) {
+            if (m_left == 0) {
+                if (!m_source.generate(m_buffer, sizeof(m_buffer)))
+                    return false;
+                m_left = int(sizeof(m_buffer));
+            }
+            const int n = int(qMin<qint64>(size, m_left));
+            char *from = m_buffer + sizeof(m_buffer) - m_left;
+            memcpy(data, from, size_t(n));
+            wipe(from, size_t(n));
+            m_left -= n;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+private:
+    Source m_source;
+    char m_buffer[SecureRandom::BufferSize];
+    int m_left = 0;
+};
+
+class KuznechikDrbg
+{
+public:
+    static constexpr int KeySize = 32;
+    static constexpr int BlockSize = 16;
+    static constexpr int SeedSize = KeySize + BlockSize;
+
+    ~KuznechikDrbg() { wipe(m_state, sizeof(m_state)); }
+
+    bool generate(char *data, qint64 size)
+    {
+        while (size > 0) {
+            if ((!m_seeded || m_requests >= SecureRandom::ReseedInterval) && !reseed())
+                return false;
+            const int n = int(qMin<qint64>(size, SecureRandom::MaxDrbgRequest));
+            // Гамма CTR над нулями — сами выходные байты; счётчик начинается
+            // со следующего за V значения, как в CTR_DRBG
+            memset(data, 0, size_t(n));
+            applyCTR(m_cipher, m_counter, 1, data, n);
+            update(quint64(n + BlockSize - 1) / BlockSize + 1, nullptr);
+            ++m_requests;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+private:
+    // Новое состояние — следующие SeedSize байт гаммы после blockOffset,
+    // смешанные с энтропией при обновлении
+    void update(quint64 blockOffset, const char *entropy)
+    {
+        char next[SeedSize] = {};
+        if (m_seeded)
+            applyCTR(m_cipher, m_counter, blockOffset, next, SeedSize);
+        if (entropy) {
+            for (int i = 0; i < SeedSize; ++i)
+                next[i] ^= entropy[i];
+        }
+        memcpy(m_state, next, sizeof(m_state));
+        wipe(next, sizeof(next));
+        m_cipher = KuznechikKey(QByteArray(m_state, KeySize));
+        m_counter = QByteArray(m_state + KeySize, BlockSize);
+        m_seeded = true;
+    }
+
+    bool reseed()
+    {
+        char entropy[SeedSize];
+        if (!SecureRandom::systemEntropy(entropy, SeedSize))
+            return false;
+        update(1, entropy);
+        wipe(entropy, sizeof(entropy));
+        m_requests = 0;
+        return true;
+    }
+
+    KuznechikKey m_cipher;
+    QByteArray m_counter;
+    char m_state[SeedSize] = {};
+    quint64 m_requests = 0;
+    bool m_seeded = false;
+};
+
+} // namespace
+
+void SecureRandom::setGenerator(Generator generator)
+{
+    currentGenerator.store(int(generator), std::memory_order_relaxed);
+}
+
+SecureRandom::Generator SecureRandom::generator()
+{
+    return Generator(currentGenerator.load(std::memory_order_relaxed));
+}
+
+bool SecureRandom::generatorFromName(const QString &name, Generator *generator)
+{
+    const QString clean = name.trimmed().toLower();
+    if (clean.isEmpty() || clean == QLatin1String("system"))
+        *generator = Generator::System;
+    else if (clean == QLatin1String("kuznechik-drbg"))
+        *generator = Generator::KuznechikDrbg;
+    else
+        return false;
+    return true;
+}
+
+QString SecureRandom::generatorName(Generator generator)
+{
+    return generator == Generator::KuznechikDrbg ? QStringLiteral("kuznechik-drbg") : QStringLiteral("system");
+}
+
+bool SecureRandom::systemEntropy(void *data, qint64 size)
+{
+    char *out = static_cast<char *>(data);
+#if defined(Q_OS_LINUX)
+    while (size > 0) {
+        const ssize_t n = ::getrandom(out, size_t(size), 0);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return errno == ENOSYS && readUrandom(out, size);
+        out += n;
+        size -= n;
+    }
+    return true;
+#else
+    // fillRange выдаёт целые слова; хвост — из последнего слова
+    std::vector<quint32> words(size_t((size + 3) / 4));
+    QRandomGenerator::system()->fillRange(words.data(), qsizetype(words.size()));
+    memcpy(out, words.data(), size_t(size));
+    wipe(words.data(), words.size() * sizeof(quint32));
+    return true;
+#endif
+}
+
+bool SecureRandom::fill(void *data, qint64 size)
+{
+    if (size <= 0)
+        return true;
+    char *out = static_cast<char *>(data);
+    if (generator() == Generator::KuznechikDrbg) {
+        thread_local Pool<KuznechikDrbg> drbg;
+        return drbg.fill(out, size);
+    }
+    thread_local Pool<SystemSource> pool;
+    return pool.fill(out, size);
+}
+
+QByteArray SecureRandom::bytes(int length)
+{
+    QByteArray data(length, 0);
+    if (!fill(data.data(), length))
+        return QByteArray();
+    return data;
+}
+
+bool SecureRandom::bounded(quint32 bound, quint32 *value)
+{
+    // Отбрасываются значения из неполного последнего диапазона
+    const quint32 limit = quint32(0) - (quint32(0) - bound) % bound;
+    for (;;) {
+        quint32 candidate;
+        if (!fill(&candidate, sizeof(candidate)))
+            return false;
+        if (limit == 0 || candidate < limit) {
+            *value = candidate % bound;
+            return true;
+        }
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/random.h — случайные байты для соли, синхропосылок и паролей
+//
+// У каждого потока свой генератор и свой буфер на 4 КиБ, который генератор
+// заполняет одним вызовом: пакетные потоки не делят ни блокировку, ни вызов
+// на каждый байт. Выданные из буфера байты тут же стираются; запросы
+// от 4 КиБ идут мимо буфера.
+//
+//   System         — энтропия ОС (getrandom на Linux, QRandomGenerator::system()
+//                    в остальных системах).
+//   KuznechikDrbg  — детерминированный генератор по схеме CTR_DRBG
+//                    (NIST SP 800-90A) на Кузнечике: гамма CTR от состояния
+//                    (ключ 32 байта, счётчик 16 байт), после каждого
+//                    запроса состояние заменяется следующими 48 байтами
+//                    гаммы — выданное раньше по нему не восстановить.
+//                    ОС даёт начальное заполнение и обновление через
+//                    каждые ReseedInterval запросов. Для поставок, где
+//                    случайные числа должны вырабатываться ГОСТ-алгоритмом.
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <QByteArray>
+#include <QString>
+
+class SecureRandom
+{
+public:
+    enum class Generator { System, KuznechikDrbg };
+
+    static constexpr int BufferSize = 4096;
+    static constexpr quint64 ReseedInterval = quint64(1) << 16;
+    // Наибольший запрос к DRBG без обновления состояния; длинные
+    // запросы делятся на такие части
+    static constexpr int MaxDrbgRequest = 1 << 16;
+
+    // Действует на все потоки, в том числе уже работающие
+    static void setGenerator(Generator generator);
+    static Generator generator();
+    // "system" / "kuznechik-drbg"; пустое имя — System
+    static bool generatorFromName(const QString &name, Generator *generator);
+    static QString generatorName(Generator generator);
+
+    // false — ОС не выдала энтропию; буфер тогда не заполнен
+    static bool fill(void *data, qint64 size);
+    // Пустой массив при ошибке
+    static QByteArray bytes(int length);
+    // Равномерно в [0, bound), без смещения по модулю; bound > 0
+    static bool bounded(quint32 bound, quint32 *value);
+
+    // Энтропия ОС напрямую, без буфера потока
+    static bool systemEntropy(void *data, qint64 size);
+};
+
+#endif // RANDOM_H
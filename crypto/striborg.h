@@ -11,13 +11,20 @@
 
 #include <cstdlib>
 #include <cstring>
+#include "dispatch.h"
 
 using namespace std;
 
 class Streebog {
  private:
   int mode;
-  void precalc_mul_table();
+  Dispatch::StreebogLpsFn lpsKernel;
+  // Рабочие буферы сжатия — свои у каждого объекта, чтобы хеши
+  // можно было считать параллельно в разных потоках
+  unsigned long long tmp[8];
+  unsigned long long tmp1[8];
+  unsigned long long tmp2[8];
+  unsigned long long tmp3[8];
   void lps(unsigned char *in, unsigned long long *out);
   void ToHex(long long n, unsigned long long *c);
   void Xor64(unsigned long long *a, unsigned long long *b,
@@ -31,6 +38,11 @@ class Streebog {
   unsigned char *hash(unsigned char *message, unsigned int size);
   int getMode();
   void setMode(int mode);
+
+  // Ядра LPS: по таблицам mul_table и эталонное — S, P и L
+  // вычисляются напрямую из pi, t и A
+  static void lpsTable(const unsigned char *in, unsigned long long *out);
+  static void lpsRef(const unsigned char *in, unsigned long long *out);
 };
 
 #endif
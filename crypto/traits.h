@@ -0,0 +1,31 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// crypto/traits.h — свойства шифра, известные при компиляции
+//
+// Шаблоны режимов (ctr.h) берут размеры отсюда, а не из blockSize() во
+// время работы: для каждого шифра счётчик и XOR гаммы разворачиваются
+// под его размер блока. Шифр объявляет KeySize, BlockSize и BatchWidth
+// как static constexpr (см. KuznechikKey, MagmaKey).
+#ifndef TRAITS_H
+#define TRAITS_H
+
+template<typename Cipher>
+struct CipherTraits
+{
+    static constexpr int KeySize = Cipher::KeySize;
+    static constexpr int BlockSize = Cipher::BlockSize;
+    // Блоков гаммы за один проход applyCTR
+    static constexpr int BatchWidth = Cipher::BatchWidth;
+    static constexpr int BatchBytes = BlockSize * BatchWidth;
+
+    static_assert(BlockSize == 8 || BlockSize == 16, "блок шифра — 64 или 128 бит");
+    static_assert(BatchWidth > 0 && BatchBytes % 8 == 0, "гамма прохода — целые слова");
+};
+
+#endif // TRAITS_H
@@ -6,7 +6,7 @@
  * GNU General Public License версии 3 или более поздней.
  * Подробнее: https://www.gnu.org/licenses/gpl-3.0
  */
-include "diplom.h"
+#include "diplom.h"
 #include "./ui_diplom.h"
 #include "settings.h"
 #include <QScreen>
@@ -18,12 +18,14 @@ include "diplom.h"
 #include <QDir>
 #include <algorithm>  // для std::sort
 #include <utility>  // IWYU pragma: keep
-#include <QDirIterator>
-#include <QRandomGenerator>
-#include "crypto/kuznechik.h"
-#include "crypto/striborg.h"
-#include "crypto/magma.h"
-#include <QCryptographicHash>
+#include "core/algorithms.h"
+#include "core/compression.h"
+#include "core/fileprocessor.h"
+#include "core/metrics.h"
+#include <QStatusBar>
+
+// Полоса хода — в десятых долях процента
+static constexpr int ProgressScale = 1000;
 
 Diplom::Diplom(QWidget *parent)
     : QMainWindow(parent)
@@ -59,8 +61,7 @@ Diplom::Diplom(QWidget *parent)
     settingsWindow->applyStyle(savedColor);
 
     // Инициализация модели
-    fileModel = new QStandardItemModel(0, 4, this);  // 0 строк, 4 столбца
-    fileModel->setHorizontalHeaderLabels({ "Номер", "Путь", "Состояние", "Метод" });
+    fileModel = new FileTableModel(this);
     ui->tableView->setModel(fileModel);
 
     // Настройка таблицы
@@ -68,7 +69,6 @@ Diplom::Diplom(QWidget *parent)
     ui->tableView->verticalHeader()->setVisible(false);
     ui->tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
 
-    fileCounter = 0;  // Начинаем с 1 при добавлении
     ui->lineEdit_vod->setPlaceholderText("Введите пароль (без пробелов)");
     ui->lineEdit_vod->setStyleSheet(
         "QLineEdit {"
@@ -81,12 +81,36 @@ Diplom::Diplom(QWidget *parent)
     ui->lineEdit_vod->setMaxLength(64); // Ограничение длины
     // Где-то при инициализации (например, в конструкторе)
     ui->comboBox_algoritm->clear();
-    ui->comboBox_algoritm->addItem("Кузнечик");
-    ui->comboBox_algoritm->addItem("Магма");
+    for (const AlgorithmInfo &info : Algorithms)
+        ui->comboBox_algoritm->addItem(QString::fromUtf8(info.name));
+
+    // Ход обработки опрашивается по таймеру; finished приходит из рабочего
+    // потока через очередь событий GUI
+    batchRunner = new BatchRunner(this);
+    connect(batchRunner, &BatchRunner::finished, this, &Diplom::onBatchFinished);
+    batchTimer = new QTimer(this);
+    batchTimer->setInterval(250);
+    connect(batchTimer, &QTimer::timeout, this, &Diplom::pollBatch);
+
+    statusRefresher = new StatusRefresher(this);
+    connect(statusRefresher, &StatusRefresher::finished, this, &Diplom::onRefreshFinished);
+
+    // Состояние строк поддерживается по событиям каталогов: проверяются
+    // только каталоги, где что-то изменилось
+    dirWatcher = new DirectoryWatcher(this);
+    connect(dirWatcher, &DirectoryWatcher::directoriesChanged, this, &Diplom::onDirectoriesChanged);
+    connect(fileModel, &QAbstractItemModel::rowsInserted, this, &Diplom::scheduleWatchSync);
+    connect(fileModel, &QAbstractItemModel::rowsRemoved, this, &Diplom::scheduleWatchSync);
+    connect(fileModel, &QAbstractItemModel::modelReset, this, &Diplom::scheduleWatchSync);
 }
 
 Diplom::~Diplom()
 {
+    // Начатые файлы дорабатываются: прерванный файл остался бы недописанным
+    batchRunner->cancel();
+    batchRunner->wait();
+    statusRefresher->cancel();
+    statusRefresher->wait();
     delete ui;
 }
 void Diplom::setupMessageBoxStyle(QMessageBox &msgBox) {
@@ -181,229 +205,110 @@ void Diplom::on_pushButton_port2_clicked()
         addFileToTable(dirPath, true);  // true = это папка
     }
 }
-void Diplom::processDirectory(const QString &dirPath, bool encrypt, const QString &algorithm)
-{
-    QDir dir(dirPath);
-    if (!dir.exists()) return;
-
-    // Рекурсивный обход
-    QDirIterator it(dirPath, QDir::Files, QDirIterator::Subdirectories);
-    while (it.hasNext()) {
-        QString filePath = it.next();
-        QString result = processFile(filePath, encrypt, algorithm);
-        if (!result.isEmpty()) {
-            // Удаляем старый путь, добавляем новый
-            for (int row = 0; row < fileModel->rowCount(); ++row) {
-                QStandardItem *item = fileModel->item(row, 1);
-                if (item && item->toolTip() == filePath) {
-                    updateTableRowWithPath(row, result, "", "");
-                    break;
-                }
-            }
-        }
-    }
-}
 void Diplom::addFileToTable(const QString &path, bool isDir)
 {
-    fileCounter++;
-
-    QFileInfo info(path);
-    QString displayPath = isDir ? path + "/" : path;
-
-    QList<QStandardItem*> row;
-
-    // Колонка 0 — Номер
-    QStandardItem *numberItem = new QStandardItem(QString::number(fileCounter));
-    numberItem->setEditable(false);
-    row << numberItem;
-
-    // Колонка 1 — Путь с иконкой
-    QStandardItem *pathItem = new QStandardItem(displayPath);
-    QString iconPath = isDir ? ":/image/papka.png" : ":/image/file.png";
-    pathItem->setIcon(QIcon(iconPath));
-    pathItem->setEditable(false);
-    pathItem->setToolTip(path);
-    row << pathItem;
-
-    // Колонка 2 — Состояние (пусто — обновится при обновлении)
-    QStandardItem *statusItem = new QStandardItem("—");
-    statusItem->setEditable(false);
-    row << statusItem;
-
-    // Колонка 3 — Метод
-    QStandardItem *methodItem = new QStandardItem("—");
-    methodItem->setEditable(false);
-    row << methodItem;
-
-    fileModel->appendRow(row);
+    // Номер, иконка и состояние строки вычисляются моделью при отрисовке
+    fileModel->addPath(path, isDir);
 }
 void Diplom::on_pushButton_port3_clicked()
 {
     QModelIndexList selection = ui->tableView->selectionModel()->selectedRows();
     if (selection.isEmpty()) return;
 
-    std::sort(selection.begin(), selection.end(), [](const QModelIndex &a, const QModelIndex &b) {
-        return a.row() > b.row();
-    });
-
+    QList<int> rows;
+    rows.reserve(selection.size());
     for (const QModelIndex &index : std::as_const(selection)) {
-        fileModel->removeRow(index.row());
+        rows.append(index.row());
     }
 
-    renumberRows();
+    // Номера строк считаются моделью — перенумерация не нужна
+    fileModel->removeRowsAt(rows);
 }
 void Diplom::on_pushButton_port4_clicked()
 {
-    fileModel->setRowCount(0);  // Очистить всё
-    fileCounter = 0;  // Сбросить счётчик
+    fileModel->clear();  // Очистить всё
 }
-void Diplom::renumberRows()
+void Diplom::on_pushButton_obn_clicked()
 {
-    for (int i = 0; i < fileModel->rowCount(); ++i) {
-        fileModel->item(i, 0)->setText(QString::number(i + 1));
-    }
-    fileCounter = fileModel->rowCount();
+    // Полная проверка — на случай событий, которые слежение не видит
+    // (сетевые диски, исчерпанный лимит inotify). Диск читается в фоне
+    if (fileModel->rowCount() == 0)
+        return;
+    pendingFullRefresh = true;
+    ui->pushButton_obn->setEnabled(false);
+    refreshPending();
 }
-void Diplom::on_pushButton_obn_clicked()
+void Diplom::onDirectoriesChanged(const QStringList &dirs)
 {
-    for (int i = 0; i < fileModel->rowCount();) {
-        QStandardItem *pathItem = fileModel->item(i, 1);
-        if (!pathItem) {
-            ++i;
-            continue;
-        }
-
-        QString currentPath = pathItem->toolTip();
-        QFileInfo info(currentPath);
-
-        if (info.exists()) {
-            // Файл существует — обновляем статус по его расширению
-            updateRowStatus(i);
-            ++i;
-            continue;
-        }
-
-        // Файл не существует — ищем зашифрованную версию
-        QString base = info.path() + "/" + info.completeBaseName();
-        QString kuzPath = base + ".kuz";
-        QString magPath = base + ".mag";
-        QString encPath = base + ".enc";
-
-        QString foundPath, alg;
-
-        if (QFile::exists(kuzPath)) {
-            foundPath = kuzPath;
-            alg = "Кузнечик";
-        } else if (QFile::exists(magPath)) {
-            foundPath = magPath;
-            alg = "Магма";
-        } else if (QFile::exists(encPath)) {
-            foundPath = encPath;
-            alg = "Неизвестный";
-        }
-
-        if (!foundPath.isEmpty()) {
-            // Удаляем старую строку
-            fileModel->removeRow(i);
-
-            // Вставляем новую на то же место
-            QFileInfo newInfo(foundPath);
-            QList<QStandardItem*> newRow;
-
-            QStandardItem *numberItem = new QStandardItem(QString::number(i + 1));
-            numberItem->setEditable(false);
-            newRow << numberItem;
-
-            QStandardItem *newPathItem = new QStandardItem(newInfo.fileName());
-            newPathItem->setIcon(QIcon(":/image/file.png"));
-            newPathItem->setEditable(false);
-            newPathItem->setToolTip(foundPath);
-            newRow << newPathItem;
-
-            QStandardItem *statusItem = new QStandardItem("Зашифровано (" + alg + ")");
-            statusItem->setIcon(QIcon(":/image/lock.png"));
-            statusItem->setEditable(false);
-            newRow << statusItem;
-
-            QStandardItem *methodItem = new QStandardItem(alg);
-            methodItem->setEditable(false);
-            newRow << methodItem;
-
-            fileModel->insertRow(i, newRow);
-            ++i;
-        } else {
-            // Не найден и шифра нет
-            QStandardItem *statusItem = fileModel->item(i, 2);
-            statusItem->setText("Не найден");
-            statusItem->setIcon(QIcon(":/image/error.png"));
-            statusItem->setData(QColor(0xd32f2f), Qt::ForegroundRole);
-            fileModel->item(i, 3)->setText("—");
-            ++i;
-        }
-    }
-
-    qDebug() << "Обновление завершено";
+    for (const QString &dir : dirs)
+        pendingRefreshDirs.insert(dir);
+    refreshPending();
 }
-void Diplom::updateRowStatus(int row)
+void Diplom::refreshPending()
 {
-    QStandardItem *pathItem = fileModel->item(row, 1);
-    if (!pathItem) return;
-
-    QString path = pathItem->toolTip();
-    QFileInfo info(path);
-    QStandardItem *statusItem = fileModel->item(row, 2);
-    QStandardItem *methodItem = fileModel->item(row, 3);
-
-    QString suffix = info.suffix().toLower();
-
-    if (suffix == "kuz") {
-        statusItem->setText("Зашифровано (Кузнечик)");
-        statusItem->setIcon(QIcon(":/image/lock.png"));
-        methodItem->setText("Кузнечик");
-    } else if (suffix == "mag") {
-        statusItem->setText("Зашифровано (Магма)");
-        statusItem->setIcon(QIcon(":/image/lock.png"));
-        methodItem->setText("Магма");
-    } else {
-        QString base = info.path() + "/" + info.completeBaseName();
-        if (QFile::exists(base + ".kuz")) {
-            statusItem->setText("Расшифровано (был Кузнечик)");
-            statusItem->setIcon(QIcon(":/image/unlock.png"));
-            methodItem->setText("Кузнечик");
-        } else if (QFile::exists(base + ".mag")) {
-            statusItem->setText("Расшифровано (была Магма)");
-            statusItem->setIcon(QIcon(":/image/unlock.png"));
-            methodItem->setText("Магма");
-        } else {
-            statusItem->setText("Актуален");
-            statusItem->setIcon(QIcon(":/image/ok.png"));
-            methodItem->setText("—");
-        }
+    // Одна проверка за раз; накопленное уходит следующей пачкой
+    if (statusRefresher->isRunning())
+        return;
+
+    const bool full = pendingFullRefresh;
+    QVector<int> rows;
+    if (full) {
+        rows.reserve(fileModel->rowCount());
+        for (int row = 0; row < fileModel->rowCount(); ++row)
+            rows.append(row);
+    } else if (!pendingRefreshDirs.isEmpty()) {
+        rows = fileModel->rowsInDirectories(QStringList(pendingRefreshDirs.cbegin(), pendingRefreshDirs.cend()));
+    }
+    pendingFullRefresh = false;
+    pendingRefreshDirs.clear();
+
+    QVector<StatusRefresher::Entry> entries;
+    entries.reserve(rows.size());
+    for (int row : std::as_const(rows))
+        entries.append({ row, fileModel->path(row) });
+
+    if (entries.isEmpty()) {
+        if (full)
+            ui->pushButton_obn->setEnabled(true);
+        return;
     }
+    statusRefresher->start(entries);
+    manualRefresh = full;
 }
-void Diplom::updateTableRowWithPath(int row, const QString &newPath, const QString & /*status*/, const QString & /*method*/)
+void Diplom::scheduleWatchSync()
 {
-    if (row < 0 || row >= fileModel->rowCount()) {
-        qDebug() << "Некорректный номер строки:" << row;
+    // Удаление или добавление тысячи строк даёт одну сверку набора каталогов
+    if (watchSyncQueued)
         return;
+    watchSyncQueued = true;
+    QTimer::singleShot(0, this, [this]() {
+        watchSyncQueued = false;
+        dirWatcher->setDirectories(fileModel->directories());
+    });
+}
+void Diplom::onRefreshFinished()
+{
+    // Пока шла проверка, строки могли удалить или добавить:
+    // номер сверяется с путём, при расхождении строка ищется по пути
+    const QVector<StatusRefresher::Result> results = statusRefresher->takeResults();
+    QVector<FileTableModel::RowUpdate> updates;
+    updates.reserve(results.size());
+    for (const StatusRefresher::Result &result : results) {
+        int row = result.row;
+        if (row >= fileModel->rowCount() || fileModel->path(row) != result.source)
+            row = fileModel->rowForPath(result.source);
+        if (row < 0)
+            continue;
+        updates.append({ row, result.path, result.status, result.method });
     }
+    fileModel->applyUpdates(updates);
 
-    QStandardItem *pathItem = fileModel->item(row, 1);
-    if (!pathItem) {
-        qDebug() << "Не найдена ячейка пути в строке" << row;
-        return;
+    if (manualRefresh) {
+        manualRefresh = false;
+        ui->pushButton_obn->setEnabled(true);
+        qDebug() << "Обновление завершено";
     }
-
-    QFileInfo info(newPath);
-
-    // Обновляем отображаемое имя и полный путь
-    pathItem->setText(info.fileName());
-    pathItem->setToolTip(newPath);
-
-    // ✅ Пересчитываем статус и метод на основе нового расширения
-    updateRowStatus(row);
-
-    qDebug() << "Строка" << row << "обновлена:" << newPath;
+    refreshPending();
 }
 
 void Diplom::on_pushButton_procedure_clicked()
@@ -424,363 +329,181 @@ void Diplom::on_pushButton_shifr_clicked()
         return;
     }
 
+    QStringList paths;
     for (const QModelIndex &index : selected) {
-        int row = index.row();
-        QStandardItem *pathItem = fileModel->item(row, 1);
-        if (!pathItem) continue;
-
-        QString path = pathItem->toolTip();
+        QString path = fileModel->path(index.row());
         QFileInfo info(path);
 
-        if (info.isDir()) {
-            // 🔐 Это папка — обрабатываем рекурсивно
-            processDirectory(path, true, algorithm);
-        } else if (info.isFile()) {
-            // 📄 Это файл — обычное шифрование
+        // Папки обходятся в фоне, уже зашифрованное внутри пропускается
+        if (info.isFile()) {
             QString suffix = info.suffix().toLower();
             if (suffix == "kuz" || suffix == "mag") {
                 qDebug() << "Файл уже зашифрован:" << path;
                 continue;
             }
-
-            QString encryptedPath = processFile(path, true, algorithm);
-            if (!encryptedPath.isEmpty()) {
-                updateTableRowWithPath(row, encryptedPath, "", "");
-            }
         }
+        paths.append(path);
     }
-}
-
 
-// ВАЖНО: Эту функцию нужно добавить в .cpp, но НЕ внутри processFile
-QByteArray Diplom::generateRandom(int length) {
-    QByteArray data(length, 0);
-    for (int i = 0; i < length; ++i) {
-        data[i] = static_cast<char>(QRandomGenerator::global()->generate() % 256);
-    }
-    return data;
+    if (!paths.isEmpty())
+        processFiles(paths, true, algorithm);
 }
-template<typename Cipher>
-QByteArray encryptCTR(const QByteArray &data, Cipher &cipher, const QByteArray &iv)
-{
-    QByteArray result;
-    QByteArray counter = iv;
-    int blockSize = cipher.blockSize(); // Должен быть метод blockSize()
-
-    for (int i = 0; i < data.size(); i += blockSize) {
-        QByteArray block = data.mid(i, blockSize);
-        QByteArray encryptedCounter = cipher.encryptBlock(counter);
-        if (encryptedCounter.isEmpty()) return QByteArray();
-
-        for (int j = 0; j < block.size(); ++j) {
-            result.append(encryptedCounter[j] ^ block[j]);
-        }
 
-        // Увеличиваем счётчик (младшие байты)
-        for (int k = counter.size() - 1; k >= 0; --k) {
-            counter[k]++;
-            if (counter[k] != 0) break;
-        }
-    }
-    return result;
-}
 
-template<typename Cipher>
-QByteArray decryptCTR(const QByteArray &data, Cipher &cipher, const QByteArray &iv)
+void Diplom::processFiles(const QStringList &paths, bool encrypt, const QString &algorithm)
 {
-    return encryptCTR(data, cipher, iv); // CTR симметричен
-}
-QByteArray Diplom::hmacStreebog(const QByteArray &data, const QByteArray &key)
-{
-    // Ключ должен быть 32 байта (Streebog-256)
-    QByteArray k = key;
-    if (k.size() > 32) {
-        Streebog hash(256);
-        unsigned char* h = hash.hash((unsigned char*)k.data(), k.size());
-        k = QByteArray((char*)h, 32);
-    } else if (k.size() < 32) {
-        k.resize(32, 0);
+    if (batchRunner->isRunning()) {
+        qDebug() << "Обработка уже идёт";
+        return;
     }
 
-    // iPad: 32 байта: key XOR 0x36
-    QByteArray iPad(32, 0x36);
-    for (int i = 0; i < 32; ++i) {
-        iPad[i] ^= k[i];
+    // Пароль и алгоритм читаются здесь, в потоке GUI: рабочие потоки
+    // к виджетам не обращаются
+    BatchOptions options;
+    options.encrypt = encrypt;
+    options.password = ui->lineEdit_vod->text().trimmed();
+    if (options.password.isEmpty()) {
+        qDebug() << "Пароль не задан";
+        return;
     }
-
-    // oPad: key XOR 0x5C
-    QByteArray oPad(32, 0x5C);
-    for (int i = 0; i < 32; ++i) {
-        oPad[i] ^= k[i];
+    if (encrypt && !FileProcessor::algorithmFromName(algorithm, &options.algorithm)) {
+        qDebug() << "Неизвестный алгоритм:" << algorithm;
+        return;
     }
+    batchEncrypt = encrypt;
+    batchMethod = options.algorithm == AlgorithmId::Magma ? FileTableModel::Magma
+                                                          : FileTableModel::Kuznechik;
 
-    // HMAC = H(oPad || H(iPad || data))
-    Streebog hash(256);
-    QByteArray innerInput = iPad + data;
-    unsigned char* innerHash = hash.hash((unsigned char*)innerInput.data(), innerInput.size());
-
-    QByteArray outerInput = oPad + QByteArray((char*)innerHash, 32);
-    unsigned char* outerHash = hash.hash((unsigned char*)outerInput.data(), outerInput.size());
+    // Замеры стадий нужны строке состояния, выгружаются — если задан файл
+    QSettings settings("MyCompany", "DiplomApp");
+    metricsJsonPath = settings.value("Metrics/JsonPath").toString();
+    metricsPromPath = settings.value("Metrics/PrometheusPath").toString();
+    // Шифрование «на месте»: для дисков, где нет места на вторую копию
+    options.inPlace = settings.value("Batch/InPlace", false).toBool();
+    // Повторный прогон по описи папки: исходные остаются, неизменённые пропускаются
+    options.incremental = settings.value("Batch/Incremental", false).toBool();
+    options.manifestDigest = settings.value("Batch/ManifestDigest", false).toBool();
+    // Изменённые файлы — пофрагментное обновление контейнера вместо полного шифрования
+    options.delta = settings.value("Batch/Delta", false).toBool();
+    // Каждая папка из таблицы — один архив вместо контейнера на файл
+    options.archive = settings.value("Batch/Archive", false).toBool();
+    // Сжатие фрагментов: "deflate" или "zstd" (если собрано с libzstd)
+    const QString codec = settings.value("Batch/Compression").toString();
+    if (!Compression::fromName(codec, &options.compression) || !Compression::isAvailable(options.compression)) {
+        qDebug() << "Неизвестный кодек сжатия:" << codec;
+        options.compression = CompressionId::None;
+    }
+    // Имитовставка: "hmac" (по умолчанию), "mgm" — один проход вместо CTR и HMAC,
+    // или "cmac" — на шифре контейнера вместо Стрибога
+    const QString mac = settings.value("Batch/Mac").toString();
+    if (!macFromName(mac, &options.mac))
+        qDebug() << "Неизвестная имитовставка:" << mac;
+    Metrics::setEnabled(true);
+    Metrics::reset();
+    progressMeter.start();
+    // Временная шкала прогона для Perfetto / chrome://tracing
+    tracePath = settings.value("Trace/Path").toString();
+    if (!tracePath.isEmpty()) {
+        Trace::setThreadName("GUI");
+        Trace::start();
+    }
+
+    // Число файлов в папках известно только по ходу обхода
+    ui->progressBar_rabota->setRange(0, 0);
+    ui->progressBar_rabota->setValue(0);
+    ui->pushButton_procedure->setEnabled(false);
+    batchErrorShown = false;
 
-    return QByteArray((char*)outerHash, 32);
+    batchRunner->start(paths, options);
+    batchTimer->start();
 }
 
-QString Diplom::processFile(const QString &filePath, bool encrypt, const QString &algorithm)
+void Diplom::pollBatch()
 {
-    QFileInfo info(filePath);
-    QString outPath;
-
-    QString algExt;
-    QString cleanAlg = algorithm.trimmed();
-    qDebug() << "Алгоритм:" << algorithm << "→ clean:" << cleanAlg;
-
-    if (cleanAlg == "Кузнечик") {
-        algExt = ".kuz";
-    } else if (cleanAlg == "Магма") {
-        algExt = ".mag";
-    } else {
-        qDebug() << "Неизвестный алгоритм:" << algorithm;
-        return QString();
-    }
-
-    if (encrypt) {
-        outPath = info.path() + "/" + info.fileName() + algExt;
-    } else {
-        QString fileName = info.fileName();
-        if (fileName.endsWith(".kuz") || fileName.endsWith(".mag")) {
-            outPath = info.path() + "/" + fileName.left(fileName.length() - algExt.length());
-        } else {
-            return QString();
-        }
-    }
-
-    QFile inFile(filePath);
-    QFile outFile(outPath);
-
-    if (!inFile.open(QIODevice::ReadOnly) || !outFile.open(QIODevice::WriteOnly)) {
-        if (inFile.isOpen()) inFile.close();
-        if (outFile.isOpen()) outFile.close();
-        return QString();
-    }
-
-    QString password = ui->lineEdit_vod->text().trimmed();
-    if (password.isEmpty()) {
-        inFile.close();
-        outFile.close();
-        return QString();
-    }
-
-    QByteArray key;
-    QByteArray salt, iv;
-
-    if (encrypt) {
-        // Генерация salt и IV
-        salt = generateRandom(16);
-        iv = generateRandom(cleanAlg == "Кузнечик" ? 16 : 8);
-
-        // Запись в начало файла
-        outFile.write(salt);
-        outFile.write(iv);
-    } else {
-        // Чтение salt и IV из начала файла
-        salt = inFile.read(16);
-        iv = inFile.read(cleanAlg == "Кузнечик" ? 16 : 8);
-
-        if (salt.size() != 16 || iv.size() != (cleanAlg == "Кузнечик" ? 16 : 8)) {
-            inFile.close();
-            outFile.close();
-            return QString();
+    // Счётчики читаются без блокировок, итоги забираются одной пачкой:
+    // стоимость опроса не зависит от того, сколько файлов успело пройти.
+    // Полоса идёт по байтам: один большой файл весит столько, сколько весит
+    progressMeter.sample(batchRunner->progress());
+    const BatchProgress &progress = progressMeter.progress();
+    if (progress.bytesDone > 0 || progress.scanFinished) {
+        ui->progressBar_rabota->setRange(0, ProgressScale);
+        ui->progressBar_rabota->setValue(qRound(progressMeter.fraction() * ProgressScale));
+    }
+    statusBar()->showMessage(QString("Файлов: %1 из %2 · %3")
+                                 .arg(progress.filesDone + progress.filesFailed)
+                                 .arg(progress.filesQueued)
+                                 .arg(progressMeter.summary()));
+
+    const QVector<BatchResult> results = batchRunner->takeResults();
+    QVector<FileTableModel::RowUpdate> updates;
+    QString firstError;
+    for (const BatchResult &item : results) {
+        if (!item.error.isEmpty()) {
+            qDebug() << "Ошибка обработки" << item.source << ":" << item.error;
+            if (firstError.isEmpty())
+                firstError = item.source;
+            continue;
         }
-    }
 
-    // PBKDF: 1000 итераций Streebog(salt + key)
-    key = password.toUtf8();
-    for (int i = 0; i < 1000; ++i) {
-        Streebog streebog(256);
-        QByteArray input = salt + key;
-        unsigned char* hash = streebog.hash((unsigned char*)input.data(), input.size());
-        key = QByteArray((char*)hash, 32);
+        // Файл, добавленный в таблицу напрямую, получает новый путь.
+        // Состояние известно из режима — без обращений к диску
+        const int row = fileModel->rowForPath(item.source);
+        if (row < 0)
+            continue;
+        if (batchEncrypt)
+            updates.append({ row, item.result, FileTableModel::Encrypted, batchMethod });
+        else
+            updates.append({ row, item.result, FileTableModel::Current, FileTableModel::NoMethod });
     }
+    fileModel->applyUpdates(updates);
 
-    // Теперь key готов — можно шифровать/расшифровывать
-    if (cleanAlg == "Кузнечик") {
-        Kuznechik kuz;
-        if (!kuz.setKey(key)) {
-            inFile.close();
-            outFile.close();
-            return QString();
-        }
-
-        if (encrypt) {
-            QByteArray plaintext = inFile.readAll();
-            int padLen = 16 - (plaintext.size() % 16);
-            if (padLen == 0) padLen = 16;
-            plaintext.append(QByteArray(padLen, static_cast<char>(padLen)));
-
-            QByteArray ciphertext = encryptCTR(plaintext, kuz, iv);
-            if (ciphertext.isEmpty()) {
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
-
-            // Записываем: salt + iv + ciphertext + hmac
-            outFile.write(ciphertext);
-            QByteArray hmac = hmacStreebog(ciphertext, key);
-            outFile.write(hmac);
-        } else {
-            // Читаем: salt + iv + ciphertext + hmac (32 байта)
-            QByteArray ciphertext = inFile.readAll();
-            if (ciphertext.size() <= 32) {
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
-
-            QByteArray hmac = ciphertext.right(32);
-            ciphertext.chop(32);
-
-            // Проверяем HMAC
-            QByteArray expectedHmac = hmacStreebog(ciphertext, key);
-            if (expectedHmac != hmac) {
-                qDebug() << "HMAC не совпадает Файл подделан или повреждён.";
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
-
-            QByteArray decrypted = decryptCTR(ciphertext, kuz, iv);
-            if (decrypted.isEmpty()) {
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
-
-            quint8 pad = decrypted[decrypted.size() - 1];
-            if (pad > 0 && pad <= 16) {
-                bool valid = true;
-                for (int i = decrypted.size() - pad; i < decrypted.size(); ++i) {
-                    if (decrypted[i] != pad) {
-                        valid = false;
-                        break;
-                    }
-                }
-                if (valid) {
-                    decrypted.chop(pad);
-                }
-            }
-            outFile.write(decrypted);
-        }
-
-
-    } else if (cleanAlg == "Магма") {
-        Magma magma;
-        if (!magma.setKey(key)) {
-            inFile.close();
-            outFile.close();
-            return QString();
-        }
-
-        if (encrypt) {
-            QByteArray plaintext = inFile.readAll();
-            int padLen = 8 - (plaintext.size() % 8);
-            if (padLen == 0) padLen = 8;
-            plaintext.append(QByteArray(padLen, static_cast<char>(padLen)));
-
-            QByteArray ciphertext = encryptCTR(plaintext, magma, iv);
-            if (ciphertext.isEmpty()) {
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
-
-            outFile.write(ciphertext);
-            QByteArray hmac = hmacStreebog(ciphertext, key);
-            outFile.write(hmac);
-        } else {
-            QByteArray ciphertext = inFile.readAll();
-            if (ciphertext.size() <= 32) {
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
-
-            QByteArray hmac = ciphertext.right(32);
-            ciphertext.chop(32);
-
-            QByteArray expectedHmac = hmacStreebog(ciphertext, key);
-            if (expectedHmac != hmac) {
-                qDebug() << "HMAC не совпадает Файл подделан или повреждён.";
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
+    if (firstError.isEmpty() || batchErrorShown)
+        return;
 
-            QByteArray decrypted = decryptCTR(ciphertext, magma, iv);
-            if (decrypted.isEmpty()) {
-                inFile.close();
-                outFile.close();
-                return QString();
-            }
+    // Как и раньше, первая ошибка останавливает пакет
+    batchErrorShown = true;
+    batchRunner->cancel();
 
-            quint8 pad = decrypted[decrypted.size() - 1];
-            if (pad > 0 && pad <= 8) {
-                bool valid = true;
-                for (int i = decrypted.size() - pad; i < decrypted.size(); ++i) {
-                    if (decrypted[i] != pad) {
-                        valid = false;
-                        break;
-                    }
-                }
-                if (valid) {
-                    decrypted.chop(pad);
-                }
-            }
-            outFile.write(decrypted);
-        }
-    }
-    inFile.close();
-    outFile.close();
-    QFile::remove(filePath);
-    return outPath;
+    QMessageBox msgBox(this);
+    msgBox.setWindowTitle("Ошибка");
+    msgBox.setText(QString("Ошибка при обработке:\n%1").arg(firstError));
+    msgBox.setIcon(QMessageBox::Critical);
+    setupMessageBoxStyle(msgBox);
+    msgBox.exec();
 }
 
-
-void Diplom::processFiles(const QList<QString> &files, bool encrypt, const QString &algorithm)
+void Diplom::onBatchFinished()
 {
-    int total = files.size();
-    ui->progressBar_rabota->setRange(0, total);
-    ui->progressBar_rabota->setValue(0);
-
-    for (int i = 0; i < total; ++i) {
-        QString filePath = files[i];
-        QString result = processFile(filePath, encrypt, algorithm);
-
-        if (result.isEmpty()) {
-            QMessageBox msgBox(this);
-            msgBox.setWindowTitle("Ошибка");
-            msgBox.setText(QString("Ошибка при обработке:\n%1").arg(filePath));
-            msgBox.setIcon(QMessageBox::Critical);
-            setupMessageBoxStyle(msgBox);
-            msgBox.exec();
-            break;
-        }
+    batchTimer->stop();
+    pollBatch();
 
-        ui->progressBar_rabota->setValue(i + 1);
+    if (!metricsJsonPath.isEmpty() && !Metrics::writeJson(metricsJsonPath))
+        qDebug() << "Не удалось записать метрики:" << metricsJsonPath;
+    if (!metricsPromPath.isEmpty() && !Metrics::writePrometheus(metricsPromPath))
+        qDebug() << "Не удалось записать метрики:" << metricsPromPath;
+    if (!tracePath.isEmpty()) {
+        Trace::stop();
+        if (!Trace::write(tracePath))
+            qDebug() << "Не удалось записать трассу:" << tracePath;
     }
 
+    ui->pushButton_procedure->setEnabled(true);
+
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("Готово");
-    msgBox.setText("Операция завершена!");
+    const quint64 skipped = batchRunner->filesSkipped();
+    msgBox.setText(skipped ? QString("Операция завершена!\nБез изменений, пропущено: %1").arg(skipped)
+                           : QString("Операция завершена!"));
     msgBox.setIcon(QMessageBox::Information);
     setupMessageBoxStyle(msgBox);
     msgBox.exec();
     ui->progressBar_rabota->reset();
+    statusBar()->clearMessage();
 }
 
 void Diplom::startProcedure()
 {
-    QList<QString> files;
+    QStringList paths;
     QStringList errors;
 
     if (!ui->shifr->isChecked() && !ui->rashifr->isChecked()) {
@@ -798,8 +521,11 @@ void Diplom::startProcedure()
         errors << "• Выберите алгоритм шифрования из списка";
     }
 
-    QStandardItemModel *model = qobject_cast<QStandardItemModel*>(ui->tableView->model());
-    if (!model || model->rowCount() == 0) {
+    if (ui->lineEdit_vod->text().trimmed().isEmpty()) {
+        errors << "• Введите пароль";
+    }
+
+    if (fileModel->rowCount() == 0) {
         errors << "• Таблица пуста — добавьте файлы";
         goto showErrors;
     }
@@ -812,43 +538,32 @@ void Diplom::startProcedure()
         }
     }
 
-    for (int i = 0; i < model->rowCount(); ++i) {
-        QStandardItem *item = model->item(i, 1);
-        if (!item) continue;
-
-        QString path = item->toolTip();
-        QFileInfo info(path);
-
-        if (info.isDir()) {
-            QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
-            while (it.hasNext()) {
-                files.append(it.next());
-            }
-        } else if (info.isFile()) {
-            files.append(path);
+    // Папки не раскрываются здесь: их обходит BatchRunner параллельно
+    // с шифрованием, так что дерево читается один раз
+    for (int i = 0; i < fileModel->rowCount(); ++i) {
+        QString path = fileModel->path(i);
+        if (!path.isEmpty()) {
+            paths.append(path);
         }
     }
 
 
     if (processOne) {
-        files.clear();
+        paths.clear();
         QModelIndexList selected = ui->tableView->selectionModel()->selectedRows();
         for (const QModelIndex &index : std::as_const(selected)) {
-            QStandardItem *item = model->item(index.row(), 1);
-            if (item) {
-                QString path = item->toolTip();
-                if (!path.isEmpty()) {
-                    files.append(path);
-                }
+            QString path = fileModel->path(index.row());
+            if (!path.isEmpty()) {
+                paths.append(path);
             }
         }
     }
 
 
 
-    for (const QString &file : files) {
-        if (!QFile::exists(file)) {
-            errors << QString("• Файл не найден:\n%1").arg(file);
+    for (const QString &path : std::as_const(paths)) {
+        if (!QFile::exists(path)) {
+            errors << QString("• Файл не найден:\n%1").arg(path);
         }
     }
 
@@ -917,7 +632,7 @@ showErrors:
         return;
     }
 
-    processFiles(files, isEncrypt, algorithm);
+    processFiles(paths, isEncrypt, algorithm);
 }
 
 void Diplom::updateLineEditStyle(bool hasError)
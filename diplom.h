@@ -16,9 +16,12 @@
 #include <QMessageBox>
 #include "settings.h"  // Подключение класса Settings
 #include "passworddialog.h"
-#include <QStandardItemModel>
 #include <QFileDialog>
 #include <QFileInfo>
+#include "core/batchrunner.h"
+#include "filetablemodel.h"
+#include "statusrefresher.h"
+#include "directorywatcher.h"
 class Settings;
 
 QT_BEGIN_NAMESPACE
@@ -49,29 +52,42 @@ private slots:
     void validatePassword();
     void on_pushButton_procedure_clicked();   
     void on_pushButton_passw_clicked();
+    void pollBatch();
+    void onBatchFinished();
+    void onRefreshFinished();
+    void onDirectoriesChanged(const QStringList &dirs);
 
 private:
     Ui::Diplom *ui;
     Settings *settingsWindow = nullptr;  // Инициализируем nullptr
-    QStandardItemModel *fileModel;  // Модель для tableView
-    int fileCounter;  // Счётчик для нумерации
+    FileTableModel *fileModel;  // Модель для tableView
+    BatchRunner *batchRunner;  // Фоновая обработка: обход и шифрование
+    StatusRefresher *statusRefresher;  // Фоновая проверка строк по спискам каталогов
+    DirectoryWatcher *dirWatcher;      // Изменения в каталогах строк
+    QSet<QString> pendingRefreshDirs;  // Ждут проверки, пока идёт предыдущая
+    bool pendingFullRefresh = false;
+    bool manualRefresh = false;        // Проверку начала кнопка «Обновить»
+    bool watchSyncQueued = false;
+    QTimer *batchTimer;        // Опрос хода обработки несколько раз в секунду
+    ProgressMeter progressMeter;  // Скорость, остаток и загрузка стадий
+    bool batchEncrypt = true;
+    FileTableModel::Method batchMethod = FileTableModel::NoMethod;
+    bool batchErrorShown = false;
+    QString metricsJsonPath;   // Куда выгрузить метрики и трассу по окончании пакета
+    QString metricsPromPath;
+    QString tracePath;
     // Вспомогательные методы
     void addFileToTable(const QString &path, bool isDir = false);
-    void renumberRows();
-    void processFiles(const QList<QString> &files, bool encrypt, const QString &algorithm);
-    QString processFile(const QString &filePath, bool encrypt, const QString &algorithm);
-    void updateRowStatus(int row);
-    void updateTableRowWithPath(int row, const QString &newPath, const QString &status, const QString &method);
+    void processFiles(const QStringList &paths, bool encrypt, const QString &algorithm);
+    void scheduleWatchSync();
+    void refreshPending();
     void on_pushButton_shifr_clicked();
     void setupMessageBoxStyle(QMessageBox &msgBox);
     void updateLineEditStyle(bool hasError = false);
-    QByteArray generateRandom(int length);
-    QByteArray hmacStreebog(const QByteArray &data, const QByteArray &key);
 
     QString generatePassword();
     int checkPasswordStrength(const QString &pass);
     void updatePasswordStrengthIndicator(int strength);
-    void processDirectory(const QString &dirPath, bool encrypt, const QString &algorithm);
 
 };
 #endif // DIPLOM_H
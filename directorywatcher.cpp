@@ -0,0 +1,65 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+#include "directorywatcher.h"
+#include <QDebug>
+
+DirectoryWatcher::DirectoryWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(200);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &DirectoryWatcher::onDirectoryChanged);
+    connect(&m_timer, &QTimer::timeout, this, &DirectoryWatcher::flush);
+}
+
+void DirectoryWatcher::setDirectories(const QStringList &dirs)
+{
+    const QStringList watched = m_watcher.directories();
+    const QSet<QString> wanted(dirs.cbegin(), dirs.cend());
+    const QSet<QString> current(watched.cbegin(), watched.cend());
+
+    QStringList removed;
+    for (const QString &dir : watched) {
+        if (!wanted.contains(dir))
+            removed.append(dir);
+    }
+    QStringList added;
+    for (const QString &dir : dirs) {
+        if (!current.contains(dir))
+            added.append(dir);
+    }
+
+    if (!removed.isEmpty())
+        m_watcher.removePaths(removed);
+    if (!added.isEmpty()) {
+        // Несуществующий каталог или исчерпанный лимит inotify —
+        // строки этих каталогов обновляются только кнопкой «Обновить»
+        const QStringList failed = m_watcher.addPaths(added);
+        if (!failed.isEmpty())
+            qDebug() << "Не удалось следить за каталогами:" << failed.size();
+    }
+}
+
+void DirectoryWatcher::onDirectoryChanged(const QString &dir)
+{
+    m_changed.insert(dir);
+    // Таймер не перезапускается: при непрерывном потоке событий
+    // сигнал всё равно приходит не реже раза за интервал
+    if (!m_timer.isActive())
+        m_timer.start();
+}
+
+void DirectoryWatcher::flush()
+{
+    if (m_changed.isEmpty())
+        return;
+    const QStringList dirs(m_changed.cbegin(), m_changed.cend());
+    m_changed.clear();
+    emit directoriesChanged(dirs);
+}
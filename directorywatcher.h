@@ -0,0 +1,55 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// directorywatcher.h — слежение за каталогами строк таблицы
+//
+// Следит не за файлами, а за их родительскими каталогами: шифрование
+// переименовывает foo в foo.kuz, и слежение за самим файлом потерялось бы
+// вместе с ним. На Linux QFileSystemWatcher работает через inotify.
+//
+// События копятся и отдаются одним сигналом после короткой паузы:
+// пакет из тысячи файлов даёт тысячи событий, а проверка каждого
+// затронутого каталога нужна один раз.
+#ifndef DIRECTORYWATCHER_H
+#define DIRECTORYWATCHER_H
+
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+
+class DirectoryWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DirectoryWatcher(QObject *parent = nullptr);
+
+    // Полный набор каталогов; добавляются и снимаются только отличия
+    void setDirectories(const QStringList &dirs);
+    QStringList directories() const { return m_watcher.directories(); }
+
+    // Пауза перед сигналом, мс
+    void setCoalesceInterval(int msec) { m_timer.setInterval(msec); }
+
+signals:
+    // Каталоги, в которых что-то появилось, пропало или переименовалось
+    void directoriesChanged(const QStringList &dirs);
+
+private slots:
+    void onDirectoryChanged(const QString &dir);
+    void flush();
+
+private:
+    QFileSystemWatcher m_watcher;
+    QTimer m_timer;
+    QSet<QString> m_changed;
+};
+
+#endif // DIRECTORYWATCHER_H
@@ -0,0 +1,366 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+#include "filetablemodel.h"
+#include <QColor>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+// Больше разрозненных диапазонов — дешевле сбросить модель целиком,
+// чем оповещать представление о каждом
+constexpr int MaxRemoveRanges = 32;
+
+const char *methodName(FileTableModel::Method method)
+{
+    switch (method) {
+    case FileTableModel::Kuznechik: return "Кузнечик";
+    case FileTableModel::Magma: return "Магма";
+    case FileTableModel::UnknownMethod: return "Неизвестный";
+    case FileTableModel::NoMethod: break;
+    }
+    return "—";
+}
+
+QString statusText(FileTableModel::Status status, FileTableModel::Method method)
+{
+    switch (status) {
+    case FileTableModel::Current:
+        return QStringLiteral("Актуален");
+    case FileTableModel::Encrypted:
+        return QStringLiteral("Зашифровано (%1)").arg(QString::fromUtf8(methodName(method)));
+    case FileTableModel::Decrypted:
+        return method == FileTableModel::Magma ? QStringLiteral("Расшифровано (была Магма)")
+                                               : QStringLiteral("Расшифровано (был Кузнечик)");
+    case FileTableModel::Missing:
+        return QStringLiteral("Не найден");
+    case FileTableModel::NotChecked:
+        break;
+    }
+    return QStringLiteral("—");
+}
+
+} // namespace
+
+quint32 PathPool::add(const QString &path)
+{
+    const int slash = path.lastIndexOf('/');
+    const QString dir = path.left(slash);
+    const QByteArray name = path.mid(slash + 1).toUtf8();
+
+    auto it = m_dirIds.constFind(dir);
+    if (it == m_dirIds.constEnd()) {
+        it = m_dirIds.insert(dir, quint32(m_dirs.size()));
+        m_dirs.append(dir);
+    }
+
+    const quint32 id = quint32(m_dirOf.size());
+    m_dirOf.append(it.value());
+    m_nameStart.append(quint32(m_names.size()));
+    m_nameLength.append(quint16(name.size()));
+    m_names.append(name);
+    return id;
+}
+
+QString PathPool::path(quint32 id) const
+{
+    return m_dirs[m_dirOf[id]] + '/'
+         + QString::fromUtf8(m_names.constData() + m_nameStart[id], m_nameLength[id]);
+}
+
+void PathPool::clear()
+{
+    m_dirs.clear();
+    m_dirIds.clear();
+    m_names.clear();
+    m_dirOf.clear();
+    m_nameStart.clear();
+    m_nameLength.clear();
+}
+
+FileTableModel::FileTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_fileIcon(":/image/file.png")
+    , m_dirIcon(":/image/papka.png")
+    , m_lockIcon(":/image/lock.png")
+    , m_unlockIcon(":/image/unlock.png")
+    , m_okIcon(":/image/ok.png")
+    , m_errorIcon(":/image/error.png")
+{
+}
+
+int FileTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_pathIds.size();
+}
+
+int FileTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant FileTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_pathIds.size())
+        return QVariant();
+
+    const int row = index.row();
+    const Status rowStatus = status(row);
+    const Method rowMethod = method(row);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case NumberColumn: return row + 1;
+        case PathColumn: return isDir(row) ? path(row) + '/' : path(row);
+        case StatusColumn: return statusText(rowStatus, rowMethod);
+        case MethodColumn: return QString::fromUtf8(methodName(rowMethod));
+        }
+        break;
+    case Qt::DecorationRole:
+        if (index.column() == PathColumn)
+            return isDir(row) ? m_dirIcon : m_fileIcon;
+        if (index.column() == StatusColumn) {
+            switch (rowStatus) {
+            case Current: return m_okIcon;
+            case Encrypted: return m_lockIcon;
+            case Decrypted: return m_unlockIcon;
+            case Missing: return m_errorIcon;
+            case NotChecked: break;
+            }
+        }
+        break;
+    case Qt::ToolTipRole:
+        if (index.column() == PathColumn)
+            return path(row);
+        break;
+    case Qt::ForegroundRole:
+        if (index.column() == StatusColumn && rowStatus == Missing)
+            return QColor(0xd32f2f);
+        break;
+    }
+    return QVariant();
+}
+
+QVariant FileTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section) {
+    case NumberColumn: return QStringLiteral("Номер");
+    case PathColumn: return QStringLiteral("Путь");
+    case StatusColumn: return QStringLiteral("Состояние");
+    case MethodColumn: return QStringLiteral("Метод");
+    }
+    return QVariant();
+}
+
+int FileTableModel::addPath(const QString &path, bool isDir)
+{
+    const QString key = pathKey(path);
+    const int row = m_pathIds.size();
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_pathIds.append(m_pool.add(key));
+    m_status.append(NotChecked);
+    m_method.append(NoMethod);
+    m_isDir.append(isDir);
+    if (!m_indexDirty)
+        m_index.insert(keyHash(key), row);
+    endInsertRows();
+    return row;
+}
+
+void FileTableModel::removeRowsAt(QList<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (rows.isEmpty())
+        return;
+
+    // Соседние строки сливаются в диапазоны [first, last]
+    QVector<QPair<int, int>> ranges;
+    for (int row : std::as_const(rows)) {
+        if (!ranges.isEmpty() && ranges.last().second + 1 == row)
+            ranges.last().second = row;
+        else
+            ranges.append({ row, row });
+    }
+
+    if (ranges.size() > MaxRemoveRanges) {
+        // Один проход сжатия по всем массивам
+        beginResetModel();
+        int out = 0;
+        int next = 0;
+        for (int row = 0; row < m_pathIds.size(); ++row) {
+            if (next < rows.size() && rows[next] == row) {
+                ++next;
+                continue;
+            }
+            m_pathIds[out] = m_pathIds[row];
+            m_status[out] = m_status[row];
+            m_method[out] = m_method[row];
+            m_isDir[out] = m_isDir[row];
+            ++out;
+        }
+        m_pathIds.resize(out);
+        m_status.resize(out);
+        m_method.resize(out);
+        m_isDir.resize(out);
+        m_indexDirty = true;
+        endResetModel();
+        return;
+    }
+
+    // С конца, чтобы номера ещё не удалённых диапазонов не сдвигались
+    for (int i = ranges.size() - 1; i >= 0; --i) {
+        const int first = ranges[i].first;
+        const int count = ranges[i].second - first + 1;
+        beginRemoveRows(QModelIndex(), first, ranges[i].second);
+        m_pathIds.remove(first, count);
+        m_status.remove(first, count);
+        m_method.remove(first, count);
+        m_isDir.remove(first, count);
+        endRemoveRows();
+    }
+    m_indexDirty = true;
+}
+
+void FileTableModel::clear()
+{
+    beginResetModel();
+    m_pathIds.clear();
+    m_status.clear();
+    m_method.clear();
+    m_isDir.clear();
+    m_pool.clear();
+    m_index.clear();
+    m_indexDirty = false;
+    endResetModel();
+}
+
+void FileTableModel::setPath(int row, const QString &path)
+{
+    storePath(row, path);
+    emit dataChanged(index(row, PathColumn), index(row, PathColumn));
+}
+
+void FileTableModel::storePath(int row, const QString &path)
+{
+    const QString key = pathKey(path);
+    if (!m_indexDirty) {
+        m_index.remove(keyHash(this->path(row)), row);
+        m_index.insert(keyHash(key), row);
+    }
+    m_pathIds[row] = m_pool.add(key);
+}
+
+void FileTableModel::setState(int row, Status status, Method method)
+{
+    if (m_status[row] == status && m_method[row] == method)
+        return;
+    m_status[row] = status;
+    m_method[row] = method;
+    emit dataChanged(index(row, StatusColumn), index(row, MethodColumn));
+}
+
+void FileTableModel::applyUpdates(const QVector<RowUpdate> &updates)
+{
+    int first = m_pathIds.size();
+    int last = -1;
+    for (const RowUpdate &update : updates) {
+        if (update.row < 0 || update.row >= m_pathIds.size())
+            continue;
+        if (!update.path.isEmpty())
+            storePath(update.row, update.path);
+        m_status[update.row] = update.status;
+        m_method[update.row] = update.method;
+        first = qMin(first, update.row);
+        last = qMax(last, update.row);
+    }
+    if (last >= 0)
+        emit dataChanged(index(first, PathColumn), index(last, MethodColumn));
+}
+
+int FileTableModel::rowForPath(const QString &path) const
+{
+    if (m_indexDirty)
+        rebuildIndex();
+
+    const QString key = pathKey(path);
+    const auto range = m_index.equal_range(keyHash(key));
+    for (auto it = range.first; it != range.second; ++it) {
+        if (this->path(it.value()) == key)
+            return it.value();
+    }
+    return -1;
+}
+
+QString FileTableModel::pathKey(const QString &path)
+{
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+QStringList FileTableModel::directories() const
+{
+    // Сравниваются номера каталогов в пуле, строки не собираются
+    QVector<bool> used;
+    QStringList dirs;
+    for (quint32 id : m_pathIds) {
+        const quint32 dirId = m_pool.dirOf(id);
+        if (int(dirId) >= used.size())
+            used.resize(dirId + 1);
+        if (used[dirId])
+            continue;
+        used[dirId] = true;
+        const QString &dir = m_pool.dir(dirId);
+        dirs.append(dir.isEmpty() ? QStringLiteral("/") : dir);
+    }
+    return dirs;
+}
+
+QVector<int> FileTableModel::rowsInDirectories(const QStringList &dirs) const
+{
+    QVector<bool> wanted;
+    for (const QString &dir : dirs) {
+        const int dirId = m_pool.dirId(dir == QLatin1String("/") ? QString() : dir);
+        if (dirId < 0)
+            continue;
+        if (dirId >= wanted.size())
+            wanted.resize(dirId + 1);
+        wanted[dirId] = true;
+    }
+
+    QVector<int> rows;
+    if (wanted.isEmpty())
+        return rows;
+    for (int row = 0; row < m_pathIds.size(); ++row) {
+        const quint32 dirId = m_pool.dirOf(m_pathIds[row]);
+        if (int(dirId) < wanted.size() && wanted[dirId])
+            rows.append(row);
+    }
+    return rows;
+}
+
+quint32 FileTableModel::keyHash(const QString &key)
+{
+    return quint32(qHash(key));
+}
+
+void FileTableModel::rebuildIndex() const
+{
+    m_index.clear();
+    m_index.reserve(m_pathIds.size());
+    for (int row = 0; row < m_pathIds.size(); ++row)
+        m_index.insert(keyHash(path(row)), row);
+    m_indexDirty = false;
+}
@@ -0,0 +1,133 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// filetablemodel.h — модель таблицы файлов главного окна
+//
+// Строка занимает несколько байт в параллельных массивах: номер пути в пуле,
+// состояние, метод, признак папки. Номер строки, иконки и текст состояния
+// не хранятся, а вычисляются в data() только для видимых ячеек, поэтому
+// удаление строк не требует перенумерации, а миллион файлов укладывается
+// в десятки мегабайт.
+#ifndef FILETABLEMODEL_H
+#define FILETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QByteArray>
+#include <QHash>
+#include <QIcon>
+#include <QStringList>
+#include <QVector>
+
+// Пул путей: каталог хранится один раз, имя файла — в общем буфере UTF-8.
+// Номера только добавляются; место освобождается в clear().
+class PathPool
+{
+public:
+    quint32 add(const QString &path);
+    QString path(quint32 id) const;
+    // Номер каталога пути и каталог по номеру; -1 — каталог не встречался.
+    // Корень хранится пустой строкой
+    quint32 dirOf(quint32 id) const { return m_dirOf[id]; }
+    int dirId(const QString &dir) const { return int(m_dirIds.value(dir, quint32(-1))); }
+    const QString &dir(quint32 dirId) const { return m_dirs[dirId]; }
+    void clear();
+
+private:
+    QVector<QString> m_dirs;
+    QHash<QString, quint32> m_dirIds;
+    QByteArray m_names;
+    QVector<quint32> m_dirOf;       // по номеру пути
+    QVector<quint32> m_nameStart;
+    QVector<quint16> m_nameLength;
+};
+
+class FileTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { NumberColumn, PathColumn, StatusColumn, MethodColumn, ColumnCount };
+
+    enum Status : quint8 {
+        NotChecked,     // ещё не проверялся
+        Current,        // актуален, шифрованной копии нет
+        Encrypted,
+        Decrypted,      // рядом лежит шифрованная копия
+        Missing
+    };
+
+    enum Method : quint8 { NoMethod, Kuznechik, Magma, UnknownMethod };
+
+    struct RowUpdate {
+        int row;
+        QString path;       // пустой — путь не меняется
+        Status status;
+        Method method;
+    };
+
+    explicit FileTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // Возвращает номер добавленной строки
+    int addPath(const QString &path, bool isDir);
+    // Строки в любом порядке, повторы допустимы
+    void removeRowsAt(QList<int> rows);
+    void clear();
+
+    QString path(int row) const { return m_pool.path(m_pathIds[row]); }
+    bool isDir(int row) const { return m_isDir[row]; }
+    Status status(int row) const { return Status(m_status[row]); }
+    Method method(int row) const { return Method(m_method[row]); }
+
+    void setPath(int row, const QString &path);
+    void setState(int row, Status status, Method method);
+    // Пачка изменений с одним оповещением представления на всю пачку
+    void applyUpdates(const QVector<RowUpdate> &updates);
+
+    // Строка по пути за O(1); -1, если пути нет в таблице
+    int rowForPath(const QString &path) const;
+    // Абсолютный путь без "." и ".." — считается без обращения к диску,
+    // поэтому годится и для уже удалённого исходного файла
+    static QString pathKey(const QString &path);
+
+    // Родительские каталоги строк, без повторов
+    QStringList directories() const;
+    // Строки, лежащие прямо в одном из каталогов (пути в виде pathKey);
+    // один проход по таблице на любое число каталогов
+    QVector<int> rowsInDirectories(const QStringList &dirs) const;
+
+private:
+    static quint32 keyHash(const QString &key);
+    void storePath(int row, const QString &path);
+    void rebuildIndex() const;
+
+    PathPool m_pool;
+    QVector<quint32> m_pathIds;
+    QVector<quint8> m_status;
+    QVector<quint8> m_method;
+    QVector<bool> m_isDir;
+
+    // Хеш пути → строки; совпадение проверяется сравнением пути.
+    // После удаления строк номера сдвигаются, и индекс строится заново
+    // при следующем поиске, а не на каждое удаление.
+    mutable QMultiHash<quint32, int> m_index;
+    mutable bool m_indexDirty = false;
+
+    QIcon m_fileIcon;
+    QIcon m_dirIcon;
+    QIcon m_lockIcon;
+    QIcon m_unlockIcon;
+    QIcon m_okIcon;
+    QIcon m_errorIcon;
+};
+
+#endif // FILETABLEMODEL_H
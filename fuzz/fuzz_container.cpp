@@ -0,0 +1,45 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// fuzz/fuzz_container.cpp — разбор заголовка и фрагментов из враждебных данных
+#include <QBuffer>
+#include <cstdlib>
+#include "core/container.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    const QByteArray input(reinterpret_cast<const char *>(data), static_cast<int>(size));
+
+    // Разобранный заголовок обязан сериализоваться обратно в те же байты
+    ContainerHeader header;
+    int consumed = 0;
+    if (ContainerHeader::parse(input, header, &consumed)) {
+        if (consumed > input.size() || header.serialize() != input.left(consumed))
+            abort();
+    }
+
+    QBuffer buffer;
+    buffer.setData(input);
+    buffer.open(QIODevice::ReadOnly);
+
+    ContainerReader reader(&buffer);
+    if (!reader.readHeader())
+        return 0;
+
+    ContainerChunk chunk;
+    quint64 expectedIndex = 0;
+    while (reader.readChunk(chunk)) {
+        if (chunk.index != expectedIndex++
+            || static_cast<quint32>(chunk.data.size()) > reader.header().chunkSize
+            || chunk.tag.size() != reader.header().tagSize())
+            abort();
+        if (chunk.last && !reader.atEnd())
+            abort();
+    }
+    return 0;
+}
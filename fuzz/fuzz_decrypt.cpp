@@ -0,0 +1,79 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// fuzz/fuzz_decrypt.cpp — потоковое расшифрование: враждебный контейнер,
+// а также дифференциальная проверка encrypt → порча → decrypt
+#include <QBuffer>
+#include <QtEndian>
+#include <cstdlib>
+#include "core/fileprocessor.h"
+
+static QByteArray run(bool encrypt, const QByteArray &input, bool *ok, AlgorithmId algorithm = AlgorithmId::Kuznechik)
+{
+    FileProcessor processor(QStringLiteral("fuzz"));
+    processor.setKdfIterations(1);
+    processor.setChunkSize(ContainerHeader::MinChunkSize);
+
+    QBuffer in;
+    in.setData(input);
+    in.open(QIODevice::ReadOnly);
+    QBuffer out;
+    out.open(QIODevice::WriteOnly);
+
+    *ok = encrypt ? processor.encryptStream(in, out, algorithm) : processor.decryptStream(in, out);
+    return out.data();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 6)
+        return 0;
+
+    const quint8 mode = data[0] % 4;
+    const quint32 position = qFromBigEndian<quint32>(data + 1);
+    const quint8 delta = data[5];
+    const QByteArray payload(reinterpret_cast<const char *>(data + 6), static_cast<int>(size - 6));
+
+    bool ok = false;
+    if (mode == 0) {
+        // Произвольные байты как контейнер: без падений и без вывода,
+        // подделать имитовставку без пароля невозможно
+        const QByteArray plain = run(false, payload, &ok);
+        if (ok || !plain.isEmpty())
+            abort();
+        return 0;
+    }
+
+    const AlgorithmId algorithm = (delta & 1) ? AlgorithmId::Magma : AlgorithmId::Kuznechik;
+    QByteArray container = run(true, payload, &ok, algorithm);
+    if (!ok)
+        abort();
+
+    if (mode == 1) {
+        // Без порчи — точное восстановление
+        const QByteArray plain = run(false, container, &ok);
+        if (!ok || plain != payload)
+            abort();
+    } else if (mode == 2) {
+        // Любой изменённый байт обязан обнаруживаться
+        if (delta == 0)
+            return 0;
+        const int at = static_cast<int>(position % static_cast<quint32>(container.size()));
+        container[at] = static_cast<char>(container[at] ^ delta);
+        run(false, container, &ok);
+        if (ok)
+            abort();
+    } else {
+        // Обрезанный контейнер — тоже
+        container.truncate(static_cast<int>(position % static_cast<quint32>(container.size())));
+        run(false, container, &ok);
+        if (ok)
+            abort();
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// fuzz/fuzz_kernels.cpp — эквивалентность реализаций гаммирования:
+// поблочный encryptCTR на эталонном ядре против applyCTR на ядре,
+// выбранном для этого процессора, в том числе со смещения
+#include <cstdlib>
+#include "crypto/kuznechik.h"
+#include "crypto/magma.h"
+#include "crypto/ctr.h"
+#include "crypto/dispatch.h"
+
+template<typename Cipher>
+static void check(Dispatch::Primitive primitive, const QByteArray &key, const QByteArray &iv,
+                  const QByteArray &data, int split)
+{
+    // Шифры запоминают ядро при создании
+    const QString best = Dispatch::available(primitive).first();
+    Dispatch::select(primitive, QStringLiteral("ref"));
+    Cipher refCipher;
+    Dispatch::select(primitive, best);
+    Cipher cipher;
+    if (!cipher.setKey(key) || !refCipher.setKey(key))
+        abort();
+
+    const QByteArray reference = encryptCTR(data, refCipher, iv);
+
+    QByteArray whole = data;
+    applyCTR(cipher, iv, 0, whole.data(), whole.size());
+    if (whole != reference)
+        abort();
+
+    // Два куска, граница по блоку: второй начинается со смещённого счётчика
+    const int n = cipher.blockSize();
+    const int head = qMin(split * n, data.size());
+    QByteArray parts = data;
+    applyCTR(cipher, iv, 0, parts.data(), head);
+    applyCTR(cipher, iv, static_cast<quint64>(split), parts.data() + head, parts.size() - head);
+    if (parts != reference)
+        abort();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 32 + 16 + 1)
+        return 0;
+
+    const char *p = reinterpret_cast<const char *>(data);
+    const QByteArray key(p, 32);
+    const QByteArray iv(p + 32, 16);
+    const int split = static_cast<quint8>(p[48]);
+    const QByteArray payload(p + 49, static_cast<int>(size - 49));
+
+    check<Kuznechik>(Dispatch::KuznechikEncrypt, key, iv, payload, split);
+    check<Magma>(Dispatch::MagmaEncrypt, key, iv.left(8), payload, split);
+    return 0;
+}
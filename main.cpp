@@ -9,12 +9,41 @@
 #include "diplom.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
 #include <QLocale>
+#include <QSettings>
 #include <QTranslator>
+#include <cstdio>
+#include "crypto/dispatch.h"
+#include "crypto/random.h"
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
+    QApplication::setApplicationVersion(DIPLOM_VERSION);
+
+    // Ядра шифров: из настроек, переменная DIPLOM_KERNELS главнее
+    QSettings settings("MyCompany", "DiplomApp");
+    Dispatch::configure(settings.value("Kernels/Override").toString());
+    // Генератор соли и синхропосылок: "system" или "kuznechik-drbg"
+    SecureRandom::Generator generator;
+    const QString generatorName = settings.value("Random/Generator").toString();
+    if (SecureRandom::generatorFromName(generatorName, &generator))
+        SecureRandom::setGenerator(generator);
+    else
+        qWarning() << "Неизвестный генератор случайных чисел:" << generatorName;
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption versionOption({ "v", "version" }, "Версия и выбранные реализации шифров");
+    parser.addOption(versionOption);
+    parser.process(a);
+    if (parser.isSet(versionOption)) {
+        const QString text = QStringLiteral("Diplom %1\n%2").arg(QApplication::applicationVersion(), Dispatch::report());
+        fputs(text.toLocal8Bit().constData(), stdout);
+        return 0;
+    }
 
     QTranslator translator;
     const QStringList uiLanguages = QLocale::system().uiLanguages();
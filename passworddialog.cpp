@@ -7,8 +7,8 @@
  * Подробнее: https://www.gnu.org/licenses/gpl-3.0
  */
 #include "passworddialog.h"
+#include "crypto/random.h"
 #include "crypto/striborg.h"
-#include <QRandomGenerator>
 #include <QMessageBox>
 #include <QRegularExpression>
 
@@ -74,8 +74,10 @@ QString PasswordDialog::generatePassword()
 
     QString pass;
     for (int i = 0; i < length; ++i) {
-        int index = QRandomGenerator::global()->bounded(chars.size());
-        pass.append(chars[index]);
+        quint32 index = 0;
+        if (!SecureRandom::bounded(quint32(chars.size()), &index))
+            return "";
+        pass.append(chars[int(index)]);
     }
     return pass;
 }
@@ -10,6 +10,7 @@
 #include <QCloseEvent>
 #include <QSettings>
 #include <QApplication>
+#include "crypto/dispatch.h"
 
 static QMap<QString, QString> colorGradients() {
     return {
@@ -85,6 +86,9 @@ Settings::Settings(QWidget *parent)
     // Добавляем цвета в комбобокс
     ui->comboBox_set->addItems({"Тёмно-серый", "Красный", "Синий", "Голубой", "Жёлтый", "Фиолетовый", "Чёрный"});
 
+    // Какие реализации шифров выбраны для этого процессора
+    ui->plainTextEdit->appendPlainText("\nРеализации шифров:\n" + Dispatch::report());
+
     loadStyle();
 }
 
@@ -0,0 +1,205 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+#include "statusrefresher.h"
+#include "core/algorithms.h"
+#include "core/fileprocessor.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QThread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Entry = StatusRefresher::Entry;
+using Result = StatusRefresher::Result;
+
+struct DirGroup {
+    QString dir;
+    QVector<int> entries;   // номера в общем списке строк
+};
+
+FileTableModel::Method methodFor(AlgorithmId algorithm)
+{
+    return algorithm == AlgorithmId::Magma ? FileTableModel::Magma : FileTableModel::Kuznechik;
+}
+
+// Состояние строки по списку имён её каталога — без обращений к диску.
+// Имена контейнеров — как у FileProcessor: «отчёт.txt» → «отчёт.txt.kuz»
+Result resolveEntry(const Entry &entry, const QString &dir, const QString &name,
+                    const QSet<QString> &names)
+{
+    Result result{ entry.row, entry.path, QString(), FileTableModel::Current, FileTableModel::NoMethod };
+    const QString prefix = dir.endsWith('/') ? dir : dir + '/';
+
+    if (names.contains(name)) {
+        if (FileProcessor::isEncryptedName(name)) {
+            result.status = FileTableModel::Encrypted;
+            for (const AlgorithmInfo &info : Algorithms) {
+                if (name.endsWith(FileProcessor::extensionFor(info.id)))
+                    result.method = methodFor(info.id);
+            }
+            return result;
+        }
+        for (const AlgorithmInfo &info : Algorithms) {
+            if (names.contains(name + FileProcessor::extensionFor(info.id))) {
+                result.status = FileTableModel::Decrypted;
+                result.method = methodFor(info.id);
+                break;
+            }
+        }
+        return result;
+    }
+
+    // Исходного файла нет — ищется его шифрованная копия
+    for (const AlgorithmInfo &info : Algorithms) {
+        const QString candidate = name + FileProcessor::extensionFor(info.id);
+        if (names.contains(candidate)) {
+            result.path = prefix + candidate;
+            result.status = FileTableModel::Encrypted;
+            result.method = methodFor(info.id);
+            return result;
+        }
+    }
+    // Копии старых версий программы: «отчёт.enc», способ неизвестен
+    const QString legacy = QFileInfo(name).completeBaseName() + QLatin1String(".enc");
+    if (names.contains(legacy)) {
+        result.path = prefix + legacy;
+        result.status = FileTableModel::Encrypted;
+        result.method = FileTableModel::UnknownMethod;
+        return result;
+    }
+    result.status = FileTableModel::Missing;
+    return result;
+}
+
+QVector<Result> resolveAll(const QVector<Entry> &entries, int threads,
+                           const std::atomic<bool> *cancelled)
+{
+    // Пути в модели абсолютные и очищенные, каталог — всё до последнего '/'
+    QVector<DirGroup> groups;
+    QHash<QString, int> groupOf;
+    for (int i = 0; i < entries.size(); ++i) {
+        const QString &path = entries[i].path;
+        const int slash = path.lastIndexOf('/');
+        const QString dir = slash > 0 ? path.left(slash) : QStringLiteral("/");
+        auto it = groupOf.constFind(dir);
+        if (it == groupOf.constEnd()) {
+            it = groupOf.insert(dir, groups.size());
+            groups.append({ dir, {} });
+        }
+        groups[it.value()].entries.append(i);
+    }
+
+    QVector<Result> results;
+    results.reserve(entries.size());
+    std::mutex resultsMutex;
+    std::atomic<int> next{0};
+
+    auto work = [&]() {
+        QVector<Result> local;
+        for (int g = next.fetch_add(1); g < groups.size(); g = next.fetch_add(1)) {
+            if (cancelled && cancelled->load(std::memory_order_relaxed))
+                break;
+            const DirGroup &group = groups[g];
+            // Несуществующий каталог даёт пустой список: все его строки — «не найден»
+            const QStringList listing = QDir(group.dir).entryList(
+                QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+            const QSet<QString> names(listing.cbegin(), listing.cend());
+            for (int index : group.entries) {
+                const Entry &entry = entries[index];
+                const QString name = entry.path.mid(entry.path.lastIndexOf('/') + 1);
+                local.append(resolveEntry(entry, group.dir, name, names));
+            }
+        }
+        std::lock_guard<std::mutex> lock(resultsMutex);
+        results.append(local);
+    };
+
+    int count = threads > 0 ? threads : qMax(1, QThread::idealThreadCount());
+    count = qMin(count, groups.size());
+    if (count <= 1) {
+        work();
+        return results;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(count);
+    for (int i = 0; i < count; ++i)
+        workers.emplace_back(work);
+    for (std::thread &worker : workers)
+        worker.join();
+    return results;
+}
+
+} // namespace
+
+StatusRefresher::StatusRefresher(QObject *parent)
+    : QObject(parent)
+{
+}
+
+StatusRefresher::~StatusRefresher()
+{
+    cancel();
+    wait();
+}
+
+bool StatusRefresher::start(const QVector<Entry> &entries, int threads)
+{
+    if (isRunning())
+        return false;
+    wait();
+
+    m_cancelled.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.clear();
+    }
+    m_running.store(true, std::memory_order_release);
+    m_driver = std::thread(&StatusRefresher::drive, this, entries, threads);
+    return true;
+}
+
+void StatusRefresher::cancel()
+{
+    m_cancelled.store(true, std::memory_order_relaxed);
+}
+
+void StatusRefresher::wait()
+{
+    if (m_driver.joinable())
+        m_driver.join();
+}
+
+QVector<StatusRefresher::Result> StatusRefresher::takeResults()
+{
+    QVector<Result> results;
+    std::lock_guard<std::mutex> lock(m_resultsMutex);
+    results.swap(m_results);
+    return results;
+}
+
+QVector<StatusRefresher::Result> StatusRefresher::resolve(const QVector<Entry> &entries, int threads)
+{
+    return resolveAll(entries, threads, nullptr);
+}
+
+void StatusRefresher::drive(QVector<Entry> entries, int threads)
+{
+    QVector<Result> results = resolveAll(entries, threads, &m_cancelled);
+    {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results = std::move(results);
+    }
+    m_running.store(false, std::memory_order_release);
+    emit finished();
+}
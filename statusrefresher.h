@@ -0,0 +1,79 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// statusrefresher.h — фоновая проверка состояния строк таблицы
+//
+// Строки группируются по родительскому каталогу, каждый каталог читается
+// один раз, и все его строки сверяются с полученным списком имён: вместо
+// трёх-пяти обращений к диску на строку — одно на каталог. Каталоги
+// разбираются несколькими потоками, что важно для сетевых дисков, где
+// каждое обращение стоит миллисекунды.
+//
+// Итоги отдаются одной пачкой после finished() и применяются к модели
+// одним FileTableModel::applyUpdates().
+#ifndef STATUSREFRESHER_H
+#define STATUSREFRESHER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "filetablemodel.h"
+
+class StatusRefresher : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        int row;
+        QString path;
+    };
+
+    // Итог по строке. path — новый путь, если исходный файл пропал,
+    // а рядом нашлась его шифрованная копия; иначе пуст
+    struct Result {
+        int row;
+        QString source;
+        QString path;
+        FileTableModel::Status status;
+        FileTableModel::Method method;
+    };
+
+    explicit StatusRefresher(QObject *parent = nullptr);
+    ~StatusRefresher() override;
+
+    // threads — 0: по числу ядер. false, если проверка уже идёт
+    bool start(const QVector<Entry> &entries, int threads = 0);
+    void cancel();
+    void wait();
+    bool isRunning() const { return m_running.load(std::memory_order_acquire); }
+
+    // Итоги завершённой проверки; после отмены — только проверенные строки
+    QVector<Result> takeResults();
+
+    // Та же проверка в вызывающем потоке
+    static QVector<Result> resolve(const QVector<Entry> &entries, int threads = 0);
+
+signals:
+    void finished();
+
+private:
+    void drive(QVector<Entry> entries, int threads);
+
+    std::thread m_driver;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_cancelled{false};
+
+    std::mutex m_resultsMutex;
+    QVector<Result> m_results;
+};
+
+#endif // STATUSREFRESHER_H
@@ -0,0 +1,1061 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// tests/tst_core.cpp — потоковая обработка, формат контейнера, метрики
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QtEndian>
+#include <thread>
+
+#include "core/algorithms.h"
+#include "core/archive.h"
+#include "core/batchrunner.h"
+#include "core/compression.h"
+#include "core/dirscanner.h"
+#include "core/fileprocessor.h"
+#include "core/groupcommit.h"
+#include "core/inplacejournal.h"
+#include "core/manifest.h"
+#include "core/metrics.h"
+#include "core/progress.h"
+#include "core/trace.h"
+
+namespace {
+
+// Быстрые параметры: тестам не нужна стойкость KDF
+FileProcessor makeProcessor()
+{
+    FileProcessor processor(QStringLiteral("пароль"));
+    processor.setKdfIterations(1);
+    processor.setChunkSize(ContainerHeader::MinChunkSize);
+    return processor;
+}
+
+// Шифрование и расшифрование в памяти; пустой результат или false — ошибка
+QByteArray encrypt(FileProcessor &processor, const QByteArray &plain, AlgorithmId algorithm)
+{
+    QBuffer in;
+    in.setData(plain);
+    in.open(QIODevice::ReadOnly);
+    QBuffer out;
+    out.open(QIODevice::WriteOnly);
+    if (!processor.encryptStream(in, out, algorithm))
+        return QByteArray();
+    return out.data();
+}
+
+QByteArray encrypt(const QByteArray &plain, AlgorithmId algorithm)
+{
+    FileProcessor processor = makeProcessor();
+    return encrypt(processor, plain, algorithm);
+}
+
+bool decrypt(FileProcessor &processor, const QByteArray &sealed, QByteArray *plain = nullptr)
+{
+    QBuffer in;
+    in.setData(sealed);
+    in.open(QIODevice::ReadOnly);
+    QBuffer out;
+    out.open(QIODevice::WriteOnly);
+    if (!processor.decryptStream(in, out))
+        return false;
+    if (plain)
+        *plain = out.data();
+    return true;
+}
+
+// Контейнер с одним изменённым битом в каждом из мест at отвергается целиком
+bool rejectsForgery(FileProcessor &processor, const QByteArray &sealed, std::initializer_list<int> at)
+{
+    for (int offset : at) {
+        QByteArray forged = sealed;
+        forged[offset] = char(forged[offset] ^ 0x01);
+        if (decrypt(processor, forged))
+            return false;
+    }
+    return true;
+}
+
+// Дерево с вложенными каталогами, скрытыми записями и ссылкой на каталог;
+// возвращает пути файлов, которые должен найти обход
+QStringList makeTree(const QString &root)
+{
+    QStringList files;
+    QDir dir(root);
+    for (int a = 0; a < 12; ++a) {
+        const QString top = QStringLiteral("d%1").arg(a);
+        for (int b = 0; b < a % 4; ++b) {
+            const QString sub = top + QStringLiteral("/s%1").arg(b);
+            dir.mkpath(sub);
+            for (int f = 0; f < 3; ++f)
+                files.append(dir.filePath(sub + QStringLiteral("/f%1").arg(f)));
+        }
+        dir.mkpath(top);
+        files.append(dir.filePath(top + QStringLiteral("/top")));
+    }
+    for (const QString &path : std::as_const(files)) {
+        QFile file(path);
+        file.open(QIODevice::WriteOnly);
+        file.write(path.toUtf8());
+    }
+
+    dir.mkpath(QStringLiteral(".hidden"));
+    QFile(dir.filePath(QStringLiteral(".hidden/h"))).open(QIODevice::WriteOnly);
+    QFile(dir.filePath(QStringLiteral(".hf"))).open(QIODevice::WriteOnly);
+    QFile::link(dir.filePath(QStringLiteral("d3")), dir.filePath(QStringLiteral("link")));
+
+    files.sort();
+    return files;
+}
+
+} // namespace
+
+class TestCore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+    void metricsCountChunks();
+    void metricsDisabled();
+    void metricsExport();
+    void traceSpans();
+    void traceThreadBuffers();
+    void scannerFindsEachFileOnce_data();
+    void scannerFindsEachFileOnce();
+    void scannerCancel();
+    void batchRoundTrip();
+    void progressMeter();
+    void groupCommit();
+    void inPlaceRoundTrip();
+    void inPlaceResume();
+    void sparseRoundTrip();
+    void compressedRoundTrip();
+    void macRoundTrip_data();
+    void macRoundTrip();
+    void incrementalManifest();
+    void deltaUpdate();
+    void deltaUpdateSource();
+    void archiveRoundTrip();
+    void algorithmRegistry();
+};
+
+void TestCore::cleanup()
+{
+    Metrics::setEnabled(false);
+    Metrics::reset();
+    Trace::stop();
+}
+
+void TestCore::metricsCountChunks()
+{
+#if !DIPLOM_METRICS
+    QSKIP("Собрано с DIPLOM_METRICS=OFF");
+#endif
+    Metrics::setEnabled(true);
+    Metrics::reset();
+
+    // 5000 байт фрагментами по 1 КиБ: 4 полных и последний неполный
+    const QByteArray plain(5000, 'x');
+    const QByteArray container = encrypt(plain, AlgorithmId::Kuznechik);
+    QVERIFY(!container.isEmpty());
+
+    QCOMPARE(Metrics::counter(Metrics::Chunks), quint64(5));
+    QCOMPARE(Metrics::counter(Metrics::Blocks), quint64((5000 + 15) / 16));
+    QCOMPARE(Metrics::counter(Metrics::BytesIn), quint64(plain.size()));
+    QCOMPARE(Metrics::counter(Metrics::BytesOut), quint64(container.size()));
+    QCOMPARE(Metrics::stageCalls(Metrics::Kdf), quint64(1));
+    QCOMPARE(Metrics::stageCalls(Metrics::Cipher), quint64(5));
+    QCOMPARE(Metrics::stageCalls(Metrics::Mac), quint64(5));
+}
+
+void TestCore::metricsDisabled()
+{
+    Metrics::setEnabled(false);
+    Metrics::reset();
+
+    QVERIFY(!encrypt(QByteArray(3000, 'y'), AlgorithmId::Magma).isEmpty());
+    for (int i = 0; i < Metrics::CounterCount; ++i)
+        QCOMPARE(Metrics::counter(Metrics::Counter(i)), quint64(0));
+    for (int i = 0; i < Metrics::StageCount; ++i)
+        QCOMPARE(Metrics::stageCalls(Metrics::Stage(i)), quint64(0));
+}
+
+void TestCore::metricsExport()
+{
+    Metrics::reset();
+    Metrics::add(Metrics::BytesIn, 42);
+    Metrics::addTime(Metrics::Cipher, 1500000000);
+    Metrics::setGauge(Metrics::QueueDepth, 7);
+    Metrics::setGauge(Metrics::QueueDepth, 3);
+
+    const QByteArray prom = Metrics::toPrometheus();
+    QVERIFY(prom.contains("diplom_bytes_in_total 42\n"));
+    QVERIFY(prom.contains("diplom_stage_seconds_total{stage=\"cipher\"} 1.500000\n"));
+    QVERIFY(prom.contains("diplom_queue_depth 3\n"));
+    QVERIFY(prom.contains("diplom_queue_depth_max 7\n"));
+
+    const QJsonObject json = QJsonDocument::fromJson(Metrics::toJson()).object();
+    QCOMPARE(json["counters"].toObject()["bytes_in"].toInt(), 42);
+    QCOMPARE(json["stages"].toObject()["cipher"].toObject()["calls"].toInt(), 1);
+    QCOMPARE(json["gauges"].toObject()["queue_depth"].toObject()["max"].toInt(), 7);
+}
+
+void TestCore::traceSpans()
+{
+#if !DIPLOM_METRICS
+    QSKIP("Собрано с DIPLOM_METRICS=OFF");
+#endif
+    Trace::setThreadName(QStringLiteral("тест \"core\""));
+    Trace::start();
+    QVERIFY(!encrypt(QByteArray(3000, 'z'), AlgorithmId::Kuznechik).isEmpty());
+    Trace::stop();
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(Trace::toJson(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    int chunks = 0;
+    int stages = 0;
+    bool named = false;
+    const QJsonArray events = doc.object()["traceEvents"].toArray();
+    for (const QJsonValue &value : events) {
+        const QJsonObject e = value.toObject();
+        if (e["ph"].toString() == "M") {
+            named = e["args"].toObject()["name"].toString() == QStringLiteral("тест \"core\"");
+            continue;
+        }
+        QCOMPARE(e["ph"].toString(), QStringLiteral("X"));
+        QVERIFY(e["dur"].toDouble() >= 0);
+        if (e["cat"].toString() == "chunk")
+            ++chunks;
+        else if (e["cat"].toString() == "stage")
+            ++stages;
+    }
+    QVERIFY(named);
+    // 3000 байт фрагментами по 1 КиБ: три фрагмента по четыре стадии и KDF
+    QCOMPARE(chunks, 3);
+    QCOMPARE(stages, 3 * 4 + 1);
+}
+
+void TestCore::traceThreadBuffers()
+{
+#if !DIPLOM_METRICS
+    QSKIP("Собрано с DIPLOM_METRICS=OFF");
+#endif
+    // Без записи трассы имя потока буфер не заводит
+    std::thread([] { Trace::setThreadName(QStringLiteral("молчащий")); }).join();
+    Trace::start();
+    std::thread([] {
+        Trace::setThreadName(QStringLiteral("ушедший"));
+        DIPLOM_TRACE_SPAN("work", "stage");
+    }).join();
+    Trace::stop();
+    const QByteArray json = Trace::toJson();
+    QVERIFY(!json.contains("молчащий"));
+    QVERIFY(json.contains("ушедший"));
+    QCOMPARE(Trace::eventCount(), 1);
+
+    // Буфер завершившегося потока убирается вместе с его событиями
+    Trace::start();
+    Trace::stop();
+    QVERIFY(!Trace::toJson().contains("ушедший"));
+}
+
+void TestCore::scannerFindsEachFileOnce_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::newRow("1") << 1;
+    QTest::newRow("2") << 2;
+    QTest::newRow("8") << 8;
+}
+
+void TestCore::scannerFindsEachFileOnce()
+{
+    QFETCH(int, threads);
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QStringList expected = makeTree(tmp.path());
+
+    QMutex mutex;
+    QStringList found;
+    DirectoryScanner scanner(threads);
+    qint64 foundBytes = 0;
+    scanner.scan({ tmp.path() }, [&](const QString &filePath, qint64 size) {
+        QMutexLocker lock(&mutex);
+        found.append(filePath);
+        foundBytes += size;
+        return true;
+    });
+
+    found.sort();
+    QCOMPARE(found, expected);
+    QCOMPARE(scanner.fileCount(), quint64(expected.size()));
+
+    qint64 expectedBytes = 0;
+    for (const QString &path : expected)
+        expectedBytes += QFileInfo(path).size();
+    QCOMPARE(foundBytes, expectedBytes);
+}
+
+void TestCore::scannerCancel()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    makeTree(tmp.path());
+
+    std::atomic<int> seen{0};
+    DirectoryScanner scanner(4);
+    scanner.scan({ tmp.path() }, [&](const QString &, qint64) { return ++seen < 5; });
+
+    QVERIFY(scanner.isCancelled());
+    // Каждый поток успевает отдать не больше одного файла после отмены
+    QVERIFY(seen.load() <= 5 + scanner.threadCount());
+
+    // Отмена до начала обхода не теряется
+    DirectoryScanner early(4);
+    early.cancel();
+    early.scan({ tmp.path() }, [&](const QString &, qint64) { return ++seen > 0; });
+    QCOMPARE(early.fileCount(), quint64(0));
+}
+
+void TestCore::batchRoundTrip()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QStringList files = makeTree(tmp.path());
+
+    BatchOptions options;
+    options.password = QStringLiteral("пароль");
+    options.kdfIterations = 1;
+    options.workers = 3;
+    options.scanThreads = 3;
+    options.queueCapacity = 4;   // обход упирается в очередь
+    options.commitBatchSize = 5;
+
+    qint64 totalBytes = 0;
+    for (const QString &path : files)
+        totalBytes += QFileInfo(path).size();
+
+    BatchRunner runner;
+    for (bool encrypt : { true, false }) {
+        options.encrypt = encrypt;
+        QVERIFY(runner.start({ tmp.path() }, options));
+        runner.wait();
+
+        const QVector<BatchResult> results = runner.takeResults();
+        QCOMPARE(results.size(), files.size());
+        for (const BatchResult &item : results)
+            QVERIFY2(item.error.isEmpty(), qPrintable(item.source + ": " + item.error));
+        QVERIFY(runner.takeResults().isEmpty());
+
+        QVERIFY(runner.isScanFinished());
+        QCOMPARE(runner.filesDone(), quint64(files.size()));
+        QCOMPARE(runner.filesFailed(), quint64(0));
+        // Байты считаются по входу: открытые файлы, затем контейнеры
+        QCOMPARE(runner.bytesDone(), runner.bytesQueued());
+        if (encrypt)
+            QCOMPARE(runner.bytesQueued(), quint64(totalBytes));
+    }
+
+    for (const QString &path : files) {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), path.toUtf8());
+        QVERIFY(!QFile::exists(GroupCommit::tempPathFor(path + ".kuz")));
+        QVERIFY(!QFile::exists(GroupCommit::tempPathFor(path)));
+    }
+}
+
+void TestCore::progressMeter()
+{
+    const qint64 second = 1000000000;
+    ProgressMeter meter(0.5);
+    meter.start();
+
+    BatchProgress progress;
+    progress.bytesQueued = 100 * 1024 * 1024;
+    progress.workers = 2;
+    meter.sample(progress, 0);
+    QCOMPARE(meter.etaSeconds(), qint64(-1));
+
+    // 10 МиБ за секунду, обход ещё идёт — остаток не оценивается
+    progress.bytesDone = 10 * 1024 * 1024;
+    meter.sample(progress, second);
+    QCOMPARE(meter.bytesPerSecond(), 10.0 * 1024 * 1024);
+    QCOMPARE(meter.etaSeconds(), qint64(-1));
+    QVERIFY(meter.summary().contains(QStringLiteral("10.0 МБ/с")));
+
+    // Ещё 30 МиБ за секунду: среднее 0.5 * 30 + 0.5 * 10 = 20 МиБ/с,
+    // осталось 60 МиБ — три секунды
+    progress.bytesDone = 40 * 1024 * 1024;
+    progress.scanFinished = true;
+    meter.sample(progress, 2 * second);
+    QCOMPARE(meter.bytesPerSecond(), 20.0 * 1024 * 1024);
+    QCOMPARE(meter.etaSeconds(), qint64(3));
+    QCOMPARE(meter.fraction(), 0.4);
+    QVERIFY(meter.summary().contains(QStringLiteral("осталось 0:03")));
+}
+
+void TestCore::groupCommit()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    QDir dir(tmp.path());
+
+    const int count = 20;
+    QVector<GroupCommit::Entry> entries;
+    for (int i = 0; i < count; ++i) {
+        GroupCommit::Entry entry;
+        entry.source = dir.filePath(QStringLiteral("f%1").arg(i));
+        entry.target = entry.source + ".kuz";
+        entry.temp = GroupCommit::tempPathFor(entry.target);
+        for (const QString &path : { entry.source, entry.temp }) {
+            QFile file(path);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(path.toUtf8());
+        }
+        entries.append(entry);
+    }
+    // Занятое имя: результат не пишется поверх, исходный остаётся
+    QFile(entries[7].target).open(QIODevice::WriteOnly);
+
+    QMutex mutex;
+    QStringList done;
+    QStringList failed;
+    {
+        GroupCommit commit([&](const GroupCommit::Entry &entry, const QString &error) {
+            QMutexLocker locker(&mutex);
+            (error.isEmpty() ? done : failed).append(entry.source);
+        }, 8, 1000);
+        for (const GroupCommit::Entry &entry : std::as_const(entries))
+            commit.add(entry);
+        commit.finish();
+        // Две полные пачки и остаток
+        QCOMPARE(commit.batchCount(), quint64(3));
+    }
+
+    QCOMPARE(done.size(), count - 1);
+    QCOMPARE(failed, QStringList({ entries[7].source }));
+    for (int i = 0; i < count; ++i) {
+        const GroupCommit::Entry &entry = entries[i];
+        QVERIFY(!QFile::exists(entry.temp));
+        QCOMPARE(QFile::exists(entry.source), i == 7);
+        if (i == 7)
+            continue;
+        QFile file(entry.target);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), entry.temp.toUtf8());
+    }
+    QVERIFY(GroupCommit::isTempName(entries[0].temp));
+    QVERIFY(!GroupCommit::isTempName(entries[0].target));
+}
+
+namespace {
+
+QByteArray readFile(const QString &path)
+{
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void writeFile(const QString &path, const QByteArray &data)
+{
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    file.write(data);
+}
+
+} // namespace
+
+void TestCore::inPlaceRoundTrip()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = QDir(tmp.path()).filePath(QStringLiteral("data"));
+    const QString container = path + ".kuz";
+    FileProcessor processor = makeProcessor();
+
+    // Пустой файл, ровно два фрагмента и неполный последний
+    for (int size : { 0, 2 * int(ContainerHeader::MinChunkSize), 100000 }) {
+        QByteArray plain(size, 0);
+        for (int i = 0; i < size; ++i)
+            plain[i] = char(i * 7 + 3);
+        writeFile(path, plain);
+
+        QCOMPARE(processor.encryptInPlace(path, AlgorithmId::Kuznechik), container);
+        QVERIFY(!QFile::exists(path));
+        QVERIFY(!QFile::exists(InPlaceJournal::pathFor(path)));
+        // Длина данных сохраняется, сверх неё — только хвост
+        QFile sealed(container);
+        QVERIFY(sealed.open(QIODevice::ReadOnly));
+        InPlaceTrailer trailer;
+        QVERIFY(InPlaceTrailer::read(&sealed, trailer));
+        QCOMPARE(trailer.dataSize, quint64(size));
+        QVERIFY(sealed.seek(0));
+        QVERIFY(size == 0 || sealed.read(size) != plain);
+        sealed.close();
+
+        // decryptFile сам узнаёт контейнер «на месте» по хвосту
+        QCOMPARE(processor.decryptFile(container), path);
+        QVERIFY(!QFile::exists(container));
+        QCOMPARE(readFile(path), plain);
+    }
+
+    // Подделка: ошибка до первой записи, файл не тронут, журнала нет
+    QVERIFY(!processor.encryptInPlace(path, AlgorithmId::Magma).isEmpty());
+    const QString magma = path + ".mag";
+    QByteArray sealed = readFile(magma);
+    sealed[5000] = char(sealed[5000] ^ 1);
+    writeFile(magma, sealed);
+    QVERIFY(processor.decryptFile(magma).isEmpty());
+    QVERIFY(processor.errorString().contains(QStringLiteral("HMAC")));
+    QCOMPARE(readFile(magma), sealed);
+    QVERIFY(!QFile::exists(InPlaceJournal::pathFor(magma)));
+}
+
+void TestCore::inPlaceResume()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = QDir(tmp.path()).filePath(QStringLiteral("data"));
+    const QString container = path + ".kuz";
+    FileProcessor processor = makeProcessor();
+
+    QByteArray plain(100000, 0);
+    for (int i = 0; i < plain.size(); ++i)
+        plain[i] = char(i * 13 + 1);
+    writeFile(path, plain);
+    QVERIFY(!processor.encryptInPlace(path, AlgorithmId::Kuznechik).isEmpty());
+    const QByteArray sealed = readFile(container);
+
+    QBuffer buffer;
+    buffer.setData(sealed);
+    buffer.open(QIODevice::ReadOnly);
+    InPlaceTrailer trailer;
+    QVERIFY(InPlaceTrailer::read(&buffer, trailer));
+    QCOMPARE(trailer.dataSize, quint64(plain.size()));
+
+    const QByteArray cipherText = sealed.left(plain.size());
+    auto digests = [](const QByteArray &data) { return InPlaceJournal::unitDigests(data.constData(), data.size()); };
+
+    // Сбой шифрования посреди записи окна: в журнале дайджесты его участков,
+    // в файле — шифртекст до границы сектора и открытый текст после
+    QFile::remove(container);
+    {
+        InPlaceJournal journal;
+        QVERIFY(journal.create(InPlaceJournal::pathFor(path), InPlaceJournal::Encrypt, quint64(plain.size()),
+                               trailer.headerBytes, InPlaceJournal::WindowSize));
+        QVERIFY(journal.record(0, digests(plain), digests(cipherText)));
+    }
+    const int torn = 98 * InPlaceJournal::UnitSize;
+
+    // Участок, не совпавший ни с одним дайджестом, не восстанавливается
+    const QByteArray garbled = cipherText.left(torn) + QByteArray(InPlaceJournal::UnitSize, 'Z')
+                               + plain.mid(torn + InPlaceJournal::UnitSize);
+    writeFile(path, garbled);
+    QVERIFY(processor.encryptFile(path, AlgorithmId::Kuznechik).isEmpty());
+    QCOMPARE(readFile(path), garbled);
+    QVERIFY(QFile::exists(InPlaceJournal::pathFor(path)));
+
+    writeFile(path, cipherText.left(torn) + plain.mid(torn));
+    QCOMPARE(processor.encryptFile(path, AlgorithmId::Kuznechik), container);
+    QCOMPARE(readFile(container), sealed);
+    QVERIFY(!QFile::exists(InPlaceJournal::pathFor(path)));
+
+    // Сбой расшифрования после всех фрагментов: хвост снят наполовину
+    {
+        InPlaceJournal journal;
+        QVERIFY(journal.create(InPlaceJournal::pathFor(container), InPlaceJournal::Decrypt,
+                               quint64(plain.size()), trailer.headerBytes, InPlaceJournal::WindowSize));
+        QVERIFY(journal.record(0, digests(cipherText), digests(plain)));
+        QVERIFY(journal.record(trailer.chunkCount(), QVector<quint64>(), QVector<quint64>()));
+    }
+    writeFile(container, plain + sealed.mid(plain.size(), 100));
+    QCOMPARE(processor.decryptFile(container), path);
+    QCOMPARE(readFile(path), plain);
+    QVERIFY(!QFile::exists(InPlaceJournal::pathFor(container)));
+
+    QVERIFY(FileProcessor::isServiceName(InPlaceJournal::pathFor(path)));
+    QVERIFY(!FileProcessor::isServiceName(path));
+}
+
+void TestCore::sparseRoundTrip()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = QDir(tmp.path()).filePath(QStringLiteral("disk.img"));
+    const qint64 chunk = ContainerHeader::MinChunkSize;
+    const qint64 size = 256 * chunk;
+    {
+        // Данные в начале и в середине, дыра между ними и до конца
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray(3000, 'a'));
+        QVERIFY(file.seek(100 * chunk + 10));
+        file.write("middle");
+        QVERIFY(file.resize(size));
+    }
+    const QByteArray plain = readFile(path);
+    QCOMPARE(plain.size(), int(size));
+
+    FileProcessor processor = makeProcessor();
+    const QString container = processor.encryptFile(path, AlgorithmId::Kuznechik);
+    QVERIFY(!container.isEmpty());
+    if (QFileInfo(container).size() > size)
+        QSKIP("Файловая система не сообщает о дырах (SEEK_HOLE)");
+    // Шифртекст — только у фрагментов в блоках с данными
+    QVERIFY(QFileInfo(container).size() < size / 4);
+
+    // В поток дыры выходят нулями, в файл — снова дырами
+    QByteArray streamed;
+    QVERIFY(decrypt(processor, readFile(container), &streamed));
+    QCOMPARE(streamed, plain);
+
+    QCOMPARE(processor.decryptFile(container), path);
+    QCOMPARE(readFile(path), plain);
+}
+
+void TestCore::compressedRoundTrip()
+{
+    const int chunkSize = 16 * int(ContainerHeader::MinChunkSize);
+    QByteArray text;
+    for (int i = 0; text.size() < 5 * chunkSize; ++i)
+        text += "2025-01-01 12:00:00 INFO запрос " + QByteArray::number(i % 97) + " обработан\n";
+    QByteArray noise(4 * Compression::SampleSize, 0);
+    for (char &c : noise)
+        c = char(QRandomGenerator::global()->generate());
+
+    // Текст, несжимаемое посередине, ровно полный фрагмент
+    const QList<QByteArray> inputs = { text, text + noise + text, QByteArray(chunkSize, 'x') };
+    for (const QByteArray &plain : inputs) {
+        FileProcessor processor = makeProcessor();
+        processor.setChunkSize(quint32(chunkSize));
+        processor.setCompression(CompressionId::Deflate);
+        const QByteArray sealed = encrypt(processor, plain, AlgorithmId::Kuznechik);
+        QVERIFY(!sealed.isEmpty());
+
+        // Сжимаемая часть сокращается, несжимаемая хранится как есть
+        const int compressible = plain.size() - (plain.contains(noise) ? noise.size() : 0);
+        QVERIFY(sealed.size() < plain.size() - compressible / 2);
+        ContainerHeader header;
+        QVERIFY(ContainerHeader::parse(sealed, header));
+        QCOMPARE(header.compression, CompressionId::Deflate);
+
+        QByteArray back;
+        QVERIFY(decrypt(processor, sealed, &back));
+        QCOMPARE(back, plain);
+    }
+
+    CompressionId codec = CompressionId::None;
+    QVERIFY(Compression::fromName(QStringLiteral("Deflate"), &codec));
+    QCOMPARE(codec, CompressionId::Deflate);
+    QVERIFY(!Compression::fromName(QStringLiteral("lzma"), &codec));
+    // Несжимаемое отсеивается по пробе
+    QVERIFY(Compression::compress(CompressionId::Deflate, noise).isEmpty());
+
+    // Поток deflate длиннее заявленной в начале длины: заявлено не больше
+    // фрагмента, а распаковывается вдвое больше
+    QByteArray oversized = qCompress(QByteArray(2 * chunkSize, 'a'), 1);
+    qToBigEndian<quint32>(quint32(chunkSize), oversized.data());
+    QByteArray unpacked;
+    QVERIFY(!Compression::decompress(CompressionId::Deflate, oversized, chunkSize, unpacked));
+}
+
+// Имитовставка любого вида отвергает изменённый байт заголовка, info,
+// шифртекста и самой имитовставки. «На месте» — только HMAC; обновляемый
+// контейнер сохраняет CMAC, а MGM заменяет на HMAC
+void TestCore::macRoundTrip_data()
+{
+    QTest::addColumn<QString>("mac");
+    QTest::addColumn<QString>("algorithm");
+    QTest::addColumn<QString>("deltaMac");
+    for (const AlgorithmInfo &info : Algorithms) {
+        const QByteArray cipher = QByteArray(info.extension).mid(1);
+        const QString name = QString::fromUtf8(info.name);
+        QTest::newRow(("hmac-" + cipher).constData()) << QStringLiteral("HMAC") << name << QStringLiteral("hmac");
+        QTest::newRow(("mgm-" + cipher).constData()) << QStringLiteral("MGM") << name << QStringLiteral("hmac");
+        QTest::newRow(("cmac-" + cipher).constData()) << QStringLiteral("cmac") << name << QStringLiteral("cmac");
+    }
+}
+
+void TestCore::macRoundTrip()
+{
+    QFETCH(QString, mac);
+    QFETCH(QString, algorithm);
+    QFETCH(QString, deltaMac);
+    MacId macId = MacId::HmacStreebog256;
+    MacId deltaMacId = MacId::HmacStreebog256;
+    AlgorithmId algorithmId = AlgorithmId::Kuznechik;
+    QVERIFY(macFromName(mac, &macId));
+    QVERIFY(macFromName(deltaMac, &deltaMacId));
+    QVERIFY(FileProcessor::algorithmFromName(algorithm, &algorithmId));
+
+    const int chunkSize = int(ContainerHeader::MinChunkSize);
+    QByteArray plain(3 * chunkSize + 100, 0);
+    for (int i = 0; i < plain.size(); ++i)
+        plain[i] = char(i * 131 + 7);
+
+    FileProcessor processor = makeProcessor();
+    processor.setMac(macId);
+    const QByteArray sealed = encrypt(processor, plain, algorithmId);
+    QVERIFY(!sealed.isEmpty());
+
+    ContainerHeader header;
+    int headerSize = 0;
+    QVERIFY(ContainerHeader::parse(sealed, header, &headerSize));
+    QCOMPARE(header.mac, macId);
+    QCOMPARE(header.tagSize(), macId == MacId::HmacStreebog256 ? ContainerHeader::HmacTagSize
+                                                               : algorithmBlockSize(algorithmId));
+    QCOMPARE(qint64(sealed.size()), headerSize + 3 * header.recordSize(chunkSize) + header.recordSize(100));
+
+    QByteArray back;
+    QVERIFY2(decrypt(processor, sealed, &back), qPrintable(processor.errorString()));
+    QCOMPARE(back, plain);
+    QVERIFY(rejectsForgery(processor, sealed, { 20, headerSize + 1, headerSize + 10, int(sealed.size()) - 1 }));
+
+    header.flags |= ContainerHeader::FlagInPlace;
+    QCOMPARE(ContainerHeader::parse(header.serialize(), header), macId == MacId::HmacStreebog256);
+
+    // Обновляемый контейнер: отпечатки входят в имитовставку
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = QDir(tmp.path()).filePath(QStringLiteral("dump"));
+    const QString container = path + FileProcessor::extensionFor(algorithmId);
+    processor.setKeepSource(true);
+    writeFile(path, plain);
+    QCOMPARE(processor.updateFile(path, algorithmId), container);
+    QVERIFY(ContainerHeader::parse(readFile(container), header));
+    QVERIFY(header.isDelta());
+    QCOMPARE(header.mac, deltaMacId);
+
+    QByteArray edited = plain;
+    edited[chunkSize + 5] = 'Z';
+    writeFile(path, edited);
+    QCOMPARE(processor.updateFile(path, algorithmId), container);
+    QVERIFY2(decrypt(processor, readFile(container), &back), qPrintable(processor.errorString()));
+    QCOMPARE(back, edited);
+
+    header.mac = MacId::Mgm;
+    QVERIFY(!ContainerHeader::parse(header.serialize(), header));
+}
+
+void TestCore::incrementalManifest()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QStringList files = makeTree(tmp.path());
+
+    BatchOptions options;
+    options.password = QStringLiteral("пароль");
+    options.kdfIterations = 1;
+    options.workers = 3;
+    options.scanThreads = 3;
+    options.incremental = true;
+
+    BatchRunner runner;
+    auto rerun = [&](quint64 done, quint64 skipped) {
+        QVERIFY(runner.start({ tmp.path() }, options));
+        runner.wait();
+        QCOMPARE(runner.filesFailed(), quint64(0));
+        QCOMPARE(runner.filesDone(), done);
+        QCOMPARE(runner.filesSkipped(), skipped);
+    };
+    const quint64 total = quint64(files.size());
+
+    // Исходные остаются рядом с контейнерами, второй прогон ничего не читает
+    rerun(total, 0);
+    QVERIFY(QFile::exists(Manifest::pathFor(tmp.path())));
+    for (const QString &path : files)
+        QVERIFY(QFile::exists(path) && QFile::exists(path + ".kuz"));
+    rerun(0, total);
+
+    // Изменённый файл и файл без результата обрабатываются заново
+    {
+        QFile file(files.first());
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Append));
+        file.write("изменение");
+    }
+    QVERIFY(QFile::remove(files.last() + ".kuz"));
+    rerun(2, total - 2);
+
+    // Другое время изменения при том же содержимом решает дайджест
+    auto touch = [&](int days) {
+        QFile file(files.at(1));
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.setFileTime(QDateTime::currentDateTime().addDays(-days), QFileDevice::FileModificationTime));
+    };
+    touch(1);
+    rerun(1, total - 1);
+    options.manifestDigest = true;
+    rerun(0, total);
+    touch(2);
+    rerun(0, total);
+
+    // Записи удалённых файлов из описи уходят; чужой пароль её не открывает
+    QVERIFY(QFile::remove(files.at(2)));
+    rerun(0, total - 1);
+    Manifest manifest(tmp.path());
+    QVERIFY(manifest.load(options.password, options.kdfIterations));
+    QCOMPARE(manifest.size(), files.size() - 1);
+    Manifest stranger(tmp.path());
+    QVERIFY(!stranger.load(QStringLiteral("другой"), options.kdfIterations));
+}
+
+void TestCore::deltaUpdate()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = QDir(tmp.path()).filePath(QStringLiteral("dump"));
+    const QString container = path + ".kuz";
+    FileProcessor processor = makeProcessor();
+    processor.setKeepSource(true);
+
+    const int chunkSize = int(ContainerHeader::MinChunkSize);
+    QByteArray plain(10 * chunkSize + 300, 0);
+    for (int i = 0; i < plain.size(); ++i)
+        plain[i] = char(i * 7 + 3);
+    writeFile(path, plain);
+
+    auto decrypted = [&] {
+        QByteArray plain;
+        return decrypt(processor, readFile(container), &plain) ? plain : QByteArray("<ошибка>");
+    };
+    // Номера записей, которыми различаются два обновляемых контейнера
+    ContainerHeader header;
+    int headerSize = 0;
+    auto changedRecords = [&](const QByteArray &a, const QByteArray &b) {
+        QList<int> changed;
+        const qint64 record = header.recordSize(chunkSize);
+        for (int i = 0; headerSize + i * record < qMax(a.size(), b.size()); ++i) {
+            if (a.mid(int(headerSize + i * record), int(record)) != b.mid(int(headerSize + i * record), int(record)))
+                changed.append(i);
+        }
+        return changed;
+    };
+
+    // Контейнера нет — создаётся обновляемый; исходный остаётся
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QVERIFY(QFile::exists(path));
+    const QByteArray sealed = readFile(container);
+    QVERIFY(ContainerHeader::parse(sealed, header, &headerSize));
+    QVERIFY(header.isDelta());
+    QCOMPARE(decrypted(), plain);
+
+    // Без изменений не пишется ничего
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QCOMPARE(readFile(container), sealed);
+
+    // Изменён один байт — переписана одна запись
+    QByteArray edited = plain;
+    edited[3 * chunkSize + 5] = 'Z';
+    writeFile(path, edited);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QCOMPARE(changedRecords(sealed, readFile(container)), QList<int>({ 3 }));
+    QCOMPARE(decrypted(), edited);
+
+    // Прежнее содержимое шифруется на новой гамме, а не повторяет старую запись
+    writeFile(path, plain);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    const QByteArray reverted = readFile(container);
+    QCOMPARE(changedRecords(sealed, reverted), QList<int>({ 3 }));
+    QCOMPARE(decrypted(), plain);
+
+    // Рост и укорочение трогают только хвост
+    const QByteArray grown = plain + QByteArray(3000, 'q');
+    writeFile(path, grown);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QCOMPARE(changedRecords(reverted, readFile(container)), QList<int>({ 10, 11, 12, 13 }));
+    QCOMPARE(decrypted(), grown);
+    const QByteArray shrunk = plain.left(4 * chunkSize);
+    writeFile(path, shrunk);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QCOMPARE(QFileInfo(container).size(), headerSize + 4 * header.recordSize(chunkSize) + header.recordSize(0));
+    QCOMPARE(decrypted(), shrunk);
+
+    // Сбой посреди записи фрагмента: отпечаток новый, шифртекст недописан.
+    // Пока стоит метка, контейнер не расшифровывается; обновление его чинит
+    QByteArray torn = readFile(container);
+    torn[int(headerSize + header.recordSize(chunkSize) + 100)] ^= 1;
+    writeFile(container, torn);
+    const QString marker = QDir(tmp.path()).filePath(QStringLiteral(".dump.kuz.diplom-update"));
+    writeFile(marker, QByteArray(8, 0));
+    QVERIFY(FileProcessor::isServiceName(marker));
+    QVERIFY(processor.decryptFile(container).isEmpty());
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QVERIFY(!QFile::exists(marker));
+    QCOMPARE(decrypted(), shrunk);
+}
+
+void TestCore::deltaUpdateSource()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString path = QDir(tmp.path()).filePath(QStringLiteral("dump"));
+    const QString container = path + ".kuz";
+    FileProcessor processor = makeProcessor();
+
+    QByteArray plain(3 * int(ContainerHeader::MinChunkSize) + 17, 0);
+    for (int i = 0; i < plain.size(); ++i)
+        plain[i] = char(i * 11 + 7);
+    auto isDelta = [&] {
+        ContainerHeader header;
+        return ContainerHeader::parse(readFile(container), header) && header.isDelta();
+    };
+
+    // Нет ни исходного, ни контейнера: пустой контейнер не остаётся
+    QVERIFY(processor.updateFile(path, AlgorithmId::Kuznechik).isEmpty());
+    QVERIFY(!QFile::exists(container));
+
+    // Контейнера нет — создаётся обновляемый, исходный удаляется
+    writeFile(path, plain);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QVERIFY(!QFile::exists(path));
+    QVERIFY(isDelta());
+
+    // Обновление на месте тоже удаляет исходный
+    plain[5] = 'Z';
+    writeFile(path, plain);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QVERIFY(!QFile::exists(path));
+
+    // Обычный контейнер заменяется обновляемым, а не мешает ему
+    QVERIFY(QFile::remove(container));
+    writeFile(path, plain);
+    QCOMPARE(processor.encryptFile(path, AlgorithmId::Kuznechik), container);
+    QVERIFY(!isDelta());
+    writeFile(path, plain);
+    QCOMPARE(processor.updateFile(path, AlgorithmId::Kuznechik), container);
+    QVERIFY(isDelta());
+    QVERIFY(!QFile::exists(path));
+
+    QCOMPARE(processor.decryptFile(container), path);
+    QCOMPARE(readFile(path), plain);
+}
+
+void TestCore::archiveRoundTrip()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString root = QDir(tmp.path()).filePath(QStringLiteral("docs"));
+    QVERIFY(QDir().mkpath(root + "/sub/deep"));
+    QVERIFY(QDir().mkpath(root + "/sub/.cache"));
+    QByteArray big(5000, 0);
+    for (int i = 0; i < big.size(); ++i)
+        big[i] = char(i * 13 + 1);
+    const QMap<QString, QByteArray> files{
+        { QStringLiteral("a.txt"), QByteArray("привет") },
+        { QStringLiteral("sub/big.bin"), big },
+        { QStringLiteral("sub/deep/empty"), QByteArray() },
+        { QStringLiteral("sub/.cache/state"), QByteArray("скрытая папка") },
+        { QStringLiteral(".hidden"), QByteArray("скрытый") },
+        { QStringLiteral("z"), QByteArray("последний") },
+    };
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+        writeFile(root + '/' + it.key(), it.value());
+
+    // Папка целиком — один контейнер; исходные файлы и папки удалены
+    FileProcessor processor = makeProcessor();
+    std::atomic<quint64> queued{0};
+    std::atomic<quint64> done{0};
+    processor.setQueuedCounter(&queued);
+    processor.setProgressCounter(&done);
+    const QString archive = root + ".kuz";
+    QCOMPARE(processor.encryptDirectory(root, AlgorithmId::Kuznechik), archive);
+    QVERIFY(!QFileInfo::exists(root));
+    // Объём входа — из оглавления, без отдельного обхода: файлы и оглавление
+    QVERIFY(processor.archiveSize() > quint64(big.size()));
+    QCOMPARE(queued.load(), processor.archiveSize());
+    QCOMPARE(done.load(), processor.archiveSize());
+    processor.setQueuedCounter(nullptr);
+    processor.setProgressCounter(nullptr);
+    ContainerHeader header;
+    QVERIFY(ContainerHeader::parse(readFile(archive), header));
+    QVERIFY(header.isArchive());
+
+    QVector<ArchiveEntry> entries;
+    QVERIFY(processor.listArchive(archive, &entries));
+    QCOMPARE(entries.size(), files.size());
+    for (const ArchiveEntry &entry : std::as_const(entries))
+        QCOMPARE(entry.size, quint64(files.value(entry.path).size()));
+
+    // Отдельный файл — без распаковки остальных
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        QBuffer out;
+        out.open(QIODevice::WriteOnly);
+        QVERIFY2(processor.extractFromArchive(archive, it.key(), out), qPrintable(processor.errorString()));
+        QCOMPARE(out.data(), it.value());
+    }
+    QBuffer missing;
+    missing.open(QIODevice::WriteOnly);
+    QVERIFY(!processor.extractFromArchive(archive, QStringLiteral("нет"), missing));
+
+    // Повреждённый архив не распаковывается и ничего не оставляет
+    QByteArray damaged = readFile(archive);
+    damaged[damaged.size() / 2] ^= 1;
+    const QString broken = QDir(tmp.path()).filePath(QStringLiteral("broken.kuz"));
+    writeFile(broken, damaged);
+    QVERIFY(processor.decryptFile(broken).isEmpty());
+    QVERIFY(!QFileInfo::exists(QDir(tmp.path()).filePath(QStringLiteral("broken"))));
+    QVERIFY(!QFileInfo::exists(GroupCommit::tempPathFor(QDir(tmp.path()).filePath(QStringLiteral("broken")))));
+
+    // Полная распаковка — папка на прежнем месте
+    QCOMPARE(processor.decryptFile(archive), root);
+    QVERIFY(!QFile::exists(archive));
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+        QCOMPARE(readFile(root + '/' + it.key()), it.value());
+
+    // Выход из корня по оглавлению невозможен
+    QVERIFY(ArchiveIndex::isSafePath(QStringLiteral("a/b")));
+    QVERIFY(!ArchiveIndex::isSafePath(QStringLiteral("../a")));
+    QVERIFY(!ArchiveIndex::isSafePath(QStringLiteral("/etc/passwd")));
+    QVERIFY(!ArchiveIndex::isSafePath(QStringLiteral("a//b")));
+}
+
+// Каждый алгоритм реестра: название, расширение и размер блока сходятся
+// с FileProcessor и заголовком, контейнер расшифровывается
+void TestCore::algorithmRegistry()
+{
+    for (const AlgorithmInfo &info : Algorithms) {
+        AlgorithmId id = AlgorithmId(0);
+        QVERIFY(FileProcessor::algorithmFromName(QString::fromUtf8(info.name), &id));
+        QCOMPARE(id, info.id);
+        QCOMPARE(FileProcessor::extensionFor(id), QString::fromLatin1(info.extension));
+        QVERIFY(FileProcessor::isEncryptedName(QStringLiteral("a.txt") + QLatin1String(info.extension)));
+        QCOMPARE(algorithmBlockSize(id), info.blockSize);
+
+        const QByteArray plain(3 * ContainerHeader::MinChunkSize + 5, 'r');
+        const QByteArray container = encrypt(plain, id);
+        QVERIFY(!container.isEmpty());
+        QCOMPARE(quint8(container[5]), quint8(id));
+
+        FileProcessor processor = makeProcessor();
+        QByteArray back;
+        QVERIFY2(decrypt(processor, container, &back), qPrintable(processor.errorString()));
+        QCOMPARE(back, plain);
+    }
+    AlgorithmId id;
+
+    MacId mac = MacId::Cmac;
+    QVERIFY(macFromName(QString(), &mac));
+    QCOMPARE(mac, MacId::HmacStreebog256);
+    QVERIFY(!macFromName(QStringLiteral("poly1305"), &mac));
+    QVERIFY(!FileProcessor::algorithmFromName(QStringLiteral("AES"), &id));
+    QVERIFY(!FileProcessor::isEncryptedName(QStringLiteral("a.txt")));
+    QVERIFY(encrypt(QByteArray(10, 'x'), AlgorithmId(7)).isEmpty());
+}
+
+QTEST_APPLESS_MAIN(TestCore)
+#include "tst_core.moc"
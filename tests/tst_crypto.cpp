@@ -0,0 +1,590 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// tests/tst_crypto.cpp — эталонные векторы ГОСТ и перекрёстные проверки.
+// Любая оптимизированная реализация шифров обязана проходить эти тесты.
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QSet>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "crypto/kuznechik.h"
+#include "crypto/magma.h"
+#include "crypto/striborg.h"
+#include "crypto/cmac.h"
+#include "crypto/ctr.h"
+#include "crypto/dispatch.h"
+#include "crypto/hmac.h"
+#include "crypto/mgm.h"
+#include "crypto/random.h"
+
+namespace {
+
+// Ключи и открытые тексты из ГОСТ Р 34.12-2015 / Р 34.13-2015
+const QByteArray kuzKey = QByteArray::fromHex(
+    "8899aabbccddeeff0011223344556677fedcba98765432100123456789abcdef");
+const QByteArray kuzPlain = QByteArray::fromHex(
+    "1122334455667700ffeeddccbbaa9988"
+    "00112233445566778899aabbcceeff0a"
+    "112233445566778899aabbcceeff0a00"
+    "2233445566778899aabbcceeff0a0011");
+
+const QByteArray magmaKey = QByteArray::fromHex(
+    "ffeeddccbbaa99887766554433221100f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+const QByteArray magmaPlain = QByteArray::fromHex(
+    "92def06b3c130a59"
+    "db54c704f8189d20"
+    "4a98fb2e67a8024c"
+    "8912409b17b57e41");
+
+QByteArray streebog(const QByteArray &message, int mode)
+{
+    Streebog hash(mode);
+    QByteArray copy = message;
+    unsigned char *h = hash.hash(reinterpret_cast<unsigned char *>(copy.data()), copy.size());
+    QByteArray result(reinterpret_cast<char *>(h), mode / 8);
+    free(h);
+    return result;
+}
+
+QByteArray randomBytes(QRandomGenerator &rng, int length)
+{
+    QByteArray data(length, 0);
+    for (int i = 0; i < length; ++i)
+        data[i] = static_cast<char>(rng.bounded(256));
+    return data;
+}
+
+// Эталонный CTR: гамма вырабатывается поблочно через encryptBlock
+template<typename Cipher>
+QByteArray referenceCTR(const QByteArray &data, Cipher &cipher, const QByteArray &iv)
+{
+    QByteArray result = data;
+    QByteArray counter = iv;
+    const int n = cipher.blockSize();
+    for (int offset = 0; offset < data.size(); offset += n) {
+        const QByteArray gamma = cipher.encryptBlock(counter);
+        for (int j = 0; j < n && offset + j < data.size(); ++j)
+            result[offset + j] = static_cast<char>(result[offset + j] ^ gamma[j]);
+        for (int k = n - 1; k >= 0; --k) {
+            counter[k] = static_cast<char>(counter[k] + 1);
+            if (counter[k] != 0) break;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+class TestCrypto : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void kuznechikBlock();
+    void magmaBlock();
+    void streebogVectors_data();
+    void streebogVectors();
+    void kuznechikCtr();
+    void magmaCtr();
+    void mgmVectors();
+    void cmacVectors();
+    void randomRoundTrip();
+    void ctrCrossCheck();
+    void sharedKeySchedule();
+    void kernelsAgree_data();
+    void kernelsAgree();
+    void secureRandom_data();
+    void secureRandom();
+    void macThroughput_data();
+    void macThroughput();
+};
+
+// ГОСТ Р 34.12-2015, приложение А.1
+void TestCrypto::kuznechikBlock()
+{
+    Kuznechik kuz;
+    QVERIFY(kuz.setKey(kuzKey));
+
+    const QByteArray plain = QByteArray::fromHex("1122334455667700ffeeddccbbaa9988");
+    const QByteArray cipher = QByteArray::fromHex("7f679d90bebc24305a468d42b9d4edcd");
+    QCOMPARE(kuz.encryptBlock(plain).toHex(), cipher.toHex());
+    QCOMPARE(kuz.decryptBlock(cipher).toHex(), plain.toHex());
+
+    QVERIFY(kuz.encryptBlock(QByteArray(15, 0)).isEmpty());
+    QVERIFY(!kuz.setKey(QByteArray(31, 0)));
+}
+
+// ГОСТ Р 34.12-2015, приложение А.2
+void TestCrypto::magmaBlock()
+{
+    Magma magma;
+    QVERIFY(magma.setKey(magmaKey));
+
+    const QByteArray plain = QByteArray::fromHex("fedcba9876543210");
+    const QByteArray cipher = QByteArray::fromHex("4ee901e5c2d8ca3d");
+    QCOMPARE(magma.encryptBlock(plain).toHex(), cipher.toHex());
+    QCOMPARE(magma.decryptBlock(cipher).toHex(), plain.toHex());
+
+    QVERIFY(magma.encryptBlock(QByteArray(7, 0)).isEmpty());
+}
+
+// ГОСТ Р 34.11-2012, приложение А (сообщения M1 и M2 в порядке записи стандарта)
+void TestCrypto::streebogVectors_data()
+{
+    QTest::addColumn<QByteArray>("message");
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<QByteArray>("digest");
+
+    const QByteArray m1 = QByteArray::fromHex(
+        "323130393837363534333231303938373635343332313039383736353433323130"
+        "393837363534333231303938373635343332313039383736353433323130");
+    const QByteArray m2 = QByteArray::fromHex(
+        "fbe2e5f0eee3c820fbeafaebef20fffbf0e1e0f0f520e0ed20e8ece0ebe5f0f2f1"
+        "20fff0eeec20f120faf2fee5e2202ce8f6f3ede220e8e6eee1e8f0f2d1202ce8f0"
+        "f2e5e220e5d1");
+
+    QTest::newRow("M1-512") << m1 << 512 << QByteArray::fromHex(
+        "486f64c1917879417fef082b3381a4e211c324f074654c38823a7b76f830ad00"
+        "fa1fbae42b1285c0352f227524bc9ab16254288dd6863dccd5b9f54a1ad0541b");
+    QTest::newRow("M1-256") << m1 << 256 << QByteArray::fromHex(
+        "00557be5e584fd52a449b16b0251d05d27f94ab76cbaa6da890b59d8ef1e159d");
+    QTest::newRow("M2-512") << m2 << 512 << QByteArray::fromHex(
+        "28fbc9bada033b1460642bdcddb90c3fb3e56c497ccd0f62b8a2ad4935e85f03"
+        "7613966de4ee00531ae60f3b5a47f8dae06915d5f2f194996fcabf2622e6881e");
+    QTest::newRow("M2-256") << m2 << 256 << QByteArray::fromHex(
+        "508f7e553c06501d749a66fc28c6cac0b005746d97537fa85d9e40904efed29d");
+}
+
+void TestCrypto::streebogVectors()
+{
+    QFETCH(QByteArray, message);
+    QFETCH(int, mode);
+    QFETCH(QByteArray, digest);
+
+    QCOMPARE(streebog(message, mode).toHex(), digest.toHex());
+}
+
+// ГОСТ Р 34.13-2015, п. А.1.2: IV = 1234567890abcef0, счётчик IV || 0^64
+void TestCrypto::kuznechikCtr()
+{
+    Kuznechik kuz;
+    QVERIFY(kuz.setKey(kuzKey));
+
+    const QByteArray iv = QByteArray::fromHex("1234567890abcef0") + QByteArray(8, 0);
+    const QByteArray expected = QByteArray::fromHex(
+        "f195d8bec10ed1dbd57b5fa240bda1b8"
+        "85eee733f6a13e5df33ce4b33c45dee4"
+        "a5eae88be6356ed3d5e877f13564a3a5"
+        "cb91fab1f20cbab6d1c6d15820bdba73");
+
+    QCOMPARE(encryptCTR(kuzPlain, kuz, iv).toHex(), expected.toHex());
+    QCOMPARE(decryptCTR(expected, kuz, iv).toHex(), kuzPlain.toHex());
+}
+
+// ГОСТ Р 34.13-2015, п. А.2.2: IV = 12345678, счётчик IV || 0^32
+void TestCrypto::magmaCtr()
+{
+    Magma magma;
+    QVERIFY(magma.setKey(magmaKey));
+
+    const QByteArray iv = QByteArray::fromHex("12345678") + QByteArray(4, 0);
+    const QByteArray expected = QByteArray::fromHex(
+        "4e98110c97b7b93c"
+        "3e250d93d6e85d69"
+        "136d868807b2dbef"
+        "568eb680ab52a12d");
+
+    QCOMPARE(encryptCTR(magmaPlain, magma, iv).toHex(), expected.toHex());
+    QCOMPARE(decryptCTR(expected, magma, iv).toHex(), magmaPlain.toHex());
+}
+
+// RFC 9058, приложение A: MGM на Кузнечике и Магме, имитовставка — полный блок
+void TestCrypto::mgmVectors()
+{
+    {
+        const KuznechikKey key(kuzKey);
+        const QByteArray nonce = QByteArray::fromHex("1122334455667700ffeeddccbbaa9988");
+        const QByteArray ad = QByteArray::fromHex(
+            "02020202020202020101010101010101"
+            "04040404040404040303030303030303"
+            "ea0505050505050505");
+        const QByteArray plain = QByteArray::fromHex(
+            "1122334455667700ffeeddccbbaa9988"
+            "00112233445566778899aabbcceeff0a"
+            "112233445566778899aabbcceeff0a00"
+            "2233445566778899aabbcceeff0a0011"
+            "aabbcc");
+        const Mgm<KuznechikKey> mgm(key, reinterpret_cast<const quint8 *>(nonce.constData()));
+        QByteArray data = plain;
+        QByteArray tag(Mgm<KuznechikKey>::TagSize, 0);
+        mgm.encrypt(ad.constData(), ad.size(), data.data(), data.size(), reinterpret_cast<quint8 *>(tag.data()));
+        QCOMPARE(data.toHex(), QByteArray("a9757b8147956e9055b8a33de89f42fc"
+                                          "8075d2212bf9fd5bd3f7069aadc16b39"
+                                          "497ab15915a6ba85936b5d0ea9f6851c"
+                                          "c60c14d4d3f883d0ab94420695c76deb"
+                                          "2c7552"));
+        QCOMPARE(tag.toHex(), QByteArray("cf5d656f40c34f5c46e8bb0e29fcdb4c"));
+
+        QByteArray check(tag.size(), 0);
+        mgm.computeTag(ad.constData(), ad.size(), data.constData(), data.size(), reinterpret_cast<quint8 *>(check.data()));
+        QCOMPARE(check, tag);
+        // Расшифрование части — с её блока
+        QByteArray tail = data.mid(32);
+        mgm.crypt(2, tail.data(), tail.size());
+        QCOMPARE(tail, plain.mid(32));
+        mgm.crypt(0, data.data(), data.size());
+        QCOMPARE(data, plain);
+    }
+    {
+        const MagmaKey key(magmaKey);
+        const QByteArray nonce = QByteArray::fromHex("12def06b3c130a59");
+        const QByteArray ad = QByteArray::fromHex(
+            "0101010101010101020202020202020203030303030303030404040404040404"
+            "0505050505050505ea");
+        const QByteArray plain = QByteArray::fromHex(
+            "ffeeddccbbaa998811223344556677008899aabbcceeff0a0011223344556677"
+            "99aabbcceeff0a001122334455667788aabbcceeff0a00112233445566778899"
+            "aabbcc");
+        const Mgm<MagmaKey> mgm(key, reinterpret_cast<const quint8 *>(nonce.constData()));
+        QByteArray data = plain;
+        QByteArray tag(Mgm<MagmaKey>::TagSize, 0);
+        mgm.encrypt(ad.constData(), ad.size(), data.data(), data.size(), reinterpret_cast<quint8 *>(tag.data()));
+        QCOMPARE(data.toHex(), QByteArray("c795066c5f9ea03b85113342459185ae1f2e00d6bf2b785d940470b8bb9c8e7d"
+                                          "9a5dd3731f7ddc70ec27cb0ace6fa57670f65c646abb75d547aa37c3bcb5c34e"
+                                          "03bb9c"));
+        QCOMPARE(tag.toHex(), QByteArray("a7928069aa10fd10"));
+        mgm.crypt(0, data.data(), data.size());
+        QCOMPARE(data, plain);
+    }
+}
+
+// ГОСТ Р 34.13-2015, А.1.6 и А.2.6: имитовставка — старшие s бит
+void TestCrypto::cmacVectors()
+{
+    {
+        const KuznechikKey key(kuzKey);
+        Cmac<KuznechikKey> cmac(key);
+        cmac.update(kuzPlain.constData(), kuzPlain.size());
+        QByteArray tag(Cmac<KuznechikKey>::TagSize, 0);
+        cmac.finish(reinterpret_cast<quint8 *>(tag.data()));
+        QCOMPARE(tag.left(8).toHex(), QByteArray("336f4d296059fbe3"));
+
+        // Те же данные частями, и неполный последний блок
+        for (int split : { 1, 15, 16, 17, 40 }) {
+            Cmac<KuznechikKey> parts(key);
+            parts.update(kuzPlain.constData(), split);
+            parts.update(kuzPlain.constData() + split, kuzPlain.size() - split);
+            QByteArray again(tag.size(), 0);
+            parts.finish(reinterpret_cast<quint8 *>(again.data()));
+            QCOMPARE(again, tag);
+        }
+        Cmac<KuznechikKey> whole(key), shorter(key);
+        whole.update(kuzPlain.constData(), 40);
+        shorter.update(kuzPlain.constData(), 39);
+        QByteArray a(tag.size(), 0), b(tag.size(), 0);
+        whole.finish(reinterpret_cast<quint8 *>(a.data()));
+        shorter.finish(reinterpret_cast<quint8 *>(b.data()));
+        QVERIFY(a != b);
+    }
+    {
+        const MagmaKey key(magmaKey);
+        Cmac<MagmaKey> cmac(key);
+        cmac.update(magmaPlain.constData(), magmaPlain.size());
+        QByteArray tag(Cmac<MagmaKey>::TagSize, 0);
+        cmac.finish(reinterpret_cast<quint8 *>(tag.data()));
+        QCOMPARE(tag.left(4).toHex(), QByteArray("154e7210"));
+    }
+}
+
+void TestCrypto::randomRoundTrip()
+{
+    QRandomGenerator rng(20250611);
+
+    for (int round = 0; round < 64; ++round) {
+        Kuznechik kuz;
+        QVERIFY(kuz.setKey(randomBytes(rng, 32)));
+        const QByteArray block16 = randomBytes(rng, 16);
+        QCOMPARE(kuz.decryptBlock(kuz.encryptBlock(block16)), block16);
+
+        Magma magma;
+        QVERIFY(magma.setKey(randomBytes(rng, 32)));
+        const QByteArray block8 = randomBytes(rng, 8);
+        QCOMPARE(magma.decryptBlock(magma.encryptBlock(block8)), block8);
+    }
+}
+
+// Потоковый CTR против поблочной эталонной реализации на случайных длинах,
+// включая неполный последний блок и перенос счётчика через границу байта
+void TestCrypto::ctrCrossCheck()
+{
+    QRandomGenerator rng(777);
+
+    for (int round = 0; round < 32; ++round) {
+        const QByteArray data = randomBytes(rng, rng.bounded(1, 700));
+
+        Kuznechik kuz;
+        QVERIFY(kuz.setKey(randomBytes(rng, 32)));
+        QByteArray iv16 = randomBytes(rng, 16);
+        iv16[15] = static_cast<char>(0xF0);
+        QCOMPARE(encryptCTR(data, kuz, iv16), referenceCTR(data, kuz, iv16));
+        QCOMPARE(decryptCTR(encryptCTR(data, kuz, iv16), kuz, iv16), data);
+        // Табличное расшифрование блока (L⁻¹π⁻¹) обращает зашифрование
+        QCOMPARE(kuz.decryptBlock(kuz.encryptBlock(iv16)), iv16);
+
+        Magma magma;
+        QVERIFY(magma.setKey(randomBytes(rng, 32)));
+        QByteArray iv8 = randomBytes(rng, 8);
+        iv8[7] = static_cast<char>(0xF0);
+        QCOMPARE(encryptCTR(data, magma, iv8), referenceCTR(data, magma, iv8));
+        QCOMPARE(decryptCTR(encryptCTR(data, magma, iv8), magma, iv8), data);
+
+        // Пакетный applyCTR по частям с любой границы блока; счётчик
+        // с переносом через границу машинного слова
+        QByteArray iv16Carry = iv16;
+        iv16Carry.replace(8, 8, QByteArray(8, char(0xFF)));
+        const int split = rng.bounded(data.size() / 16 + 1) * 16;
+        QByteArray parts = data;
+        applyCTR(kuz.schedule(), iv16Carry, 0, parts.data(), split);
+        applyCTR(kuz.schedule(), iv16Carry, quint64(split / 16), parts.data() + split, parts.size() - split);
+        QCOMPARE(parts, referenceCTR(data, kuz, iv16Carry));
+
+        parts = data;
+        applyCTR(magma.schedule(), iv8, 0, parts.data(), parts.size());
+        QCOMPARE(parts, referenceCTR(data, magma, iv8));
+    }
+}
+
+// Один развёрнутый ключ читают несколько потоков без синхронизации
+void TestCrypto::sharedKeySchedule()
+{
+    const KuznechikKey kuz(kuzKey);
+    const MagmaKey magma(magmaKey);
+    QVERIFY(kuz.isValid());
+    QVERIFY(magma.isValid());
+    QVERIFY(!KuznechikKey(QByteArray(31, 0)).isValid());
+    QVERIFY(!MagmaKey().isValid());
+    QCOMPARE(reinterpret_cast<quintptr>(&kuz) % 64, quintptr(0));
+
+    // ГОСТ Р 34.13-2015, п. А.1.2 и А.2.2
+    const QByteArray kuzIv = QByteArray::fromHex("1234567890abcef0") + QByteArray(8, 0);
+    const QByteArray magmaIv = QByteArray::fromHex("12345678") + QByteArray(4, 0);
+    const QByteArray kuzExpected = QByteArray::fromHex(
+        "f195d8bec10ed1dbd57b5fa240bda1b885eee733f6a13e5df33ce4b33c45dee4"
+        "a5eae88be6356ed3d5e877f13564a3a5cb91fab1f20cbab6d1c6d15820bdba73");
+    const QByteArray magmaExpected = QByteArray::fromHex(
+        "4e98110c97b7b93c3e250d93d6e85d69136d868807b2dbef568eb680ab52a12d");
+
+    std::vector<QByteArray> kuzResults(4), magmaResults(4);
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < kuzResults.size(); ++i) {
+        workers.emplace_back([&, i] {
+            for (int round = 0; round < 100; ++round) {
+                kuzResults[i] = kuzPlain;
+                applyCTR(kuz, kuzIv, 0, kuzResults[i].data(), kuzResults[i].size());
+                magmaResults[i] = magmaPlain;
+                applyCTR(magma, magmaIv, 0, magmaResults[i].data(), magmaResults[i].size());
+            }
+        });
+    }
+    for (std::thread &worker : workers)
+        worker.join();
+    for (size_t i = 0; i < kuzResults.size(); ++i) {
+        QCOMPARE(kuzResults[i].toHex(), kuzExpected.toHex());
+        QCOMPARE(magmaResults[i].toHex(), magmaExpected.toHex());
+    }
+}
+
+// Каждое ядро, доступное на этом процессоре, против эталонного ("ref")
+// и против векторов стандарта
+void TestCrypto::kernelsAgree_data()
+{
+    QTest::addColumn<int>("primitive");
+    QTest::addColumn<QString>("kernel");
+
+    for (int p = 0; p < Dispatch::PrimitiveCount; ++p) {
+        const Dispatch::Primitive primitive = Dispatch::Primitive(p);
+        const QStringList kernels = Dispatch::available(primitive);
+        for (const QString &kernel : kernels) {
+            const QString name = Dispatch::primitiveName(primitive) + "/" + kernel;
+            QTest::newRow(name.toUtf8().constData()) << p << kernel;
+        }
+    }
+}
+
+void TestCrypto::kernelsAgree()
+{
+    QFETCH(int, primitive);
+    QFETCH(QString, kernel);
+
+    const Dispatch::Primitive p = Dispatch::Primitive(primitive);
+    const QString original = Dispatch::selected(p);
+    QRandomGenerator rng(4242);
+
+    // Объекты запоминают ядро при создании
+    QVERIFY(Dispatch::select(p, QStringLiteral("ref")));
+    Kuznechik refKuz;
+    Magma refMagma;
+    QVERIFY(Dispatch::select(p, kernel));
+    Kuznechik kuz;
+    Magma magma;
+
+    switch (p) {
+    case Dispatch::KuznechikEncrypt:
+        QVERIFY(kuz.setKey(kuzKey));
+        QCOMPARE(kuz.encryptBlock(QByteArray::fromHex("1122334455667700ffeeddccbbaa9988")).toHex(),
+                 QByteArray("7f679d90bebc24305a468d42b9d4edcd"));
+        for (int i = 0; i < 256; ++i) {
+            const QByteArray key = randomBytes(rng, 32);
+            const QByteArray block = randomBytes(rng, 16);
+            QVERIFY(kuz.setKey(key) && refKuz.setKey(key));
+            QCOMPARE(kuz.encryptBlock(block), refKuz.encryptBlock(block));
+        }
+        break;
+    case Dispatch::MagmaEncrypt:
+        QVERIFY(magma.setKey(magmaKey));
+        QCOMPARE(magma.encryptBlock(QByteArray::fromHex("fedcba9876543210")).toHex(),
+                 QByteArray("4ee901e5c2d8ca3d"));
+        for (int i = 0; i < 256; ++i) {
+            const QByteArray key = randomBytes(rng, 32);
+            const QByteArray block = randomBytes(rng, 8);
+            QVERIFY(magma.setKey(key) && refMagma.setKey(key));
+            QCOMPARE(magma.encryptBlock(block), refMagma.encryptBlock(block));
+        }
+        break;
+    case Dispatch::StreebogLps:
+        QCOMPARE(streebog(QByteArray::fromHex(
+                              "323130393837363534333231303938373635343332313039383736353433323130"
+                              "393837363534333231303938373635343332313039383736353433323130"), 256).toHex(),
+                 QByteArray("00557be5e584fd52a449b16b0251d05d27f94ab76cbaa6da890b59d8ef1e159d"));
+        for (int i = 0; i < 16; ++i) {
+            const QByteArray message = randomBytes(rng, rng.bounded(0, 300));
+            QVERIFY(Dispatch::select(p, QStringLiteral("ref")));
+            const QByteArray expected = streebog(message, 512);
+            QVERIFY(Dispatch::select(p, kernel));
+            QCOMPARE(streebog(message, 512), expected);
+        }
+        break;
+    case Dispatch::Gf128Sum:
+    case Dispatch::Gf64Sum: {
+        const int n = p == Dispatch::Gf128Sum ? 16 : 8;
+        QVERIFY(Dispatch::select(p, QStringLiteral("ref")));
+        const Dispatch::GfSumFn ref = p == Dispatch::Gf128Sum ? Dispatch::gf128Sum() : Dispatch::gf64Sum();
+        QVERIFY(Dispatch::select(p, kernel));
+        const Dispatch::GfSumFn sum = p == Dispatch::Gf128Sum ? Dispatch::gf128Sum() : Dispatch::gf64Sum();
+        // 1 ⊗ x = x; все единицы — наибольшие переносы при приведении
+        QByteArray one(n, 0), ones(n, char(0xff)), acc(n, 0);
+        one[n - 1] = 1;
+        sum(reinterpret_cast<const quint8 *>(one.constData()), reinterpret_cast<const quint8 *>(ones.constData()), 1,
+            reinterpret_cast<quint8 *>(acc.data()));
+        QCOMPARE(acc, ones);
+        for (int i = 0; i < 256; ++i) {
+            const int blocks = rng.bounded(1, 9);
+            const QByteArray h = i == 0 ? QByteArray(blocks * n, char(0xff)) : randomBytes(rng, blocks * n);
+            const QByteArray x = i == 0 ? QByteArray(blocks * n, char(0xff)) : randomBytes(rng, blocks * n);
+            QByteArray expected = randomBytes(rng, n);
+            QByteArray got = expected;
+            ref(reinterpret_cast<const quint8 *>(h.constData()), reinterpret_cast<const quint8 *>(x.constData()), blocks,
+                reinterpret_cast<quint8 *>(expected.data()));
+            sum(reinterpret_cast<const quint8 *>(h.constData()), reinterpret_cast<const quint8 *>(x.constData()), blocks,
+                reinterpret_cast<quint8 *>(got.data()));
+            QCOMPARE(got.toHex(), expected.toHex());
+        }
+        break;
+    }
+    default:
+        QFAIL("Неизвестный примитив");
+    }
+
+    QVERIFY(Dispatch::select(p, original));
+}
+
+void TestCrypto::secureRandom_data()
+{
+    QTest::addColumn<int>("generator");
+    QTest::newRow("system") << int(SecureRandom::Generator::System);
+    QTest::newRow("kuznechik-drbg") << int(SecureRandom::Generator::KuznechikDrbg);
+}
+
+// Статистику здесь не проверить; проверяется, что запросы любой длины,
+// в том числе через границы буфера и частей DRBG, не повторяют друг друга
+void TestCrypto::secureRandom()
+{
+    QFETCH(int, generator);
+    const SecureRandom::Generator previous = SecureRandom::generator();
+    SecureRandom::setGenerator(SecureRandom::Generator(generator));
+
+    QSet<QByteArray> seen;
+    for (int length : { 1, 16, 32, SecureRandom::BufferSize - 1, SecureRandom::MaxDrbgRequest + 5 }) {
+        for (int round = 0; round < 4; ++round) {
+            const QByteArray data = SecureRandom::bytes(length);
+            QCOMPARE(data.size(), length);
+            if (length >= 16) {
+                QVERIFY(!seen.contains(data));
+                seen.insert(data);
+                // Длинный запрос не заполнен нулями и не повторяет свою начальную часть
+                QVERIFY(data.count('\0') < length / 2);
+                QVERIFY(data.left(16) != data.mid(length - 16));
+            }
+        }
+    }
+
+    quint32 value = 0;
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(SecureRandom::bounded(7, &value));
+        QVERIFY(value < 7);
+    }
+
+    SecureRandom::Generator parsed;
+    QVERIFY(SecureRandom::generatorFromName(SecureRandom::generatorName(SecureRandom::Generator(generator)), &parsed));
+    QCOMPARE(int(parsed), generator);
+    QVERIFY(!SecureRandom::generatorFromName(QStringLiteral("rand"), &parsed));
+    SecureRandom::setGenerator(previous);
+}
+
+// Имитовставка фрагмента в 1 МиБ: HMAC-Стрибог против CMAC на шифрах
+// контейнера (скорость — в выводе -tickcounter / -callgrind)
+void TestCrypto::macThroughput_data()
+{
+    QTest::addColumn<QString>("mac");
+    QTest::newRow("hmac-streebog") << QStringLiteral("hmac");
+    QTest::newRow("cmac-kuznechik") << QStringLiteral("kuznechik");
+    QTest::newRow("cmac-magma") << QStringLiteral("magma");
+}
+
+void TestCrypto::macThroughput()
+{
+    QFETCH(QString, mac);
+    QRandomGenerator rng(20251019);
+    const QByteArray data = randomBytes(rng, 1 << 20);
+    const KuznechikKey kuz(kuzKey);
+    const MagmaKey magma(magmaKey);
+    QByteArray tag;
+
+    QBENCHMARK {
+        if (mac == QLatin1String("hmac")) {
+            tag = hmacStreebog(data, kuzKey);
+        } else if (mac == QLatin1String("kuznechik")) {
+            Cmac<KuznechikKey> cmac(kuz);
+            cmac.update(data.constData(), data.size());
+            tag = QByteArray(Cmac<KuznechikKey>::TagSize, 0);
+            cmac.finish(reinterpret_cast<quint8 *>(tag.data()));
+        } else {
+            Cmac<MagmaKey> cmac(magma);
+            cmac.update(data.constData(), data.size());
+            tag = QByteArray(Cmac<MagmaKey>::TagSize, 0);
+            cmac.finish(reinterpret_cast<quint8 *>(tag.data()));
+        }
+    }
+    QVERIFY(!tag.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(TestCrypto)
+#include "tst_crypto.moc"
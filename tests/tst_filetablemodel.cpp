@@ -0,0 +1,207 @@
+/*
+ * Diplom — шифрование файлов по ГОСТ с использованием Кузнечика и Магмы
+ * Copyright (C) 2025 Олег Усольцев <jeep2036@mail.ru>
+ *
+ * Этот программный обеспечением распространяется на условиях
+ * GNU General Public License версии 3 или более поздней.
+ * Подробнее: https://www.gnu.org/licenses/gpl-3.0
+ */
+// tests/tst_filetablemodel.cpp — модель таблицы файлов и индекс путей
+#include <QtTest>
+
+#include "filetablemodel.h"
+#include "statusrefresher.h"
+#include "directorywatcher.h"
+
+class TestFileTableModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pathsRoundTrip();
+    void numbersFollowRows();
+    void removeKeepsIndex_data();
+    void removeKeepsIndex();
+    void setPathMovesIndex();
+    void refreshUsesListing();
+    void rowsByDirectory();
+    void watcherReportsChanges();
+};
+
+void TestFileTableModel::pathsRoundTrip()
+{
+    FileTableModel model;
+    const QStringList paths = {
+        QStringLiteral("/home/user/документы/отчёт.docx"),
+        QStringLiteral("/home/user/документы/план.txt"),
+        QStringLiteral("/file-in-root"),
+        QStringLiteral("/tmp/a/./b/../c.txt"),
+    };
+    for (const QString &path : paths)
+        model.addPath(path, false);
+
+    QCOMPARE(model.rowCount(), paths.size());
+    QCOMPARE(model.path(0), paths[0]);
+    QCOMPARE(model.path(1), paths[1]);
+    QCOMPARE(model.path(2), paths[2]);
+    QCOMPARE(model.path(3), QStringLiteral("/tmp/a/c.txt"));
+    QCOMPARE(model.rowForPath(QStringLiteral("/tmp/a/c.txt")), 3);
+    QCOMPARE(model.rowForPath(QStringLiteral("/tmp/a/b/../c.txt")), 3);
+    QCOMPARE(model.rowForPath(QStringLiteral("/нет/такого")), -1);
+}
+
+void TestFileTableModel::numbersFollowRows()
+{
+    FileTableModel model;
+    for (int i = 0; i < 5; ++i)
+        model.addPath(QStringLiteral("/d/f%1").arg(i), false);
+    model.removeRowsAt({ 1, 3 });
+
+    QCOMPARE(model.rowCount(), 3);
+    for (int row = 0; row < model.rowCount(); ++row)
+        QCOMPARE(model.index(row, FileTableModel::NumberColumn).data().toInt(), row + 1);
+    QCOMPARE(model.index(2, FileTableModel::PathColumn).data().toString(), QStringLiteral("/d/f4"));
+}
+
+void TestFileTableModel::removeKeepsIndex_data()
+{
+    QTest::addColumn<int>("step");
+    // Шаг 2 даёт сотни разрозненных диапазонов — удаление через сброс модели
+    QTest::newRow("ranges") << 100;
+    QTest::newRow("reset") << 2;
+}
+
+void TestFileTableModel::removeKeepsIndex()
+{
+    QFETCH(int, step);
+    FileTableModel model;
+    const int count = 1000;
+    for (int i = 0; i < count; ++i)
+        model.addPath(QStringLiteral("/dir%1/file%2").arg(i % 7).arg(i), i % 10 == 0);
+    model.setState(5, FileTableModel::Encrypted, FileTableModel::Magma);
+
+    QList<int> removed;
+    for (int i = 0; i < count; i += step)
+        removed << i;
+    model.removeRowsAt(removed);
+    QCOMPARE(model.rowCount(), count - removed.size());
+
+    for (int i = 0; i < count; ++i) {
+        const QString path = QStringLiteral("/dir%1/file%2").arg(i % 7).arg(i);
+        const int row = model.rowForPath(path);
+        if (i % step == 0) {
+            QCOMPARE(row, -1);
+            continue;
+        }
+        QVERIFY(row >= 0);
+        QCOMPARE(model.path(row), path);
+        QCOMPARE(model.isDir(row), i % 10 == 0);
+    }
+    const int row = model.rowForPath(QStringLiteral("/dir5/file5"));
+    QCOMPARE(model.status(row), FileTableModel::Encrypted);
+    QCOMPARE(model.method(row), FileTableModel::Magma);
+}
+
+void TestFileTableModel::setPathMovesIndex()
+{
+    FileTableModel model;
+    model.addPath(QStringLiteral("/d/a.txt"), false);
+    model.addPath(QStringLiteral("/d/b.txt"), false);
+    model.setPath(1, QStringLiteral("/d/b.txt.kuz"));
+
+    QCOMPARE(model.rowForPath(QStringLiteral("/d/b.txt")), -1);
+    QCOMPARE(model.rowForPath(QStringLiteral("/d/b.txt.kuz")), 1);
+    QCOMPARE(model.rowForPath(QStringLiteral("/d/a.txt")), 0);
+
+    model.clear();
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.rowForPath(QStringLiteral("/d/a.txt")), -1);
+}
+
+void TestFileTableModel::refreshUsesListing()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString dir = QDir(tmp.path()).canonicalPath();
+    for (const char *name : { "a.txt", "b.txt", "b.txt.kuz", "c.txt.mag", "d.txt.kuz", "e.enc", "h.txt", "h.kuz" }) {
+        QFile file(dir + '/' + QLatin1String(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    const QVector<StatusRefresher::Entry> entries = {
+        { 0, dir + "/a.txt" },
+        { 1, dir + "/b.txt" },
+        { 2, dir + "/c.txt.mag" },
+        { 3, dir + "/d.txt" },      // пропал, есть шифрованная копия
+        { 4, dir + "/e.txt" },
+        { 5, dir + "/f.txt" },
+        { 6, dir + "/нет/g.txt" },  // каталога нет
+        { 7, dir + "/h.txt" },      // «h.kuz» — контейнер другого файла, «h»
+    };
+    QVector<StatusRefresher::Result> results = StatusRefresher::resolve(entries, 4);
+    QCOMPARE(results.size(), entries.size());
+    std::sort(results.begin(), results.end(),
+              [](const StatusRefresher::Result &a, const StatusRefresher::Result &b) { return a.row < b.row; });
+
+    QCOMPARE(results[0].status, FileTableModel::Current);
+    QCOMPARE(results[1].status, FileTableModel::Decrypted);
+    QCOMPARE(results[1].method, FileTableModel::Kuznechik);
+    QCOMPARE(results[2].status, FileTableModel::Encrypted);
+    QCOMPARE(results[2].method, FileTableModel::Magma);
+    QVERIFY(results[2].path.isEmpty());
+    QCOMPARE(results[3].path, dir + "/d.txt.kuz");
+    QCOMPARE(results[3].status, FileTableModel::Encrypted);
+    QCOMPARE(results[4].method, FileTableModel::UnknownMethod);
+    QCOMPARE(results[5].status, FileTableModel::Missing);
+    QCOMPARE(results[6].status, FileTableModel::Missing);
+    QCOMPARE(results[6].source, entries[6].path);
+    QCOMPARE(results[7].status, FileTableModel::Current);
+}
+
+void TestFileTableModel::rowsByDirectory()
+{
+    FileTableModel model;
+    model.addPath(QStringLiteral("/a/1"), false);
+    model.addPath(QStringLiteral("/b/2"), false);
+    model.addPath(QStringLiteral("/a/3"), false);
+    model.addPath(QStringLiteral("/root-file"), false);
+    model.addPath(QStringLiteral("/c/4"), false);
+
+    QCOMPARE(model.directories(), QStringList({ "/a", "/b", "/", "/c" }));
+    QCOMPARE(model.rowsInDirectories({ "/a" }), QVector<int>({ 0, 2 }));
+    QCOMPARE(model.rowsInDirectories({ "/", "/c", "/нет" }), QVector<int>({ 3, 4 }));
+
+    // Каталог остаётся в пуле, но строк в нём больше нет
+    model.removeRowsAt({ 1 });
+    QCOMPARE(model.directories(), QStringList({ "/a", "/", "/c" }));
+    QVERIFY(model.rowsInDirectories({ "/b" }).isEmpty());
+}
+
+void TestFileTableModel::watcherReportsChanges()
+{
+    QTemporaryDir tmp;
+    QVERIFY(tmp.isValid());
+    const QString dir = QDir(tmp.path()).canonicalPath();
+
+    DirectoryWatcher watcher;
+    watcher.setCoalesceInterval(50);
+    watcher.setDirectories({ dir });
+    QCOMPARE(watcher.directories(), QStringList({ dir }));
+
+    QSignalSpy spy(&watcher, &DirectoryWatcher::directoriesChanged);
+    for (int i = 0; i < 3; ++i) {
+        QFile file(dir + QStringLiteral("/f%1").arg(i));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+    QVERIFY(QFile::rename(dir + "/f0", dir + "/f0.kuz"));
+
+    // Несколько событий — один сигнал с каталогом
+    QVERIFY(spy.wait(5000));
+    QCOMPARE(spy.first().first().toStringList(), QStringList({ dir }));
+
+    watcher.setDirectories({});
+    QVERIFY(watcher.directories().isEmpty());
+}
+
+QTEST_MAIN(TestFileTableModel)
+#include "tst_filetablemodel.moc"